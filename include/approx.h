@@ -0,0 +1,172 @@
+#pragma once
+#include <arm_neon.h>
+
+#include "matrix.h"
+
+// This file contains LUT-free approximations of the functions that are otherwise taken from LUTs (see lut.h).
+// They are computed with a few multiply-adds per vector instead of four scalar loads, so they don't need a
+// gather, and they don't occupy the L1 cache the tables would. Maximum absolute errors (measured over the float
+// range, against double precision):
+//   tanh     3.3e-7		rational (odd 13/6), clamped at |x| = 7.905 where tanh rounds to +-1
+//   sigmoid  2.3e-7		0.5 + 0.5*tanh(x/2)
+//   sqrt     1.5e-7 * sqrt(x)	reciprocal square root estimate with two Newton-Raphson steps
+//   atan     1.5e-7		polynomial of degree 17 on [-1, 1], atan(x) = +-pi/2 - atan(1/x) outside
+//   sin/cos  1.7e-7		polynomials of degree 11/12 on [-pi/2, pi/2], for |x| < 1e4
+// Divisions are done with a reciprocal estimate and two Newton-Raphson steps, which are pipelined on the A53.
+
+// Approximation constants
+#define APPROX_TANH_CLAMP	7.90531110763549805f
+#define APPROX_PI_2			1.57079632679489661923f
+#define APPROX_1_PI			0.318309886183790671538f
+// pi split into three parts so that x - k*pi is exact for the first two (Cody-Waite)
+#define APPROX_PI_A			3.140625f
+#define APPROX_PI_B			9.67502593994140625e-4f
+#define APPROX_PI_C			1.509957990978376432e-7f
+
+static const float32_t approx_tanh_p[] = { -2.76076847742355e-16f, 2.00018790482477e-13f, -8.60467152213735e-11f,
+	5.12229709037114e-08f, 1.48572235717979e-05f, 6.37261928875436e-04f, 4.89352455891786e-03f };
+static const float32_t approx_tanh_q[] = { 1.19825839466702e-06f, 1.18534705686654e-04f, 2.26843463243900e-03f, 4.89352518554385e-03f };
+static const float32_t approx_atan_p[] = { 0.00282363896258175373f, -0.0159569028764963150f, 0.0425049886107444763f,
+	-0.0748900920152664184f, 0.106347933411598205f, -0.142027363181114196f, 0.199926957488059997f, -0.333331018686294555f };
+static const float32_t approx_sin_p[] = { 1.6059043836821614599e-10f, -2.5052108385441718775e-8f, 2.7557319223985890653e-6f,
+	-1.9841269841269841270e-4f, 8.3333333333333333333e-3f, -1.6666666666666666667e-1f };
+static const float32_t approx_cos_p[] = { -1.1470745597729724714e-11f, 2.0876756987868098979e-9f, -2.7557319223985890653e-7f,
+	2.4801587301587301587e-5f, -1.3888888888888888889e-3f, 4.1666666666666666667e-2f, -0.5f };
+
+// Vector versions, for 4 values already held in a register; used by fused kernels - - - - - - - - - - - - - - -
+
+// Horner's scheme over `n` coefficients, highest degree first
+static inline float32x4_t vpolyApproxq_f32(float32x4_t vx, const float32_t *coef, uint8_t n) {
+	float32x4_t vp = vld1q_dup_f32(&coef[0]);
+	for(uint8_t i = 1; i < n; i++) { vp = vfmaq_f32(vld1q_dup_f32(&coef[i]), vp, vx); }
+	return vp;
+}
+
+// 1/x
+static inline float32x4_t vrecipApproxq_f32(float32x4_t vx) {
+	float32x4_t vr = vrecpeq_f32(vx);
+	vr = vmulq_f32(vr, vrecpsq_f32(vx, vr));
+	return vmulq_f32(vr, vrecpsq_f32(vx, vr));
+}
+
+static inline float32x4_t vtanhApproxq_f32(float32x4_t vx) {
+	vx = vminq_f32(vmaxq_f32(vx, vdupq_n_f32(-APPROX_TANH_CLAMP)), vdupq_n_f32(APPROX_TANH_CLAMP));
+	float32x4_t vx2 = vmulq_f32(vx, vx);
+	float32x4_t vp  = vmulq_f32(vpolyApproxq_f32(vx2, approx_tanh_p, 7), vx);
+	return vmulq_f32(vp, vrecipApproxq_f32(vpolyApproxq_f32(vx2, approx_tanh_q, 4)));
+}
+
+static inline float32x4_t vsigmoidApproxq_f32(float32x4_t vx) {
+	float32x4_t vhalf = vdupq_n_f32(0.5f);
+	return vfmaq_f32(vhalf, vhalf, vtanhApproxq_f32(vmulq_f32(vx, vhalf)));
+}
+
+// Expects non-negative input
+static inline float32x4_t vsqrtApproxq_f32(float32x4_t vx) {
+	// sqrt(x) = x * 1/sqrt(x); Zeros are raised to the smallest normal number so that they give 0 instead of 0*inf
+	float32x4_t vnz = vmaxq_f32(vx, vdupq_n_f32(1.17549435e-38f));
+	float32x4_t vr = vrsqrteq_f32(vnz);
+	vr = vmulq_f32(vr, vrsqrtsq_f32(vmulq_f32(vnz, vr), vr));
+	vr = vmulq_f32(vr, vrsqrtsq_f32(vmulq_f32(vnz, vr), vr));
+	return vmulq_f32(vx, vr);
+}
+
+// atan of values within [-1, 1]
+static inline float32x4_t vatanUnitApproxq_f32(float32x4_t vx) {
+	float32x4_t vx2 = vmulq_f32(vx, vx);
+	return vfmaq_f32(vx, vmulq_f32(vx, vx2), vpolyApproxq_f32(vx2, approx_atan_p, 8));
+}
+
+static inline float32x4_t vatanApproxq_f32(float32x4_t vx) {
+	// For |x| > 1, atan(x) = sign(x)*pi/2 - atan(1/x)
+	uint32x4_t vbig = vcagtq_f32(vx, vdupq_n_f32(1.0f));
+	float32x4_t vt = vatanUnitApproxq_f32(vbslq_f32(vbig, vrecipApproxq_f32(vx), vx));
+	uint32x4_t vsign = vandq_u32(vreinterpretq_u32_f32(vx), vdupq_n_u32(0x80000000));
+	float32x4_t vpi_2 = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(APPROX_PI_2)), vsign));
+	return vbslq_f32(vbig, vsubq_f32(vpi_2, vt), vt);
+}
+
+// atan(y/x), like `angleLUT_c`; Calculated from min(|x|,|y|)/max(|x|,|y|) so it is exact at x = 0
+static inline float32x4_t vangleApproxq_f32(float32x4_t vy, float32x4_t vx) {
+	float32x4_t vax = vabsq_f32(vx), vay = vabsq_f32(vy);
+	uint32x4_t vbig = vcgtq_f32(vay, vax);
+	float32x4_t vmax = vmaxq_f32(vmaxq_f32(vax, vay), vdupq_n_f32(1.17549435e-38f));
+	float32x4_t vt = vatanUnitApproxq_f32(vmulq_f32(vminq_f32(vax, vay), vrecipApproxq_f32(vmax)));
+	vt = vbslq_f32(vbig, vsubq_f32(vdupq_n_f32(APPROX_PI_2), vt), vt);
+	// The result has the sign of y/x
+	uint32x4_t vsign = vandq_u32(veorq_u32(vreinterpretq_u32_f32(vx), vreinterpretq_u32_f32(vy)), vdupq_n_u32(0x80000000));
+	return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vt), vsign));
+}
+
+// sin(x) and cos(x) at once
+static inline void vsincosApproxq_f32(float32x4_t vx, float32x4_t *vsin, float32x4_t *vcos) {
+	// x = k*pi + r, |r| <= pi/2; sin and cos change sign for odd k
+	float32x4_t vk = vrndnq_f32(vmulq_f32(vx, vdupq_n_f32(APPROX_1_PI)));
+	float32x4_t vr = vfmsq_f32(vx, vk, vdupq_n_f32(APPROX_PI_A));
+	vr = vfmsq_f32(vr, vk, vdupq_n_f32(APPROX_PI_B));
+	vr = vfmsq_f32(vr, vk, vdupq_n_f32(APPROX_PI_C));
+	uint32x4_t vsign = vshlq_n_u32(vandq_u32(vreinterpretq_u32_s32(vcvtq_s32_f32(vk)), vdupq_n_u32(1)), 31);
+
+	float32x4_t vr2 = vmulq_f32(vr, vr);
+	float32x4_t vs = vfmaq_f32(vr, vmulq_f32(vr, vr2), vpolyApproxq_f32(vr2, approx_sin_p, 6));
+	float32x4_t vc = vfmaq_f32(vdupq_n_f32(1.0f), vr2, vpolyApproxq_f32(vr2, approx_cos_p, 7));
+	*vsin = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vs), vsign));
+	*vcos = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vc), vsign));
+}
+
+// Scalar versions of the above - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static inline float32_t polyApproxScalar(float32_t x, const float32_t *coef, uint8_t n) {
+	float32_t p = coef[0];
+	for(uint8_t i = 1; i < n; i++) { p = p*x + coef[i]; }
+	return p;
+}
+
+static inline float32_t tanhApproxScalar(float32_t x) {
+	x = (x > APPROX_TANH_CLAMP) ? APPROX_TANH_CLAMP : ((x < -APPROX_TANH_CLAMP) ? -APPROX_TANH_CLAMP : x);
+	float32_t x2 = x*x;
+	return polyApproxScalar(x2, approx_tanh_p, 7) * x / polyApproxScalar(x2, approx_tanh_q, 4);
+}
+
+static inline float32_t sigmoidApproxScalar(float32_t x) { return 0.5f + 0.5f*tanhApproxScalar(0.5f*x); }
+
+static inline float32_t atanUnitApproxScalar(float32_t x) {
+	float32_t x2 = x*x;
+	return x + x*x2*polyApproxScalar(x2, approx_atan_p, 8);
+}
+
+static inline float32_t atanApproxScalar(float32_t x) {
+	if(x > 1.0f)  { return APPROX_PI_2 - atanUnitApproxScalar(1.0f/x); }
+	if(x < -1.0f) { return -APPROX_PI_2 - atanUnitApproxScalar(1.0f/x); }
+	return atanUnitApproxScalar(x);
+}
+
+static inline float32_t angleApproxScalar(float32_t y, float32_t x) {
+	float32_t ax = (x < 0) ? -x : x;
+	float32_t ay = (y < 0) ? -y : y;
+	if(ax == 0 && ay == 0) { return 0; }
+	float32_t t = (ay > ax) ? APPROX_PI_2 - atanUnitApproxScalar(ax/ay) : atanUnitApproxScalar(ay/ax);
+	return ((x < 0) != (y < 0)) ? -t : t;
+}
+
+static inline void sincosApproxScalar(float32_t x, float32_t *s, float32_t *c) {
+	float32_t k = (float32_t)(int32_t)(x*APPROX_1_PI + ((x < 0) ? -0.5f : 0.5f));
+	float32_t r = x - k*APPROX_PI_A;
+	r = r - k*APPROX_PI_B;
+	r = r - k*APPROX_PI_C;
+	float32_t r2 = r*r;
+	float32_t sign = ((int32_t)k & 1) ? -1.0f : 1.0f;
+	*s = sign * (r + r*r2*polyApproxScalar(r2, approx_sin_p, 6));
+	*c = sign * (1.0f + r2*polyApproxScalar(r2, approx_cos_p, 7));
+}
+
+// Matrix versions; LUT-free replacements of `clampingLUT` (tanh/sigmoid LUTs), `sqrtLUT`, `angleLUT_c` and
+// `expiLUT`. In-place if the output is NULL, except for the complex ones. - - - - - - - - - - - - - - - - - - -
+void tanhApprox(matrix32f_t *input0, matrix32f_t *output0);
+void sigmoidApprox(matrix32f_t *input0, matrix32f_t *output0);
+// Expects non-negative input
+void sqrtApprox(matrix32f_t *input0, matrix32f_t *output0);
+void atanApprox(matrix32f_t *input0, matrix32f_t *output0);
+// atan(imag/real) of every complex number, like `angleLUT_c`
+void angleApprox_c(matrix32c_t *input0, matrix32f_t *output0);
+// e^xi (cos x + i*sin x) for any real x, like `expiLUT`
+void expiApprox(matrix32f_t *input0, matrix32c_t *output0);
@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "matrix.h"
+#include "lut.h"
+
+// Binary model bundle; A single file holding named matrices and LUTs that is memory-mapped and
+// used in place (zero-copy `matrix32f_t`/`lut32f_t` views) instead of parsing CSV files.
+//
+// Layout (native byte order, i.e. little endian on AArch64):
+//   bundle_header_t                 (64 bytes)
+//   bundle_entry_t[entry_count]     (64 bytes each)
+//   data                            (each entry's floats start at a MATRIX_ALIGNMENT boundary)
+// `checksum` is the CRC-32 of everything after the header.
+
+#define BUNDLE_MAGIC		0x4C444E42	// "BNDL"
+#define BUNDLE_VERSION		1
+#define BUNDLE_NAME_LENGTH	32			// including the terminating NUL
+
+// Entry types
+#define BUNDLE_MATRIX		0
+#define BUNDLE_LUT			1
+
+typedef struct BUNDLE_HEADER_ST {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entry_count;
+	uint32_t checksum;
+	uint64_t size;			// bytes, whole file
+	uint8_t  reserved[40];
+} bundle_header_t;
+
+typedef struct BUNDLE_ENTRY_ST {
+	char name[BUNDLE_NAME_LENGTH];
+	uint32_t type;			// BUNDLE_MATRIX or BUNDLE_LUT
+	uint32_t h, w;			// LUTs are 1 x length, LUT_LINEAR ones 2 x length ((value, slope) pairs)
+	float32_t mult_factor;	// LUTs only
+	float32_t bias;			// LUTs only
+	uint32_t lut_mode;		// LUTs only; LUT_NEAREST or LUT_LINEAR (was reserved, so older bundles are nearest)
+	uint64_t offset;		// bytes from the start of the file
+} bundle_entry_t;
+
+typedef struct BUNDLE_ST {
+	uint8_t *mem;
+	size_t size;
+	bundle_header_t *header;
+	bundle_entry_t *entries;
+	uint8_t mapped;			// 1 if `mem` is memory-mapped, 0 if it was read into memory (bare metal)
+} bundle_t;
+
+// One matrix or LUT to write to a bundle; Exactly one of `mat` and `lut` should be set
+typedef struct BUNDLE_ITEM_ST {
+	const char *name;
+	matrix32f_t *mat;
+	lut32f_t *lut;
+} bundle_item_t;
+
+// Opens a bundle; On Linux the file is memory-mapped (private, copy-on-write) so only the pages that are used
+// are read. If `verify` is set the checksum is checked, which reads the whole file.
+// Returns 0 on success, 30 if the file can't be opened, 35 if it isn't a bundle, 36 on a version mismatch,
+// 37 on a checksum mismatch and 100 if memory can't be allocated/mapped.
+int bundleOpen(const char *path, uint8_t verify, bundle_t *bundle);
+// Unmaps/frees a bundle; All views into it become invalid
+void bundleClose(bundle_t *bundle);
+
+// Points `view` to a matrix of the bundle (zero-copy); `view` must NOT be freed with `deleteMatrix`.
+// Returns non-zero if there's no matrix called `name`.
+int bundleMatrix(bundle_t *bundle, const char *name, matrix32f_t *view);
+// Same for LUTs; `view` must NOT be freed with `deleteLUT32f`
+int bundleLUT(bundle_t *bundle, const char *name, lut32f_t *view);
+
+// Writes `count` matrices/LUTs to a new bundle file; Returns 0 on success, 30 if the file can't be
+// created, 1 on invalid items and 100 if memory can't be allocated.
+int bundleWrite(const char *path, bundle_item_t *items, size_t count);
@@ -8,4 +8,28 @@
 
 #define BUFFERSIZE	(32*1024) // 32KiB
 
+// Threads of `matrixFromCSVParallel`/`matrixFromCSVBatch`
+#define CSV_MAX_THREADS		8
+// Smallest part of a file that `matrixFromCSVParallel` gives to a thread
+#define CSV_MIN_RANGE_BYTES	(64*1024)
+
+// A file for `matrixFromCSVBatch`; `ret` is set to the result of loading it
+typedef struct CSV_JOB_ST {
+	const char *path;
+	size_t h, w;
+	matrix32f_t *mat;
+	int ret;
+} csv_job_t;
+
+// Loads a `height` x `width` matrix from a CSV file (rows separated by '\n' or "\r\n", values by ',');
+// Values are correctly rounded. Returns 0 on success, 1 on invalid dimensions, 2 on an invalid or missing number
+// (e.g. after a trailing ','; its row and column are printed), 30 if the file can't be opened, 80/127 if it holds
+// more/fewer values than expected and 100 if memory can't be allocated.
 int matrixFromCSV(const char *path, size_t height, size_t width, matrix32f_t *mat);
+// Same as `matrixFromCSV`, but the file is read at once, split into `threads` parts at line breaks and the parts
+// are parsed concurrently, straight into the matrix. Uses about as much extra memory as the size of the file.
+// On bare metal (or with threads <= 1) this is `matrixFromCSV`.
+int matrixFromCSVParallel(const char *path, size_t height, size_t width, size_t threads, matrix32f_t *mat);
+// Loads `count` files on `threads` threads; Each file is parsed by a single thread, so this scales as long as
+// there are more files than threads. Returns 0 if all files were loaded, otherwise the `ret` of the first failed job.
+int matrixFromCSVBatch(csv_job_t *jobs, size_t count, size_t threads);
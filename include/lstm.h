@@ -5,11 +5,42 @@
 #include "matrix.h"
 #include "matrix_math.h"
 #include "lut.h"
+#include "approx.h"
+#include "bundle.h"
+
+// Options for `lstmCreate`; can be OR-ed together
+// Packs the four gates' W and U matrices (and biases) into single gate-interleaved matrices when
+// parameters are loaded, so that all gates are calculated by one fused kernel. `hidden_size`
+// must be a multiple of LSTM_PACK_WIDTH.
+#define LSTM_PACKED_WEIGHTS	0x01
+// Quantizes the W and U matrices to 8 bits (per-column scales) when parameters are loaded; Gates are
+// calculated with `multVecByMat_q8`. Can't be combined with LSTM_PACKED_WEIGHTS.
+#define LSTM_QUANTIZED_WEIGHTS	0x02
+// Runs the cell in 16-bit fixed point: parameters are converted when they are loaded and H and C are kept
+// as int16 (`h` is updated from `h_q` after every step). Requires fixed point LUTs (`lstmSetLUTs_q16`).
+// Can't be combined with the options above.
+#define LSTM_FIXED_POINT		0x04
+// Stores the W and U matrices in half precision when parameters are loaded; Gates are calculated with
+// `multVecByMat_f16w` (float accumulation). Can't be combined with the options above.
+#define LSTM_HALF_WEIGHTS		0x08
+
+// Formats (integer bits) of the fixed point mode; the weights' format is chosen from their range when they are loaded
+#define LSTM_Q16_INPUT_INT_BITS	4	// layer 0 inputs
+#define LSTM_Q16_STATE_INT_BITS	3	// H and C
+#define LSTM_Q16_GATE_INT_BITS	4	// gate pre-activations (input of the LUTs)
+
+// Number of consecutive columns of each gate in a packed row:
+// [f0..f3 c0..c3 i0..i3 o0..o3 f4..f7 c4..c7 ...]
+#define LSTM_PACK_WIDTH		4
+
+// Threads that load the parameter files in `lstmLoadParameters`
+#define LSTM_LOAD_THREADS	4
 
 typedef struct lstm_st {
 	size_t 	input_size;
 	size_t 	hidden_size;
 	uint8_t direction;
+	uint8_t options;
 
 	// Cell's Hold and Cell Matrices
 	matrix32f_t h;
@@ -23,6 +54,8 @@ typedef struct lstm_st {
 	// Pointers to sigmoid and tanh LUTs (read-only)
 	lut32f_t *sigmoid_lut_ptr;
 	lut32f_t *tanh_lut_ptr;
+	// Set by `lstmSetApproximations`; sigmoid and tanh are calculated (approx.h) instead of taken from the LUTs
+	uint8_t approx_activations;
 
 	// Weights (for input)
 	matrix32f_t f_w;
@@ -42,6 +75,44 @@ typedef struct lstm_st {
 	matrix32f_t i_bias;
 	matrix32f_t o_bias;
 
+	// Packed parameters (LSTM_PACKED_WEIGHTS); the separate matrices above are freed after packing
+	matrix32f_t w_packed;		// input_size x 4*hidden_size
+	matrix32f_t u_packed;		// hidden_size x 4*hidden_size
+	matrix32f_t bias_packed;	// 1 x 4*hidden_size
+
+	// Set when W, U and biases are views into a bundle (`lstmLoadParametersBundle`); they are never freed
+	uint8_t borrowed_params;
+
+	// Quantized parameters (LSTM_QUANTIZED_WEIGHTS); the float W and U matrices are freed after quantization
+	matrix8q_t f_wq, c_wq, i_wq, o_wq;
+	matrix8q_t f_uq, c_uq, i_uq, o_uq;
+
+	// Half precision parameters (LSTM_HALF_WEIGHTS); the float W and U matrices are freed after conversion
+	matrix16f_t f_wh, c_wh, i_wh, o_wh;
+	matrix16f_t f_uh, c_uh, i_uh, o_uh;
+
+	// Fixed point parameters and state (LSTM_FIXED_POINT); Gate arrays are ordered [f, c, i, o]
+	matrix16q_t w_q16[4];
+	matrix16q_t u_q16[4];
+	matrix16q_t bias_q16[4];
+	matrix16q_t h_q, c_q;
+	matrix16q_t *h_q_in0_ptr;
+	matrix16q_t *h_q_in1_ptr;
+	lut16q_t *sigmoid_lut16_ptr;
+	lut16q_t *tanh_lut16_ptr;
+	matrix16q_t x_q;			// 1 x input_size
+	matrix16q_t gate_q16[4];	// scratchpads
+	matrix16q_t gp_q16;
+
+	// Buffers for `lstm_in_sequence`; allocated by `lstmReserveSequence`
+	size_t seq_capacity;		// frames that fit in the buffers
+	matrix32f_t x_seq;			// T x input_size
+	matrix32f_t xw_seq;			// T x 4*hidden_size
+	matrix32f_t gemm_ws;		// packing workspace of `matrixMultiplyWs`
+
+	// State and scratchpads (c, h, *_scratchpad) live in one aligned block; see `lstmCreate`
+	matrix_arena_t arena;
+
 	// Scratchpad memory
 	matrix32f_t f_scratchpad;
 	matrix32f_t c_scratchpad;
@@ -51,12 +122,30 @@ typedef struct lstm_st {
 
 } lstm_t;
 
-int  lstmCreate(size_t input_size, size_t hidden_size, uint8_t dir, lstm_t *lstm);
+int  lstmCreate(size_t input_size, size_t hidden_size, uint8_t dir, uint8_t options, lstm_t *lstm);
+// Loads W, U and the biases from 12 CSV files (f, c, i, o order), LSTM_LOAD_THREADS files at a time
 int  lstmLoadParameters(const char **param_paths, lstm_t *lstm);
+// Uses the matrices `<prefix>wf`, `<prefix>wc`, `<prefix>wi`, `<prefix>wo`, `<prefix>uf`, ..., `<prefix>fbias`, ...
+// of a bundle as parameters (zero-copy; the bundle must stay open while the cell is used). Weight options that
+// convert the parameters (packed, quantized, ...) make copies as usual.
+int  lstmLoadParametersBundle(bundle_t *bundle, const char *prefix, lstm_t *lstm);
 void lstmSetLUTs(lut32f_t *sigmoid_lut, lut32f_t *tanh_lut, lstm_t *lstm);
+// Uses the LUT-free approximations of approx.h instead of LUTs; Faster for wide gates as there are no scalar
+// look-ups, and no tables occupy the cache. `lstmSetLUTs` switches back to LUTs.
+void lstmSetApproximations(lstm_t *lstm);
+// Fixed point LUTs (LSTM_FIXED_POINT); Inputs should be in LSTM_Q16_GATE_INT_BITS format
+void lstmSetLUTs_q16(lut16q_t *sigmoid_lut, lut16q_t *tanh_lut, lstm_t *lstm);
 void lstmDelete(lstm_t *lstm);
+// Clears the cell's state (H and C)
+void lstmReset(lstm_t *lstm);
 void lstmConnect(lstm_t *lstm0, lstm_t *lstm_in0, lstm_t *lstm_in1);
 
 void lstm_in(matrix32f_t *input, lstm_t *lstm);
+// Reserves the buffers of `lstm_in_sequence` for up to `max_T` frames at a time; Returns 0 on success
+int lstmReserveSequence(size_t max_T, lstm_t *lstm);
+// Runs an input layer LSTM over `T` frames; input * W is calculated for up to `seq_capacity` frames with one matrix
+// multiplication. Never allocates; without `lstmReserveSequence` the frames are processed one by one.
+// `output` (T x hidden_size, or NULL) receives the H calculated for each frame.
+void lstm_in_sequence(matrix32f_t *frames, size_t T, lstm_t *lstm, matrix32f_t *output);
 void lstm_mid(lstm_t *lstm);
 void lstm_out(lstm_t *lstm, matrix32f_t *output);
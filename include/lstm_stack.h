@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef BAREMETAL
+#include <pthread.h>
+#endif
+
+#include "lstm.h"
+
+// Maximum number of worker threads of an `lstm_stack_t`
+#define LSTM_STACK_MAX_THREADS	8
+
+// Executor for a bidirectional stack of LSTM cells (`layers` forward and `layers` backward cells).
+// Cells are statically mapped to a pool of pinned worker threads (cell `c` runs on thread `c % threads`,
+// with cells ordered f0, b0, f1, b1, ...). Every cell advances one timestep at a time as soon as its
+// inputs are available. Layer k+1 at time t needs both Hs of layer k at time t, and b[k] produces time 0
+// last (f[k] produces time T-1 last), so layer k+1 can't start before layer k has finished the whole
+// sequence: layers run one after the other, and only the forward and backward cells of a layer run in
+// parallel, so more than 2 threads don't make a run faster.
+typedef struct lstm_stack_st {
+	size_t layers;
+	size_t threads;
+
+	// Cells, ordered f0, b0, f1, b1, ... (not owned by the stack)
+	lstm_t **cells;
+
+	// Per-cell state; Each cell's H for every timestep of the sequence (T x hidden_size) and
+	// an input buffer for layers > 0 (1 x input_size)
+	matrix32f_t *h_seq;
+	matrix32f_t *in_buf;
+	size_t seq_capacity;
+
+	// Timesteps each cell has completed during the current run
+	size_t *progress;
+
+	// Current run
+	size_t T;
+	matrix32f_t *frames;
+	matrix32f_t *outputs;
+
+	// Timings of the last run (ms); Compute time for each cell, time each thread spent waiting
+	// for its inputs and the total (wall) time of the run
+	float *cell_time_ms;
+	float thread_wait_ms[LSTM_STACK_MAX_THREADS];
+	float run_time_ms;
+
+#ifndef BAREMETAL
+	pthread_t pool[LSTM_STACK_MAX_THREADS];
+	pthread_mutex_t lock;
+	pthread_cond_t progress_cond;	// signaled whenever a cell completes a timestep
+	pthread_cond_t run_cond;		// signaled when a run is started or finished
+	size_t generation;				// incremented for every run
+	size_t threads_done;
+	size_t next_thread;				// index claimed by the next worker that starts
+	uint8_t shutdown;
+#endif
+} lstm_stack_t;
+
+// Creates an executor for `layers` forward (`lstm_f`) and backward (`lstm_b`) cells, running on `threads` worker threads.
+// Cells should be created, configured and have their parameters loaded; they should NOT be connected with `lstmConnect`,
+// the stack passes each cell's inputs itself. Layer 0 cells take the input frames and the cells of layer k > 0
+// take the concatenated Hs of layer k-1 (own direction first). On bare metal the stack always runs on the calling thread.
+int  lstmStackCreate(lstm_t *lstm_f, lstm_t *lstm_b, size_t layers, size_t threads, lstm_stack_t *stack);
+
+// Runs the stack over the `T` frames (1 x input_size each); The Hs of the last layer are written to `outputs[t]`
+// (1 x 2*hidden_size each; forward first). All cells' H and C are reset before the sequence is processed.
+int  lstmStackRun(lstm_stack_t *stack, matrix32f_t *frames, size_t T, matrix32f_t *outputs);
+
+// Stops the worker threads and frees the stack's memory; Cells are not deleted
+void lstmStackDelete(lstm_stack_t *stack);
@@ -3,6 +3,12 @@
 
 // This file contains functionality for Lookup tables as well as functions using Lookup-Tables
 
+// Lookup modes of `lut32f_t`
+#define LUT_NEAREST		0	// `data` holds `length` values; the nearest entry is returned
+#define LUT_LINEAR		1	// `data` holds `length` (value, slope) pairs; inputs between entries are interpolated
+// Marks LUT_LINEAR tables in the length field of .lut files; Files without it are LUT_NEAREST
+#define LUT_LINEAR_FLAG	0x80000000u
+
 typedef struct lookuptable_f32_st {
 	// Number of values within LUT
 	uint32_t length;
@@ -13,26 +19,118 @@ typedef struct lookuptable_f32_st {
 	float32_t bias;
 
 	float32_t *data;
+
+	// LUT_NEAREST or LUT_LINEAR; Linear tables reach the same accuracy with far fewer entries, so they fit in L1
+	uint8_t mode;
 } lut32f_t;
 
+// Number of floats in `data`
+static inline size_t lutFloats(lut32f_t *lut) { return (size_t)lut->length * ((lut->mode == LUT_LINEAR) ? 2 : 1); }
+
+// Fixed point LUT for Q-format inputs (see `matrix16q_t`). It has 2^index_bits entries that cover the
+// whole range of its input format and is indexed directly with the upper `index_bits` bits of the
+// (offset) integer value, so no scaling or clamping is required.
+typedef struct lookuptable_q16_st {
+	uint8_t index_bits;
+	// Formats of the inputs and outputs
+	uint8_t in_int_bits;
+	uint8_t out_int_bits;
+
+	int16_t *data;
+} lut16q_t;
+
 // Loads an lut32f_t object into `lut` from the file in `path`
 uint8_t load32fLUT(lut32f_t *lut, const char *path);
+// Writes `lut` to a file that `load32fLUT` can read; Returns 30 if the file can't be written
+uint8_t save32fLUT(lut32f_t *lut, const char *path);
+
+// Builds a LUT_NEAREST or LUT_LINEAR table of `fn` in memory, with `length` entries sampled evenly over [min, max]
+// (first and last entries at min and max). `clampingLUT` clamps inputs outside that range. `sqrtLUT` ignores the
+// bias, so sqrt tables should start at min = 0. Returns non-zero on failure.
+// e.g. `lutGenerate(&lut, tanhf, -8, 8, 65537, LUT_NEAREST)`; sqrtf, atanf, sinf and cosf of <math.h> can be used too
+uint8_t lutGenerate(lut32f_t *lut, float32_t (*fn)(float32_t), float32_t min, float32_t max, uint32_t length, uint8_t mode);
+// Logistic sigmoid, 1/(1 + e^-x); For `lutGenerate`
+float32_t lutSigmoid(float32_t x);
+
+// Creates a compact LUT_LINEAR table from a LUT_NEAREST one; Keeps every `step`-th entry, with step the largest
+// power of 2 for which interpolating between the kept entries reproduces every entry of `lut` within `max_error`.
+// The input range and clamping are unchanged. Returns non-zero on failure.
+uint8_t lutToLinear(lut32f_t *lut, float32_t max_error, lut32f_t *out);
 
 void deleteLUT32f(lut32f_t *lut);
 
+// Creates a fixed point LUT by sampling `lut` at the centre of every index's input range; Returns non-zero on failure
+uint8_t lutTo16q(lut32f_t *lut, uint8_t in_int_bits, uint8_t out_int_bits, uint8_t index_bits, lut16q_t *out);
+void deleteLUT16q(lut16q_t *lut);
+
 
 // Applies LUT to input with values exceeding LUT's borders clamped to the first/last LUT values.
-// Used for tanh, sigmoid activation, etc
+// Used for tanh, sigmoid activation, etc; Supports both lookup modes
 void clampingLUT(matrix32f_t *input0, lut32f_t *lut, matrix32f_t *output0);
 
+// Fixed point version of `clampingLUT`; The input's format should match the LUT's and the output's format is
+// set to the LUT's output format. Out-of-range inputs are already saturated by the input format.
+void clampingLUT_q16(matrix16q_t *input0, lut16q_t *lut, matrix16q_t *output0);
+
+// Linear interpolation of 4 values, see `vclampingLUTq_f32`
+static inline float32x4_t vlinearLUTq_f32(float32x4_t vin, lut32f_t *lut) {
+	float32_t last_lut_pos = (float32_t)(lut->length - 1);
+
+	// Position within the table, clamped to [0, length-1]; The last entry's slope is 0
+	vin = vmlaq_f32(vld1q_dup_f32(&lut->bias), vld1q_dup_f32(&lut->mult_factor), vin);
+	vin = vminq_f32(vmaxq_f32(vin, vld1q_dup_f32(&fzero)), vld1q_dup_f32(&last_lut_pos));
+	uint32x4_t vidx = vcvtq_u32_f32(vin);
+	float32x4_t vfrac = vsubq_f32(vin, vcvtq_f32_u32(vidx));
+
+	// One 64-bit load per lane gets a (value, slope) pair
+	float32x4_t vpairs01 = vcombine_f32(vld1_f32(&lut->data[2*vgetq_lane_u32(vidx, 0)]), vld1_f32(&lut->data[2*vgetq_lane_u32(vidx, 1)]));
+	float32x4_t vpairs23 = vcombine_f32(vld1_f32(&lut->data[2*vgetq_lane_u32(vidx, 2)]), vld1_f32(&lut->data[2*vgetq_lane_u32(vidx, 3)]));
+	return vmlaq_f32(vuzp1q_f32(vpairs01, vpairs23), vuzp2q_f32(vpairs01, vpairs23), vfrac);
+}
+
+// Vector version of `clampingLUT` for 4 values already held in a register; used by fused kernels
+static inline float32x4_t vclampingLUTq_f32(float32x4_t vin, lut32f_t *lut) {
+	if(lut->mode == LUT_LINEAR) { return vlinearLUTq_f32(vin, lut); }
+	uint32_t last_lut_idx = lut->length - 1;
+	float32_t lut_out[4];
+
+	// Same steps as `clampingLUT`: normalize and bias, trim negatives, convert and trim to the LUT's length
+	vin = vmlaq_f32(vld1q_dup_f32(&lut->bias), vld1q_dup_f32(&lut->mult_factor), vin);
+	vin = vmaxq_f32(vin, vld1q_dup_f32(&fzero));
+	uint32x4_t vuint = vminq_u32(vcvtnq_u32_f32(vin), vld1q_dup_u32(&last_lut_idx));
+
+	// There is no gather instruction; look-ups are scalar
+	lut_out[0] = lut->data[ vgetq_lane_u32(vuint, 0) ];
+	lut_out[1] = lut->data[ vgetq_lane_u32(vuint, 1) ];
+	lut_out[2] = lut->data[ vgetq_lane_u32(vuint, 2) ];
+	lut_out[3] = lut->data[ vgetq_lane_u32(vuint, 3) ];
+	return vld1q_f32(lut_out);
+}
+
+// Scalar version of the above
+static inline float32_t clampingLUTScalar(float32_t in, lut32f_t *lut) {
+	float32_t ftemp = in * lut->mult_factor + lut->bias;
+	ftemp = (ftemp < 0.0) ? 0.0 : ftemp;
+
+	if(lut->mode == LUT_LINEAR) {
+		ftemp = (ftemp > lut->length - 1) ? lut->length - 1 : ftemp;
+		uint32_t idx = (uint32_t)ftemp;
+		return lut->data[2*idx] + lut->data[2*idx + 1] * (ftemp - idx);
+	}
+
+	uint32_t utemp = (uint32_t)ftemp;
+	utemp = (utemp >= lut->length) ? lut->length - 1 : utemp;
+	return lut->data[utemp];
+}
+
 
 // LUT function for square root.
-// Expects non-negative input, <200e3.
+// Expects non-negative input, <200e3. LUT_LINEAR tables are applied by `clampingLUT`.
 void sqrtLUT(matrix32f_t *input0, lut32f_t *lut, matrix32f_t *output0);
 
-// Calculates the angle of a complex number using an atan lut
+// Calculates the angle of a complex number using an atan lut; Supports both lookup modes
 void angleLUT_c(matrix32c_t *input0, lut32f_t *lut, matrix32f_t *output0);
 
 // For a real number `x`, calculates e^xi. (real input, imag. output)
-// Utilizes a sine lut both for sine and cosine
+// Utilizes a sine lut both for sine and cosine; LUT_LINEAR tables are clamped to their range, LUT_NEAREST ones aren't
 void expiLUT(matrix32f_t *input0, lut32f_t *sinlut, lut32f_t *coslut, matrix32c_t *output0);
@@ -77,10 +77,76 @@ typedef struct MATRIX32C_ST {
     float complex *d;
 } matrix32c_t;
 
-// Creates a new matrix object and allocates memory for it; 
+// 8-bit quantized matrix with one scale per column (output channel of a vector by matrix
+// multiplication); element (i, j) is approximately d(i, j) * scale[j].
+// With the ARMv8.2 dot product extension the rows are interleaved in groups of 4, so that the 4 values of
+// a column are contiguous ([h/4][w][4], `h` padded to a multiple of 4 with zeros) and can be read by SDOT.
+// Otherwise `d` is stored row-major like matrix32f_t.
+typedef struct MATRIX8Q_ST {
+    size_t h; // number of rows
+    size_t w; // number of columns
+    int8_t *d;
+    float32_t *scale; // w scales
+} matrix8q_t;
+
+#if !defined(SERIAL) && defined(__ARM_FEATURE_DOTPROD)
+#define MATRIX8Q_DOT_LAYOUT
+#endif
+
+// 16-bit fixed point matrix; every element is a signed Q(int_bits).(15-int_bits) number,
+// i.e. its value is d * quant_div_factor[int_bits]
+typedef struct MATRIX16Q_ST {
+    size_t h; // number of rows
+    size_t w; // number of columns
+    int16_t *d;
+    uint8_t int_bits;
+} matrix16q_t;
+
+// Half precision matrix (IEEE fp16 storage); Used for weights that are widened to float32_t while they are read
+typedef struct MATRIX16F_ST {
+    size_t h; // number of rows
+    size_t w; // number of columns
+    float16_t *d;
+} matrix16f_t;
+
+// Alignment (bytes) of matrix memory; One cache line, so that every matrix starts on its own line
+#define MATRIX_ALIGNMENT    64
+
+// Arena (bump) allocator for matrices; A single aligned block of memory that matrices are carved out of.
+// Every matrix starts at a MATRIX_ALIGNMENT boundary and is padded to a whole number of cache lines.
+// Matrices allocated in an arena must NOT be freed with `deleteMatrix`; They are released all together
+// by `matrixArenaReset` (back to a mark) or `matrixArenaDelete`.
+typedef struct MATRIX_ARENA_ST {
+    uint8_t *mem;
+    size_t size; // bytes
+    size_t used; // bytes
+} matrix_arena_t;
+
+// Creates a new matrix object and allocates memory for it (MATRIX_ALIGNMENT aligned);
 // Returns non-zero on failure.
 int newMatrix32f(size_t h, size_t w, matrix32f_t *mat);
 int newMatrix32c(size_t h, size_t w, matrix32c_t *mat);
+// Bytes allocated by `newMatrix32f` for a h x w float matrix (padded to whole cache lines); For buffers that are
+// filled and then handed over as a matrix's memory
+size_t matrixBytes(size_t h, size_t w);
+
+// Allocates an arena of `size` bytes; Returns non-zero on failure.
+int matrixArenaCreate(size_t size, matrix_arena_t *arena);
+// Frees an arena's memory; All matrices allocated in it become invalid
+void matrixArenaDelete(matrix_arena_t *arena);
+// Bytes taken by a h x w float matrix in an arena; Use it to size arenas (a h x w complex matrix takes h x 2w)
+// Equal to `matrixBytes` since arena matrices are padded the same way
+size_t matrixArenaBytes(size_t h, size_t w);
+
+// Returns the arena's current position; Matrices allocated after a mark can be released together by resetting
+// to it, e.g. per-frame scratch matrices allocated on top of the model's parameters
+size_t matrixArenaMark(matrix_arena_t *arena);
+// Releases all matrices allocated after `mark` (0 releases everything)
+void matrixArenaReset(matrix_arena_t *arena, size_t mark);
+
+// Creates a matrix in `arena`; Returns non-zero when the arena is full.
+int newMatrix32fIn(matrix_arena_t *arena, size_t h, size_t w, matrix32f_t *mat);
+int newMatrix32cIn(matrix_arena_t *arena, size_t h, size_t w, matrix32c_t *mat);
 
 // De-Allocates memory for a matrix object
 void deleteMatrix(matrix32f_t *mat);
@@ -94,6 +160,9 @@ void flipVector(matrix32f_t *in0, matrix32f_t *out0);
 // Concatenates in0 and in1 into out0; out0 is expected to have allocated memory
 void matrixConcat(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0);
 
+// Transposes in0 into out0 (in0->w x in0->h); out0 is expected to have allocated memory
+void matrixTranspose(matrix32f_t *in0, matrix32f_t *out0);
+
 // Quantizes a 32-bit float matrix to 8-bit representation.
 // `int_bits` specifies the number of bits used for the integer part. The result is always signed.
 void dumpFloat32to8bit(matrix32f_t *mat, uint8_t int_bits, int8_t *dest);
@@ -102,3 +171,33 @@ void dumpFloat32to8bit(matrix32f_t *mat, uint8_t int_bits, int8_t *dest);
 // which should be already allocated.
 void matrixFrom8bit(int8_t *src, uint32_t int_bits, matrix32f_t *mat);
 void matrixFrom16bit(int16_t *src, uint32_t int_bits, matrix32f_t *mat);
+
+// Allocates a quantized matrix; Returns non-zero on failure.
+int newMatrix8q(size_t h, size_t w, matrix8q_t *mat);
+// De-Allocates memory for a quantized matrix
+void deleteMatrix8q(matrix8q_t *mat);
+
+// Quantizes `in` to `out` (symmetric, per-column scales); `out` is allocated by this function.
+// Returns non-zero on failure.
+int quantizeMatrix8q(matrix32f_t *in, matrix8q_t *out);
+
+// Allocates a fixed point matrix; Returns non-zero on failure.
+int newMatrix16q(size_t h, size_t w, uint8_t int_bits, matrix16q_t *mat);
+// De-Allocates memory for a fixed point matrix
+void deleteMatrix16q(matrix16q_t *mat);
+
+// Smallest number of integer bits that fits all of `mat`'s values (at most 15)
+uint8_t matrixIntBits16q(matrix32f_t *mat);
+// Converts a float matrix to `out`'s fixed point format (rounded, saturated); `out` should be allocated
+void matrixTo16q(matrix32f_t *in, matrix16q_t *out);
+// Converts a fixed point matrix to float; `out` should be allocated
+void matrixFrom16q(matrix16q_t *in, matrix32f_t *out);
+
+// Allocates a half precision matrix; Returns non-zero on failure.
+int newMatrix16f(size_t h, size_t w, matrix16f_t *mat);
+// De-Allocates memory for a half precision matrix
+void deleteMatrix16f(matrix16f_t *mat);
+
+// Converts a float matrix to half precision (round to nearest) and back; `out` should be allocated
+void matrixTo16f(matrix32f_t *in, matrix16f_t *out);
+void matrixFrom16f(matrix16f_t *in, matrix32f_t *out);
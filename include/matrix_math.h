@@ -1,6 +1,8 @@
 #pragma once
 #include <math.h>
 #include "matrix.h"
+#include "lut.h"
+#include "approx.h"
 
 // This file contains declarations for linear algebra routines on matrices.
 // For simplicity, a vector is also considered a matrix with one dimension set to 1.
@@ -8,31 +10,92 @@
 // Matrix by Vector multiplication and vice-versa have reduced logic compared
 // to a matrix multiplication.
 
-// Vector by Matrix Multiplication; if `in0.h == 0` some loops can be skipped
+// Vector by Matrix Multiplication; if `in0.h == 0` some loops can be skipped.
+// When `mat1->w` is a multiple of 4 the output is accumulated in registers and written once (register-blocked kernel)
 void multVecByMat(matrix32f_t *vec0, matrix32f_t *mat1, matrix32f_t *out0);
-// Vector by Matrix Multiplication; if `in1.h == 0` some loops can be skipped
+// Matrix by Vector Multiplication (`mat0` x column vector `vec1`); Any dimensions. With a transposed
+// (`matrixTranspose`) weight matrix this computes the same result as `multVecByMat`, reading the weights row by row
 void multMatByVec(matrix32f_t *mat0, matrix32f_t *vec1, matrix32f_t *out0);
 
+// Activations of `multVecByMatEx`
+#define ACTIVATION_NONE		0
+#define ACTIVATION_RELU		1
+#define ACTIVATION_TANH		2
+#define ACTIVATION_SIGMOID	3
+
+// Vector by Matrix Multiplication with an epilogue; out0 = act(vec0 x mat1 + bias). The bias (1 x mat1->w, or NULL)
+// and the activation are applied to every register tile before it is stored, instead of in separate `matrixSum` and
+// `clampingLUT`/`relu` passes over the output. tanh/sigmoid are taken from `act_lut`, or calculated (approx.h) if it
+// is NULL. `bias` may be `out0`, to accumulate onto a partial result (e.g. the input products of an LSTM gate).
+void multVecByMatEx(matrix32f_t *vec0, matrix32f_t *mat1, matrix32f_t *bias, uint8_t act, lut32f_t *act_lut, matrix32f_t *out0);
+// Folds a Batch Normalization, ((x - mean) .* gammavar + beta), into the preceding Fully Connected layer's weights at
+// load time; fused_w = fc_w .* gammavar (every row) and fused_bias = beta - mean .* gammavar. `multVecByMatEx` with
+// `fused_bias` then does the FC and BN layers in one pass. Allocates `fused_w` and `fused_bias`; If `fused_w` is `fc_w`
+// the weights are scaled in place. Returns 1 if an allocation fails.
+int foldBatchNorm(matrix32f_t *fc_w, matrix32f_t *mean, matrix32f_t *gammavar, matrix32f_t *beta, matrix32f_t *fused_w, matrix32f_t *fused_bias);
+
+// Vector by quantized Matrix Multiplication (see `matrix8q_t`); The input vector is quantized to 8 bits on
+// every call, products are accumulated in int32 and dequantized once per output element
+void multVecByMat_q8(matrix32f_t *vec0, matrix8q_t *mat1, matrix32f_t *out0);
+// Vector by Matrix Multiplication in fixed point (see `matrix16q_t`); Saturating accumulation,
+// the result is converted to `out0`'s format (`out0->int_bits` should be set). The accumulator has
+// `vec0->int_bits + mat1->int_bits` integer bits; Sums beyond that range saturate
+void multVecByMat_q16(matrix16q_t *vec0, matrix16q_t *mat1, matrix16q_t *out0);
+// Vector by Matrix Multiplication with half precision weights; `mat1` is widened to float while it is read
+// and the products are accumulated in float
+void multVecByMat_f16w(matrix32f_t *vec0, matrix16f_t *mat1, matrix32f_t *out0);
+
 // Adds two matrices together
 void matrixSum(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0);
 
 // Subtract two matrices
 void matrixDiff(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0);
 
+// Blocking parameters for `matrixMultiply`, sized for the Cortex-A53 (32KiB L1D, 512KiB L2).
+// A GEMM_KCxGEMM_NR sliver of `in1` stays in L1, a GEMM_MCxGEMM_KC block of `in0` and a
+// GEMM_KCxGEMM_NC block of `in1` stay in L2. GEMM_MR/GEMM_NR is the register tile of the micro-kernel.
+#define GEMM_MR     8
+#define GEMM_NR     8
+#define GEMM_MC     64
+#define GEMM_KC     256
+#define GEMM_NC     256
+
 // Matrix multiplication; out0.h=in0.h, out10.w=in1.w
-// NOTE: Not implemented (was not required)
+// Cache-blocked; `in1` is streamed from memory once per GEMM_MC rows of `in0` instead of once per row.
+// Packing buffers are allocated on every call; `matrixMultiplyWs` takes them from the caller instead.
 void matrixMultiply(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0);
+// Size (floats) of the workspace of `matrixMultiplyWs` for an (m x k) * (k x n) product; Enough for any smaller one
+size_t matrixMultiplyWsFloats(size_t m, size_t n, size_t k);
+// `matrixMultiply` with its packing buffers in `work` (matrixMultiplyWsFloats(in0.h, in1.w, in0.w) floats,
+// preferably aligned like a matrix); Never allocates
+void matrixMultiplyWs(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0, float32_t *work);
 
 // Hadamard product (Elementwise multiplication)
 void hadamardProduct(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0);
+// Scale and shift in one pass (out0 = in0 .* scale + shift); Every row of `in0` is a channel, `scale` and `shift` have
+// one element per column (bin) or a single one that is broadcast. Each scale/shift vector is read once for all rows,
+// so the channels of a stereo frame should be rows of the same matrix. In-place if `out0` is NULL.
+void affineTransform(matrix32f_t *in0, matrix32f_t *scale, matrix32f_t *shift, matrix32f_t *out0);
+// Fixed point (saturating) Hadamard product and sum; The product is converted to `out0`'s format,
+// both inputs of the sum should have the same format as the output
+void hadamardProduct_q16(matrix16q_t *in0, matrix16q_t *in1, matrix16q_t *out0);
+void matrixSum_q16(matrix16q_t *in0, matrix16q_t *in1, matrix16q_t *out0);
 // Elemetwise power of 2
 void elementwisePow2(matrix32f_t *in0, matrix32f_t *out0);
 
 // Applies ReLU to an input matrix
 void relu(matrix32f_t *input0, matrix32f_t *output0);
+// Fixed point ReLU; The output keeps the input's format
+void relu_q16(matrix16q_t *in0, matrix16q_t *out0);
 
 // Complex Matrix Operations - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void elementwisePow2_complex(matrix32c_t *in0);
 void squaredMagnitude(matrix32c_t *in0, matrix32f_t *out0);
 void hadamardProduct_complex(matrix32c_t *in0, matrix32c_t *in1, matrix32c_t *out0);
 void hadamardProduct_cbr(matrix32c_t *cin0, matrix32f_t *rin1, matrix32c_t *out0);
+// Gives every complex number the magnitude in `mask` and keeps its phase (X * mask/|X|); The same as
+// angleLUT_c -> expiLUT -> hadamardProduct_cbr without any LUTs or intermediate buffers. In-place if `out0` is NULL.
+void applyMagnitudeMask_c(matrix32c_t *cin0, matrix32f_t *mask, matrix32c_t *out0);
+// `affineTransform` of complex matrices with a real `scale` (per bin or broadcast) and a complex `shift`
+// (per bin, broadcast or NULL); out0 = cin0 .* scale + shift. In-place if `out0` is NULL.
+void affineTransform_c(matrix32c_t *cin0, matrix32f_t *scale, matrix32c_t *shift, matrix32c_t *out0);
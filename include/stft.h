@@ -1,42 +1,159 @@
 #pragma once
 
 #include "matrix.h" // NOTE: matrix.h includes <complex.h>, which should be defined before <fftw3.h> to enable the C99 complex type
+#ifndef BUILTIN_FFT
 #include <fftw3.h>
+#endif
 
 #include "lut.h"
 
 typedef float complex complex_t;
 
-// Struct holding settings and variables used for stft operations
-typedef struct stft_st {
-	// Input/Output pointers for STFT operation
-	matrix32f_t *input_ptr;
-	complex_t   *stft_out_ptr;
+#ifndef BUILTIN_FFT
+typedef fftwf_plan fft_plan_t;
+#else
+// Built-in real FFT (-DBUILTIN_FFT) for builds without FFTW, e.g. bare metal; Power of two sizes from 32 up, computed
+// as a complex FFT of half the size (radix-4 Stockham stages, one radix-2 stage for odd powers) and a split step.
+// Transforms are unnormalized like FFTW's and other sizes are refused (`stftPlan` returns NULL). Planner flags are
+// accepted but there is a single algorithm.
+typedef struct FFT_PLAN_ST *fft_plan_t;
+#ifndef FFTW_ESTIMATE
+#define FFTW_ESTIMATE	0
+#define FFTW_MEASURE	0
+#define FFTW_PATIENT	0
+#endif
+#endif
+
+// Planner flags of the FFTW plans until `initFFT` sets others
+#define STFT_DEFAULT_FFTW_FLAGS	FFTW_ESTIMATE
+// Maximum number of different plans kept by the plan cache
+#define STFT_PLAN_CACHE_SIZE	16
 
+// Directions of `stftPlan`
+#define STFT_FORWARD	0	// real to complex
+#define STFT_INVERSE	1	// complex to real
+
+// Streaming STFT/iSTFT engine; Audio is pushed in blocks of any length and a frame (`spectrum`) is produced every
+// `hop_size` samples from the last `fft_size` samples, weighted by a Hann window. Frames pushed to the inverse path
+// are overlap-added with a synthesis window that makes analysis + synthesis reconstruct the input exactly when
+// hop_size < fft_size (delayed by `fft_size - hop_size` samples). All buffers and plans are created by `stftCreate`.
+typedef struct stft_st {
 	// Settings for STFT
 	uint32_t  fft_size;
 	uint32_t  hop_size;
+	uint32_t  bin_count;		// fft_size/2 + 1
 
-	// Weight buffer for input window
+	// Analysis and synthesis windows (1 x fft_size); The synthesis window includes the normalization of the
+	// overlap-add and of FFTW's unnormalized inverse
 	matrix32f_t window_mat;
+	matrix32f_t synthesis_mat;
+
+	// Analysis; Ring buffer of the last fft_size input samples and the windowed frame that's transformed
+	matrix32f_t in_ring;
+	size_t      in_pos;			// next write position, i.e. the oldest sample
+	size_t      hop_fill;		// samples pushed since the last frame
+	matrix32f_t frame;
+	matrix32c_t spectrum;		// 1 x bin_count, the last frame
+
+	// Synthesis; The inverse is written to `iframe` and overlap-added to a ring buffer of fft_size samples
+	matrix32c_t ispectrum;		// copy of the input frame; FFTW's c2r transforms destroy their input
+	matrix32f_t iframe;
+	matrix32f_t ola_ring;
+	size_t      ola_pos;		// first sample of the next hop to be output
+
+	// Batch mode (`stftEnableBatch`); Up to batch_size frames are windowed into one contiguous buffer and
+	// transformed by a single plan. Rows are padded to `frame_stride` floats/`bin_stride` bins so every row is
+	// aligned like the single frame buffers.
+	uint32_t    batch_size;
+	uint32_t    frame_stride;
+	uint32_t    bin_stride;
+	matrix32f_t batch_frames;	// batch_size x frame_stride
+	matrix32c_t batch_spectra;	// batch_size x bin_stride
+	matrix32c_t batch_ispectra;
+	matrix32f_t batch_iframes;
 
-	// Struct for FFTW
-	fftwf_plan plan;
+	// Structs for FFTW; Owned by the plan cache and executed on the engine's buffers
+	fft_plan_t plan;
+	fft_plan_t iplan;
+	fft_plan_t batch_plan;
+	fft_plan_t batch_iplan;
+#ifdef BUILTIN_FFT
+	matrix32c_t fft_work;		// 1 x fft_size/2, intermediate stages of the built-in FFT
+#endif
 } stft_t;
 
-// Loads FFTW wisdom
-//int initFFT(float32_t* inptr, complex_t* outptr, uint32_t hopsize, uint32_t fftsize, stft_t *settings);
+// Creates an engine; `fft_size` should be even and `hop_size` within [1, fft_size]
+int  stftCreate(uint32_t fft_size, uint32_t hop_size, stft_t *stft);
+void stftDelete(stft_t *stft);
+// Clears the input and overlap-add buffers
+void stftReset(stft_t *stft);
+
+// Pushes up to `count` samples; Stops when a hop is completed, in which case the frame is transformed into
+// `stft->spectrum` and `frame_ready` is set. Returns the number of samples used, so a block is pushed with:
+//   for(size_t i = 0; i < len; ) { i += stftPush(&stft, &block[i], len - i, &ready); if(ready) { ... } }
+size_t stftPush(stft_t *stft, const float32_t *samples, size_t count, uint8_t *frame_ready);
+// Transforms a frame (1 x bin_count) back and overlap-adds it; Writes the `hop_size` samples that are completed to `out`
+void stftInverse(stft_t *stft, matrix32c_t *spectrum, float32_t *out);
+
+// Creates the buffers and plans for transforming up to `frames` frames at once
+int  stftEnableBatch(stft_t *stft, uint32_t frames);
+// Transforms `frames` (<= batch_size) hop-strided frames of `audio`, i.e. frame t is audio[t*hop_size .. t*hop_size + fft_size),
+// into the rows of `stft->batch_spectra`. Independent of the streaming input; For offline processing or catching up.
+void stftForwardBatch(stft_t *stft, const float32_t *audio, size_t frames);
+// Inverse of `frames` rows of `spectra` (rows of bin_stride bins, e.g. `batch_spectra`); Overlap-adds them like
+// `stftInverse` and writes frames*hop_size samples to `out`
+void stftInverseBatch(stft_t *stft, matrix32c_t *spectra, size_t frames, float32_t *out);
+
+// Imports FFTW wisdom from `wisdom_path` (if not NULL) and sets the planner flags of all plans made from now on,
+// e.g. FFTW_MEASURE or FFTW_PATIENT; With the wisdom of a previous run (`saveFFTWisdom`) those plans are made without
+// measuring again. Returns 0 if wisdom was imported, 30 if there was none (e.g. first run; not an error).
+// The built-in FFT has no wisdom; It always returns 30 and `saveFFTWisdom` does nothing.
+int  initFFT(const char *wisdom_path, unsigned flags);
+// Exports the wisdom of all plans made so far; Returns 0 on success and 30 if the file can't be written
+int  saveFFTWisdom(const char *wisdom_path);
+// Destroys all cached plans; No engine should be used afterwards
+void cleanupFFT();
+
+// Plan cache; Returns a plan for `howmany` transforms of size n between arrays laid out like `real` (transforms
+// `real_dist` floats apart) and `cplx` (`complex_dist` bins apart). Plans are shared by everything with the same
+// size, direction, layout, in-place-ness, alignment and flags, and must be executed with the new-array functions
+// (`fftwf_execute_dft_r2c`/`_c2r`, or `fftExecute` with -DBUILTIN_FFT). Planning may overwrite the arrays.
+// Not thread-safe; returns NULL on failure or if the cache is full.
+fft_plan_t stftPlan(uint32_t n, uint8_t direction, uint32_t howmany, uint32_t real_dist, uint32_t complex_dist, float32_t *real, complex_t *cplx);
+
+#ifdef BUILTIN_FFT
+// Runs all transforms of a built-in plan; `real` and `cplx` are laid out as given to `stftPlan`, `work` holds
+// fft_size/2 bins. Forward transforms leave `real` untouched, inverse ones leave `cplx` untouched.
+void fftExecute(fft_plan_t plan, float32_t *real, complex_t *cplx, complex_t *work);
+#endif
+
+// Runs a plan of `stftPlan` on the given arrays with either FFT; `work` (fft_size/2 bins) is only used by the built-in one
+#ifndef BUILTIN_FFT
+#define fftForward(plan, real, cplx, work)	fftwf_execute_dft_r2c(plan, real, cplx)
+#define fftInverse(plan, cplx, real, work)	fftwf_execute_dft_c2r(plan, cplx, real)
+#else
+#define fftForward(plan, real, cplx, work)	fftExecute(plan, real, cplx, work)
+#define fftInverse(plan, cplx, real, work)	fftExecute(plan, real, cplx, work)
+#endif
 
 // Loads a matrix with the Hann window used in STFT
 void hannWindow(uint32_t fftsize, matrix32f_t *mat);
 
-// Manipulates the input matrix so that it becomes longer
+// Manipulates the input matrix so that it becomes longer; Any input length
 void extendInput(matrix32f_t *in0, matrix32f_t *out0, uint8_t rank);
 
 // Converts FFTW Complex Output to matrix32f_t spectogram
 void fftToSpectogram(matrix32c_t *fftin, matrix32f_t *out0, lut32f_t *sqrt_lut);
 
-// Performs STFT and iSTFT operations using FFTW functions
+// Fused spectrogram front end; Same result as `extendInput` -> Hann window -> FFT -> `fftToSpectogram`, in one
+// pass that windows while extending `in0` (fft_size/rank samples, rank 1, 2, 4 or 8) into the engine's frame and one
+// that writes |X| straight to `out0` (1 x bin_count). fft_size/rank doesn't have to be a multiple of 4. The square
+// root is taken from `sqrt_lut`, or calculated if it is NULL. Uses the engine's window, plan and buffers;
+// `stft->spectrum` is overwritten, the streaming input isn't.
+void spectrogramFrame(stft_t *stft, matrix32f_t *in0, uint8_t rank, lut32f_t *sqrt_lut, matrix32f_t *out0);
+
+// Single steps of the engine; `fft` windows the last fft_size samples and transforms them into `spectrum`,
+// `ifft` transforms `ispectrum` back and overlap-adds it at `ola_pos`
 void fft(stft_t *settings);
 void ifft(stft_t *settings);
 
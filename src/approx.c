@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <math.h>
+#include <arm_neon.h>
+
+#include "matrix.h"
+#include "approx.h"
+
+#ifndef SERIAL
+// NEON Code * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+void tanhApprox(matrix32f_t *input0, matrix32f_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL) { printf("Error in tanhApprox: input0 is not initialized.\n"); return; }
+    if(output0 != NULL && ((input0->w != output0->w) || (input0->h != output0->h))) {
+        printf("Error in tanhApprox: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    float32_t *output = (output0 == NULL) ? input0->d : output0->d;
+
+    size_t i;
+    for(i = 0; i+4 <= length; i+=4) { vst1q_f32(&output[i], vtanhApproxq_f32(vld1q_f32(&input0->d[i]))); }
+    for(i; i < length; i++) { output[i] = tanhApproxScalar(input0->d[i]); }
+}
+
+void sigmoidApprox(matrix32f_t *input0, matrix32f_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL) { printf("Error in sigmoidApprox: input0 is not initialized.\n"); return; }
+    if(output0 != NULL && ((input0->w != output0->w) || (input0->h != output0->h))) {
+        printf("Error in sigmoidApprox: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    float32_t *output = (output0 == NULL) ? input0->d : output0->d;
+
+    size_t i;
+    for(i = 0; i+4 <= length; i+=4) { vst1q_f32(&output[i], vsigmoidApproxq_f32(vld1q_f32(&input0->d[i]))); }
+    for(i; i < length; i++) { output[i] = sigmoidApproxScalar(input0->d[i]); }
+}
+
+void sqrtApprox(matrix32f_t *input0, matrix32f_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL) { printf("Error in sqrtApprox: input0 is not initialized.\n"); return; }
+    if(output0 != NULL && ((input0->w != output0->w) || (input0->h != output0->h))) {
+        printf("Error in sqrtApprox: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    float32_t *output = (output0 == NULL) ? input0->d : output0->d;
+
+    size_t i;
+    for(i = 0; i+4 <= length; i+=4) { vst1q_f32(&output[i], vsqrtApproxq_f32(vld1q_f32(&input0->d[i]))); }
+    // Leftovers use the sqrt instruction; There's no scalar estimate to save time on
+    for(i; i < length; i++) { output[i] = sqrtf(input0->d[i]); }
+}
+
+void atanApprox(matrix32f_t *input0, matrix32f_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL) { printf("Error in atanApprox: input0 is not initialized.\n"); return; }
+    if(output0 != NULL && ((input0->w != output0->w) || (input0->h != output0->h))) {
+        printf("Error in atanApprox: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    float32_t *output = (output0 == NULL) ? input0->d : output0->d;
+
+    size_t i;
+    for(i = 0; i+4 <= length; i+=4) { vst1q_f32(&output[i], vatanApproxq_f32(vld1q_f32(&input0->d[i]))); }
+    for(i; i < length; i++) { output[i] = atanApproxScalar(input0->d[i]); }
+}
+
+void angleApprox_c(matrix32c_t *input0, matrix32f_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL || output0->d == NULL) { printf("Error in angleApprox_c: Input/Output not initialized.\n"); return; }
+    if((input0->w != output0->w) || (input0->h != output0->h)) {
+        printf("Error in angleApprox_c: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    float32_t *indf = (float32_t*)input0->d;
+
+    // vld2 de-interleaves the real and imaginary parts
+    float32x4x2_t vin;
+    size_t i;
+    for(i = 0; i+4 <= length; i+=4) {
+        vin = vld2q_f32(&indf[2*i]);
+        vst1q_f32(&output0->d[i], vangleApproxq_f32(vin.val[1], vin.val[0]));
+    }
+    for(i; i < length; i++) { output0->d[i] = angleApproxScalar(indf[2*i+1], indf[2*i]); }
+}
+
+void expiApprox(matrix32f_t *input0, matrix32c_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL || output0->d == NULL) { printf("Error in expiApprox: Input/Output not initialized.\n"); return; }
+    if((input0->w != output0->w) || (input0->h != output0->h)) {
+        printf("Error in expiApprox: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    float32_t *outdf = (float32_t*)output0->d;
+
+    // vst2 interleaves cosine (real) and sine (imaginary)
+    float32x4x2_t vout;
+    size_t i;
+    for(i = 0; i+4 <= length; i+=4) {
+        vsincosApproxq_f32(vld1q_f32(&input0->d[i]), &vout.val[1], &vout.val[0]);
+        vst2q_f32(&outdf[2*i], vout);
+    }
+    for(i; i < length; i++) { sincosApproxScalar(input0->d[i], &outdf[2*i+1], &outdf[2*i]); }
+}
+
+#else
+// Serial Code * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+void tanhApprox(matrix32f_t *input0, matrix32f_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL) { printf("Error in tanhApprox: input0 is not initialized.\n"); return; }
+    if(output0 != NULL && ((input0->w != output0->w) || (input0->h != output0->h))) {
+        printf("Error in tanhApprox: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    float32_t *output = (output0 == NULL) ? input0->d : output0->d;
+
+    for(size_t i = 0; i < length; i++) { output[i] = tanhApproxScalar(input0->d[i]); }
+}
+
+void sigmoidApprox(matrix32f_t *input0, matrix32f_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL) { printf("Error in sigmoidApprox: input0 is not initialized.\n"); return; }
+    if(output0 != NULL && ((input0->w != output0->w) || (input0->h != output0->h))) {
+        printf("Error in sigmoidApprox: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    float32_t *output = (output0 == NULL) ? input0->d : output0->d;
+
+    for(size_t i = 0; i < length; i++) { output[i] = sigmoidApproxScalar(input0->d[i]); }
+}
+
+void sqrtApprox(matrix32f_t *input0, matrix32f_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL) { printf("Error in sqrtApprox: input0 is not initialized.\n"); return; }
+    if(output0 != NULL && ((input0->w != output0->w) || (input0->h != output0->h))) {
+        printf("Error in sqrtApprox: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    float32_t *output = (output0 == NULL) ? input0->d : output0->d;
+
+    // Without SIMD there's no estimate instruction; The square root instruction is the fastest option
+    for(size_t i = 0; i < length; i++) { output[i] = sqrtf(input0->d[i]); }
+}
+
+void atanApprox(matrix32f_t *input0, matrix32f_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL) { printf("Error in atanApprox: input0 is not initialized.\n"); return; }
+    if(output0 != NULL && ((input0->w != output0->w) || (input0->h != output0->h))) {
+        printf("Error in atanApprox: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    float32_t *output = (output0 == NULL) ? input0->d : output0->d;
+
+    for(size_t i = 0; i < length; i++) { output[i] = atanApproxScalar(input0->d[i]); }
+}
+
+void angleApprox_c(matrix32c_t *input0, matrix32f_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL || output0->d == NULL) { printf("Error in angleApprox_c: Input/Output not initialized.\n"); return; }
+    if((input0->w != output0->w) || (input0->h != output0->h)) {
+        printf("Error in angleApprox_c: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    float32_t *indf = (float32_t*)input0->d;
+
+    for(size_t i = 0; i < length; i++) { output0->d[i] = angleApproxScalar(indf[2*i+1], indf[2*i]); }
+}
+
+void expiApprox(matrix32f_t *input0, matrix32c_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL || output0->d == NULL) { printf("Error in expiApprox: Input/Output not initialized.\n"); return; }
+    if((input0->w != output0->w) || (input0->h != output0->h)) {
+        printf("Error in expiApprox: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    float32_t *outdf = (float32_t*)output0->d;
+
+    for(size_t i = 0; i < length; i++) { sincosApproxScalar(input0->d[i], &outdf[2*i+1], &outdf[2*i]); }
+}
+
+#endif
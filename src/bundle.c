@@ -0,0 +1,217 @@
+#ifndef BAREMETAL
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <string.h> // strncmp, memcpy
+
+#include "bundle.h"
+
+// CRC-32 (IEEE 802.3, reflected); The table is built on first use
+static uint32_t crc_table[256];
+static uint8_t crc_table_ready = 0;
+
+static uint32_t bundleCRC32(const uint8_t *data, size_t len) {
+    if(!crc_table_ready) {
+        for(uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for(uint8_t b = 0; b < 8; b++) { c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1); }
+            crc_table[i] = c;
+        }
+        crc_table_ready = 1;
+    }
+
+    uint32_t crc = 0xFFFFFFFF;
+    for(size_t i = 0; i < len; i++) { crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8); }
+    return crc ^ 0xFFFFFFFF;
+}
+
+// Rounds a byte offset up to the alignment of the bundle's data
+static inline size_t bundleAlign(size_t offset) {
+    return (offset + MATRIX_ALIGNMENT - 1) & ~((size_t)MATRIX_ALIGNMENT - 1);
+}
+
+// Finds the entry called `name` of the given type; Returns NULL if there's none
+static bundle_entry_t *bundleFind(bundle_t *bundle, const char *name, uint32_t type) {
+    for(uint32_t i = 0; i < bundle->header->entry_count; i++) {
+        bundle_entry_t *entry = &bundle->entries[i];
+        if(entry->type == type && strncmp(entry->name, name, BUNDLE_NAME_LENGTH) == 0) { return entry; }
+    }
+    return NULL;
+}
+
+
+int bundleOpen(const char *path, uint8_t verify, bundle_t *bundle) {
+    bundle->mem = NULL;
+    bundle->size = 0;
+
+#ifndef BAREMETAL
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) { return 30; }
+
+    struct stat st;
+    if(fstat(fd, &st) || st.st_size < (off_t)sizeof(bundle_header_t)) { close(fd); return 35; }
+
+    // Private mapping; Views are writable but changes never reach the file
+    void *mem = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mem == MAP_FAILED) { return 100; }
+
+    bundle->mem = (uint8_t*)mem;
+    bundle->size = st.st_size;
+    bundle->mapped = 1;
+#else
+    FILE *file = fopen(path, "rb");
+    if(file == NULL) { return 30; }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if(size < (long)sizeof(bundle_header_t)) { fclose(file); return 35; }
+
+    // Read the whole file into aligned memory so the data offsets keep their alignment
+    bundle->mem = (uint8_t*)aligned_alloc(MATRIX_ALIGNMENT, bundleAlign(size));
+    if(bundle->mem == NULL) { fclose(file); return 100; }
+    if(fread(bundle->mem, 1, size, file) != (size_t)size) { fclose(file); bundleClose(bundle); return 35; }
+    fclose(file);
+
+    bundle->size = size;
+    bundle->mapped = 0;
+#endif
+
+    bundle->header  = (bundle_header_t*)bundle->mem;
+    bundle->entries = (bundle_entry_t*)(bundle->mem + sizeof(bundle_header_t));
+
+    // Check the header and that the entries fit in the file
+    bundle_header_t *header = bundle->header;
+    if(header->magic != BUNDLE_MAGIC || header->size != bundle->size) { bundleClose(bundle); return 35; }
+    if(header->version != BUNDLE_VERSION) { bundleClose(bundle); return 36; }
+    if(sizeof(bundle_header_t) + (size_t)header->entry_count*sizeof(bundle_entry_t) > bundle->size) { bundleClose(bundle); return 35; }
+    for(uint32_t i = 0; i < header->entry_count; i++) {
+        bundle_entry_t *entry = &bundle->entries[i];
+        if(entry->offset % MATRIX_ALIGNMENT || entry->offset + (uint64_t)entry->h*entry->w*sizeof(float32_t) > bundle->size) {
+#ifdef DEBUG
+            printf("Error in bundleOpen: Entry %d (%.32s) is out of bounds.\n", i, entry->name);
+#endif
+            bundleClose(bundle);
+            return 35;
+        }
+    }
+
+    if(verify && bundleCRC32(bundle->mem + sizeof(bundle_header_t), bundle->size - sizeof(bundle_header_t)) != header->checksum) {
+#ifdef DEBUG
+        printf("Error in bundleOpen: Checksum mismatch (%s).\n", path);
+#endif
+        bundleClose(bundle);
+        return 37;
+    }
+    return 0;
+}
+
+void bundleClose(bundle_t *bundle) {
+    if(bundle->mem == NULL) { return; }
+#ifndef BAREMETAL
+    if(bundle->mapped) { munmap(bundle->mem, bundle->size); }
+    else               { free(bundle->mem); }
+#else
+    free(bundle->mem);
+#endif
+    bundle->mem = NULL;
+    bundle->size = 0;
+}
+
+int bundleMatrix(bundle_t *bundle, const char *name, matrix32f_t *view) {
+    bundle_entry_t *entry = bundleFind(bundle, name, BUNDLE_MATRIX);
+    if(entry == NULL) {
+#ifdef DEBUG
+        printf("Error in bundleMatrix: There's no matrix called %s.\n", name);
+#endif
+        return 1;
+    }
+    view->h = entry->h;
+    view->w = entry->w;
+    view->d = (float32_t*)(bundle->mem + entry->offset);
+    return 0;
+}
+
+int bundleLUT(bundle_t *bundle, const char *name, lut32f_t *view) {
+    bundle_entry_t *entry = bundleFind(bundle, name, BUNDLE_LUT);
+    if(entry == NULL) {
+#ifdef DEBUG
+        printf("Error in bundleLUT: There's no LUT called %s.\n", name);
+#endif
+        return 1;
+    }
+    view->length      = entry->w;
+    view->mult_factor = entry->mult_factor;
+    view->bias        = entry->bias;
+    view->mode        = entry->lut_mode;
+    view->data        = (float32_t*)(bundle->mem + entry->offset);
+    return 0;
+}
+
+int bundleWrite(const char *path, bundle_item_t *items, size_t count) {
+    // Lay the file out: header, entries, then every item's data at an aligned offset
+    size_t size = bundleAlign(sizeof(bundle_header_t) + count*sizeof(bundle_entry_t));
+    for(size_t i = 0; i < count; i++) {
+        if(items[i].name == NULL || strlen(items[i].name) >= BUNDLE_NAME_LENGTH || (items[i].mat == NULL) == (items[i].lut == NULL)) {
+#ifdef DEBUG
+            printf("Error in bundleWrite: Item %d is invalid (name missing or too long, or not exactly one of mat/lut set).\n", i);
+#endif
+            return 1;
+        }
+        size_t floats = (items[i].mat != NULL) ? items[i].mat->h * items[i].mat->w : lutFloats(items[i].lut);
+        size = bundleAlign(size + floats*sizeof(float32_t));
+    }
+
+    // The file is built in memory so the checksum can be calculated before writing
+    uint8_t *mem = (uint8_t*)calloc(size, 1);
+    if(mem == NULL) { return 100; }
+
+    bundle_header_t *header = (bundle_header_t*)mem;
+    bundle_entry_t *entries = (bundle_entry_t*)(mem + sizeof(bundle_header_t));
+    header->magic = BUNDLE_MAGIC;
+    header->version = BUNDLE_VERSION;
+    header->entry_count = count;
+    header->size = size;
+
+    size_t offset = bundleAlign(sizeof(bundle_header_t) + count*sizeof(bundle_entry_t));
+    for(size_t i = 0; i < count; i++) {
+        bundle_entry_t *entry = &entries[i];
+        strncpy(entry->name, items[i].name, BUNDLE_NAME_LENGTH);
+        entry->offset = offset;
+
+        const float32_t *data;
+        if(items[i].mat != NULL) {
+            entry->type = BUNDLE_MATRIX;
+            entry->h = items[i].mat->h;
+            entry->w = items[i].mat->w;
+            data = items[i].mat->d;
+        }
+        else {
+            entry->type = BUNDLE_LUT;
+            entry->h = (items[i].lut->mode == LUT_LINEAR) ? 2 : 1;
+            entry->w = items[i].lut->length;
+            entry->mult_factor = items[i].lut->mult_factor;
+            entry->bias = items[i].lut->bias;
+            entry->lut_mode = items[i].lut->mode;
+            data = items[i].lut->data;
+        }
+        memcpy(mem + offset, data, (size_t)entry->h*entry->w*sizeof(float32_t));
+        offset = bundleAlign(offset + (size_t)entry->h*entry->w*sizeof(float32_t));
+    }
+    header->checksum = bundleCRC32(mem + sizeof(bundle_header_t), size - sizeof(bundle_header_t));
+
+    int ret = 0;
+    FILE *file = fopen(path, "wb");
+    if(file == NULL) { ret = 30; }
+    else {
+        if(fwrite(mem, 1, size, file) != size) { ret = 30; }
+        fclose(file);
+    }
+    free(mem);
+    return ret;
+}
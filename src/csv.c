@@ -1,165 +1,439 @@
+#ifndef BAREMETAL
+#include <pthread.h>
+#endif
+
+#include <float.h>  // FLT_MIN, FLT_MAX
+#include <string.h> // memchr, memcpy, memmove
+
 #include "csv.h"
 
-float32_t power(float32_t i, int8_t pow) {
-	float32_t ret = i;
-	if(pow > 0) {
-		for(int8_t n = 1; n < pow; n++) { ret *= i; }
+// Powers of ten; The positive ones are exact in a double, the negative ones are off by half an ulp at most
+// (multiplying by them is much faster than dividing)
+static const double csv_pow10[] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+static const double csv_pow10_neg[] = {
+	1e0,   1e-1,  1e-2,  1e-3,  1e-4,  1e-5,  1e-6,  1e-7,  1e-8,  1e-9,  1e-10, 1e-11,
+	1e-12, 1e-13, 1e-14, 1e-15, 1e-16, 1e-17, 1e-18, 1e-19, 1e-20, 1e-21, 1e-22
+};
+#define CSV_MAX_POW10		22
+// Significant digits kept in the mantissa; 10^19 < 2^64
+#define CSV_MAX_DIGITS		19
+
+// 8 ASCII digits at once (little endian); `csvEightDigits` checks that all bytes of `v` are digits
+static inline uint8_t csvEightDigits(uint64_t v) {
+	return (((v & 0xF0F0F0F0F0F0F0F0) | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333);
+}
+static inline uint32_t csvParseEightDigits(uint64_t v) {
+	v -= 0x3030303030303030;
+	v = (v * 10) + (v >> 8);
+	v = (((v & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) + (((v >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+	return (uint32_t)v;
+}
+
+// mantissa * 10^exponent as a float; Returns 1 if the result can't be guaranteed to be correctly rounded.
+// The double calculation is off by a few ulps at most, so rounding it to float is only ambiguous when it lands
+// next to the midpoint of two floats (or outside the normal range); Those cases are left to `strtof`.
+static inline uint8_t csvToFloat(uint64_t mantissa, int32_t exponent, float32_t *out) {
+	double d = (double)mantissa;
+	if(exponent < 0) {
+		if(exponent < -2*CSV_MAX_POW10) { return 1; }
+		if(exponent < -CSV_MAX_POW10) { d *= csv_pow10_neg[CSV_MAX_POW10]; exponent += CSV_MAX_POW10; }
+		d *= csv_pow10_neg[-exponent];
+	}
+	else {
+		if(exponent > 2*CSV_MAX_POW10) { return 1; }
+		if(exponent > CSV_MAX_POW10) { d *= csv_pow10[CSV_MAX_POW10]; exponent -= CSV_MAX_POW10; }
+		d *= csv_pow10[exponent];
+	}
+	if(d < FLT_MIN || d > FLT_MAX) { return 1; }
+
+	// The 29 low bits of the double's mantissa are the ones rounded off
+	uint64_t bits;
+	memcpy(&bits, &d, sizeof(bits));
+	uint32_t rounded_off = bits & 0x1FFFFFFF;
+	if(rounded_off > 0x10000000 - 32 && rounded_off < 0x10000000 + 32) { return 1; }
+
+	*out = (float32_t)d;
+	return 0;
+}
+
+// Parses the number at `p`, which must be followed by a non-numeric character;
+// Returns a pointer past it or NULL if it isn't a valid number.
+static const char *csvParseFloat(const char *p, float32_t *out) {
+	const char *start = p;
+	uint8_t is_negative = 0;
+	if(*p == '-') { is_negative = 1; p++; }
+	else if(*p == '+') { p++; }
+
+	// Digits after the first CSV_MAX_DIGITS significant ones only move the exponent
+	uint64_t mantissa = 0;
+	int32_t exponent = 0;
+	uint8_t digits = 0, has_digits = 0;
+	for(; (uint8_t)(*p - '0') < 10; p++) {
+		has_digits = 1;
+		if(digits < CSV_MAX_DIGITS) { mantissa = mantissa*10 + (*p - '0'); digits += (mantissa != 0); }
+		else { exponent++; }
 	}
-	else if(pow < 0) {
-		for(int8_t n = -1; n >= pow; n--) { ret /= i; }
+	if(*p == '.') {
+		// Once a significant digit has been seen, blocks of 8 digits are converted together; The 8 bytes are
+		// read before checking them, so the buffer needs 8 bytes of padding
+		p++;
+		uint64_t block;
+		while(mantissa != 0 && digits + 8 <= CSV_MAX_DIGITS && (memcpy(&block, p, sizeof(block)), csvEightDigits(block))) {
+			mantissa = mantissa*100000000 + csvParseEightDigits(block);
+			digits += 8;
+			exponent -= 8;
+			p += 8;
+		}
+		for(; (uint8_t)(*p - '0') < 10; p++) {
+			has_digits = 1;
+			if(digits < CSV_MAX_DIGITS) { mantissa = mantissa*10 + (*p - '0'); digits += (mantissa != 0); exponent--; }
+		}
 	}
-	else { ret = 1.0; }
-	//printf("\t\t\t\t\tpow(%f, %d) = %f\r", i, pow, ret);
+	if(!has_digits) { return NULL; }
+
+	if(*p == 'e' || *p == 'E') {
+		p++;
+		uint8_t negative_exponent = 0;
+		if(*p == '-') { negative_exponent = 1; p++; }
+		else if(*p == '+') { p++; }
+		if((uint8_t)(*p - '0') >= 10) { return NULL; }
 
-	return ret;
+		int32_t e = 0;
+		for(; (uint8_t)(*p - '0') < 10; p++) { if(e < 10000) { e = e*10 + (*p - '0'); } }
+		exponent += (negative_exponent) ? -e : e;
+	}
+
+	if(mantissa == 0) { *out = 0.0; }
+	else if(csvToFloat(mantissa, exponent, out)) { *out = strtof(start, NULL); return p; }
+	if(is_negative) { *out = -*out; }
+	return p;
 }
 
-enum parse_state_enum { start, integer, fractional, exponent_state, next };
-typedef enum parse_state_enum parse_state_t;
+// Parses the values in [p, stop) into `out` (at most `capacity` of them) and sets `count`; `stop` must follow a
+// delimiter or point to a NUL, and `last` is set if it is the end of the file. `row` and `col` are the position
+// of `p` in the file and are kept up to date.
+static int csvParseRange(const char *path, const char *p, const char *stop, uint8_t last, float32_t *out, size_t capacity, size_t *count, size_t *row, size_t *col) {
+	size_t n = 0;
+	while(p < stop) {
+		const char *line_end = (const char*)memchr(p, '\n', stop - p);
+		if(line_end == NULL) { line_end = stop; }
+
+		while(p < line_end) {
+			if(*p == '\r' && p + 1 == line_end) { p++; break; } // CRLF or an empty line
+
+			float32_t f;
+			const char *q = csvParseFloat(p, &f);
+			if(q == NULL || (*q != ',' && q != line_end && !(*q == '\r' && q + 1 == line_end))) {
+				printf("Error in matrixFromCSV: %s:%lu:%lu: Invalid number.\n", path, (unsigned long)*row, (unsigned long)*col);
+				*count = n;
+				return 2;
+			}
+			if(n == capacity) {
+				printf("Error in matrixFromCSV: %s:%lu:%lu: More values than expected.\n", path, (unsigned long)*row, (unsigned long)*col);
+				*count = n;
+				return 80;
+			}
+			out[n++] = f;
+			(*col)++;
+			p = (*q == ',') ? q + 1 : q;
+
+			// A ',' must be followed by a value; A line without a '\n' may continue in the next chunk
+			if(*q == ',' && (p == line_end || (*p == '\r' && p + 1 == line_end)) && (line_end < stop || last)) {
+				printf("Error in matrixFromCSV: %s:%lu:%lu: Missing value after ','.\n", path, (unsigned long)*row, (unsigned long)*col);
+				*count = n;
+				return 2;
+			}
+		}
+
+		// A line that continues in the next chunk has no '\n' yet
+		if(line_end < stop) { (*row)++; *col = 1; }
+		p = line_end + 1;
+	}
+	*count = n;
+	return 0;
+}
 
 int matrixFromCSV(const char *path, size_t height, size_t width, matrix32f_t *mat) {
-    // Load file
-    FILE *csvFile = fopen(path, "r");
-    if(csvFile == NULL) { return 30; }
-    char *buffer = malloc(sizeof(char) * BUFFERSIZE);
-
-	// Set to 1 if the end of the file was reached. EOF is set during parsing, NOT READING
-	uint8_t eof = 0;
-	// Set if an error occurs
-	int8_t err = 0;
-	// Buffer to store floats
-	float32_t *tempf;
-
-    // Create matrix
-    if(height==0 || width== 0) { err = 1; goto exception; }
-
-    mat->h = height;
-    mat->w = width;
-	size_t alloc_floats = mat->h * mat->w;
-	tempf = (float32_t*)malloc(alloc_floats * sizeof(float32_t));
-
-	// Create variables for handling the read buffer
-	// Increased while parsing; shows when a new read should occur
-	size_t buffer_idx = 0;
-	// The number of valid bytes in buffer; When buffer_idx == buffer_len, a read occurs
-	size_t buffer_len = 0; // set to 0 to force a read
-
-    float32_t f;
-	char c = 1;
-	int8_t exponent, negative_exponent;
-	uint8_t is_negative, pos_after_point;
+	if(height == 0 || width == 0) { return 1; }
+
+	FILE *csvFile = fopen(path, "r");
+	if(csvFile == NULL) { return 30; }
+
+	// Padding for the terminating NUL of the last chunk and the 8 byte reads of `csvParseFloat`
+	char *buffer = (char*)calloc(BUFFERSIZE + 8, 1);
+	size_t alloc_floats = height * width;
+	float32_t *tempf = (float32_t*)aligned_alloc(MATRIX_ALIGNMENT, matrixBytes(height, width)); // same alignment as `newMatrix32f`
+	int err = 0;
+	if(buffer == NULL || tempf == NULL) { err = 100; goto exception; }
+
 	size_t floats_read = 0;
-	parse_state_t parse_state = start;
-	while(!eof) {
-		//printf("State: %d, f=%2.6f, buffer[%d]=%c%s\n", parse_state, f, buffer_idx, buffer[buffer_idx], (buffer[buffer_idx]?"":" (EOF)"));
-		// Fill buffer if required
-		if(buffer_idx == buffer_len && c != 0x00) {
-			buffer_idx = 0;
-			buffer_len = fread(buffer, 1, BUFFERSIZE, csvFile);
-			if(buffer_len < BUFFERSIZE ) { buffer[buffer_len] = 0x00; }
-			//printf("Read %d bytes\n", buffer_len);
-		}
+	// Position in the file, for error messages
+	size_t row = 1, col = 1;
+	// Bytes of an incomplete field carried over from the previous chunk
+	size_t carried = 0;
+	uint8_t last_chunk = 0;
+	while(!last_chunk) {
+		size_t len = carried + fread(buffer + carried, 1, BUFFERSIZE - carried, csvFile);
+		last_chunk = (len < BUFFERSIZE);
 
-		// process one character
-		switch(parse_state){
-			// State for starting parsing
-			case start:
-				if(buffer[buffer_idx] == 0x00) { eof = 1; break; }
-				f = 0.00;
-				is_negative = 0;
-				exponent = 0;
-				negative_exponent = 0;
-				pos_after_point = 0;
-				parse_state = integer;
-				break;
-
-			// State entered before any special character
-			case integer:
-				c = buffer[buffer_idx];
-				if(c >= '0' && c <= '9'){ f = f*10 + (int8_t)(c-'0'); } // got new digit
-				else if(c == '-') { is_negative = 1; }	// got a sign
-				else if(c == '+') { is_negative = 0; }
-				else if(c == '.') { parse_state = fractional; } // time to go to fractional part
-				else if(c == 'e' || c == 'E') { parse_state = exponent_state; } // time to read the exponent
-				else if(c == ',' || c=='\n' || c == 0x00) { parse_state = next; if(c==0x00) {break;} } // time to wrap-up this float
-				else { err = 1; goto exception; } // everything else is an error
-				buffer_idx++;
-			break;
-
-			// State entered after after reading '.'
-			// This character may not be present on all floats
-			case fractional:
-				c = buffer[buffer_idx];
-				if(c >= '0' && c <= '9'){ // got new digit
-					pos_after_point++;
-					f += ((float)(c-'0')) / power(10.0, pos_after_point);
-				}
-				else if(c == 'e' || c == 'E')  { parse_state = exponent_state;} // time to get exponent
-				else if(c == ',' || c=='\n' || c == 0x00) { parse_state = next; if(c==0x00) {break;} } // time to wrap-up this float
-				else { err = 2; goto exception; } // everything else is an error
-				buffer_idx++;
-			break;
-
-			// State entered when ready to read the exponent
-			case exponent_state:
-				c = buffer[buffer_idx];
-				if(c >= '0' && c <= '9'){ // got new digit
-					exponent = exponent*10 + ((int8_t)(c-'0'));
-				}
-				else if(c == '-') { negative_exponent = 1; }
-				else if(c == '+') { negative_exponent = 0; }
-				else if(c == ',' || c=='\n' || c == 0x00) { // time to wrap up
-					if(negative_exponent) { exponent = -1*(exponent+1); }
-					f *= power(10.0, exponent);
-					parse_state = next;
-				}
-				else { err = 2; goto exception; }
-				buffer_idx++;
-			break;
-
-			// State entered when a float has been parsed
-			case next:
-				f *= (is_negative) ? -1.0 : 1.0;
-				// Check we haven't read too many floats before writing a new one
-				if(floats_read < alloc_floats){
-					// Store float
-					tempf[floats_read] = f;
-					floats_read++;
-				}
-				else { err = 80; goto exception; }
-
-				// Ready to get new float
-				parse_state = start;
-				// Set eof if needed
-				eof = (c == 0x00);
-				//if(eof) { printf("EOF reached!\n"); }
-
-			break;
-
-			default:
-				err = 100;
-				goto exception;
-			break;
+		// Only complete fields are parsed; The rest of the chunk is kept for the next read
+		size_t end = len;
+		if(last_chunk) { buffer[len] = 0x00; }
+		else {
+			while(end > 0 && buffer[end-1] != ',' && buffer[end-1] != '\n') { end--; }
+			if(end == 0) {
+				printf("Error in matrixFromCSV: %s:%lu:%lu: Field longer than %d bytes.\n", path, (unsigned long)row, (unsigned long)col, BUFFERSIZE);
+				err = 2; goto exception;
+			}
 		}
+
+		size_t count;
+		err = csvParseRange(path, buffer, buffer + end, last_chunk, tempf + floats_read, alloc_floats - floats_read, &count, &row, &col);
+		floats_read += count;
+		if(err) { goto exception; }
+
+		carried = len - end;
+		memmove(buffer, buffer + end, carried);
 	}
 
 	// Check if we read as many floats as we anticipated
-	if(floats_read != mat->h * mat->w) {
-		err = 127;
-		printf("Error: Read %d floats, not %d!\n", floats_read,  mat->h * mat->w);
-		goto exception;
+	if(floats_read != alloc_floats) {
+		printf("Error in matrixFromCSV: %s: Read %lu floats, not %lu!\n", path, (unsigned long)floats_read, (unsigned long)alloc_floats);
+		err = 127; goto exception;
 	}
 
 	// Wrap-up matrix
+	mat->h = height;
+	mat->w = width;
+	mat->d = tempf;
+	fclose(csvFile);
+	free(buffer);
+	return 0;
+
+exception:
+	free(tempf);
+	free(buffer);
+	fclose(csvFile);
+	return err;
+}
+
+
+// Number of bytes equal to `c` in p[0..n)
+static size_t csvCountByte(const char *p, size_t n, char c) {
+	size_t count = 0, i = 0;
+#ifndef SERIAL
+	uint8x16_t target = vdupq_n_u8(c);
+	while(i + 16 <= n) {
+		// Matches are accumulated in 8 bit lanes for up to 255 blocks
+		size_t blocks = (n - i) / 16;
+		if(blocks > 255) { blocks = 255; }
+		uint8x16_t acc = vdupq_n_u8(0);
+		for(size_t b = 0; b < blocks; b++, i += 16) { acc = vsubq_u8(acc, vceqq_u8(vld1q_u8((const uint8_t*)p + i), target)); }
+		count += vaddlvq_u8(acc);
+	}
+#endif
+	for(; i < n; i++) { count += (p[i] == c); }
+	return count;
+}
+
+// One byte range of a file that is loaded by `matrixFromCSVParallel`; Starts at a line
+typedef struct CSV_RANGE_ST {
+	const char *path;
+	const char *begin, *end;
+	size_t values, lines;	// counted before parsing
+	float32_t *out;
+	size_t row;				// first line of the range
+	uint8_t last;			// set for the range that ends the file
+	int ret;
+} csv_range_t;
+
+// Counts the values and lines of a range the way `csvParseRange` parses them
+static void *csvCountRange(void *arg) {
+	csv_range_t *range = (csv_range_t*)arg;
+	const char *p = range->begin;
+	range->values = 0;
+	range->lines = 0;
+	while(p < range->end) {
+		const char *line_end = (const char*)memchr(p, '\n', range->end - p);
+		if(line_end == NULL) { line_end = range->end; }
+
+		const char *last = (line_end > p && line_end[-1] == '\r') ? line_end - 1 : line_end;
+		// A trailing ',' is not counted; `csvParseRange` reports it with its position
+		if(last > p) { range->values += 1 + csvCountByte(p, last - p, ',') - (last[-1] == ','); }
+		if(line_end < range->end) { range->lines++; }
+		p = line_end + 1;
+	}
+	return NULL;
+}
+
+static void *csvParseRangeThread(void *arg) {
+	csv_range_t *range = (csv_range_t*)arg;
+	size_t count, col = 1;
+	range->ret = csvParseRange(range->path, range->begin, range->end, range->last, range->out, range->values, &count, &range->row, &col);
+	if(!range->ret && count != range->values) { range->ret = 2; }
+	return NULL;
+}
+
+// Runs `func` for every range; Range 0 runs on the calling thread
+static void csvRunRanges(void *(*func)(void*), csv_range_t *ranges, size_t count) {
+	if(count == 0) { return; }
+#ifndef BAREMETAL
+	pthread_t pool[CSV_MAX_THREADS];
+	uint8_t started[CSV_MAX_THREADS] = { 0 };
+	for(size_t i = 1; i < count; i++) { started[i] = (pthread_create(&pool[i], NULL, func, &ranges[i]) == 0); }
+	func(&ranges[0]);
+	for(size_t i = 1; i < count; i++) {
+		if(started[i]) { pthread_join(pool[i], NULL); }
+		else { func(&ranges[i]); }
+	}
+#else
+	for(size_t i = 0; i < count; i++) { func(&ranges[i]); }
+#endif
+}
+
+int matrixFromCSVParallel(const char *path, size_t height, size_t width, size_t threads, matrix32f_t *mat) {
+#ifdef BAREMETAL
+	threads = 1;
+#endif
+	if(threads > CSV_MAX_THREADS) { threads = CSV_MAX_THREADS; }
+	if(threads <= 1) { return matrixFromCSV(path, height, width, mat); }
+	if(height == 0 || width == 0) { return 1; }
+
+	// The whole file is read so it can be split; Padded like the buffer of `matrixFromCSV`
+	FILE *csvFile = fopen(path, "rb");
+	if(csvFile == NULL) { return 30; }
+	fseek(csvFile, 0, SEEK_END);
+	long size = ftell(csvFile);
+	fseek(csvFile, 0, SEEK_SET);
+	if(size < 0) { fclose(csvFile); return 30; }
+
+	size_t alloc_floats = height * width;
+	char *buffer = (char*)calloc(size + 8, 1);
+	float32_t *tempf = (float32_t*)aligned_alloc(MATRIX_ALIGNMENT, matrixBytes(height, width));
+	int err = 0;
+	if(buffer == NULL || tempf == NULL) { err = 100; goto exception; }
+	if(fread(buffer, 1, size, csvFile) != (size_t)size) { err = 30; goto exception; }
+	// An empty file has no ranges (and fewer values than expected)
+	if(size == 0) { err = 127; goto exception; }
+
+	// Small files aren't worth splitting
+	if(threads > (size_t)size / CSV_MIN_RANGE_BYTES) { threads = size / CSV_MIN_RANGE_BYTES; }
+	if(threads == 0) { threads = 1; }
+
+	// Split at the first line break after every 1/threads of the file
+	csv_range_t ranges[CSV_MAX_THREADS];
+	const char *file_end = buffer + size;
+	const char *begin = buffer;
+	// `count` is bounded too, so that the compiler can tell `ranges` never overflows
+	size_t count = 0;
+	for(size_t i = 1; i <= threads && count < CSV_MAX_THREADS && begin < file_end; i++) {
+		const char *end = file_end;
+		if(i < threads) {
+			end = buffer + size*i/threads;
+			if(end < begin) { end = begin; }
+			end = (const char*)memchr(end, '\n', file_end - end);
+			end = (end == NULL) ? file_end : end + 1;
+		}
+		ranges[count].path = path;
+		ranges[count].begin = begin;
+		ranges[count].end = end;
+		ranges[count].last = (end == file_end);
+		count++;
+		begin = end;
+	}
+
+	// Count the values of every range to find where its output starts, then parse all ranges
+	csvRunRanges(csvCountRange, ranges, count);
+	size_t values = 0, lines = 0;
+	for(size_t i = 0; i < count; i++) {
+		ranges[i].out = tempf + values;
+		ranges[i].row = 1 + lines;
+		values += ranges[i].values;
+		lines += ranges[i].lines;
+	}
+	if(values != alloc_floats) {
+		printf("Error in matrixFromCSV: %s: Found %lu values, not %lu!\n", path, (unsigned long)values, (unsigned long)alloc_floats);
+		err = (values > alloc_floats) ? 80 : 127;
+		goto exception;
+	}
+
+	csvRunRanges(csvParseRangeThread, ranges, count);
+	for(size_t i = 0; i < count; i++) {
+		if(ranges[i].ret) { err = ranges[i].ret; goto exception; }
+	}
+
+	mat->h = height;
+	mat->w = width;
 	mat->d = tempf;
 	fclose(csvFile);
 	free(buffer);
 	return 0;
 
 exception:
-	//mat->d = NULL;
-	if(err != 1) { free(tempf); }
+	free(tempf);
 	free(buffer);
-    fclose(csvFile);
+	fclose(csvFile);
 	return err;
 }
+
+
+#ifndef BAREMETAL
+// Shared by the workers of `matrixFromCSVBatch`
+typedef struct CSV_BATCH_ST {
+	csv_job_t *jobs;
+	size_t count;
+	size_t next;
+	pthread_mutex_t lock;
+} csv_batch_t;
+
+// Loads jobs until there are none left
+static void *csvBatchThread(void *arg) {
+	csv_batch_t *batch = (csv_batch_t*)arg;
+	while(1) {
+		pthread_mutex_lock(&batch->lock);
+		size_t i = batch->next++;
+		pthread_mutex_unlock(&batch->lock);
+		if(i >= batch->count) { break; }
+
+		csv_job_t *job = &batch->jobs[i];
+		job->ret = matrixFromCSV(job->path, job->h, job->w, job->mat);
+	}
+	return NULL;
+}
+#endif
+
+int matrixFromCSVBatch(csv_job_t *jobs, size_t count, size_t threads) {
+	if(threads > count) { threads = count; }
+	if(threads > CSV_MAX_THREADS) { threads = CSV_MAX_THREADS; }
+#ifndef BAREMETAL
+	if(threads > 1) {
+		csv_batch_t batch;
+		batch.jobs = jobs;
+		batch.count = count;
+		batch.next = 0;
+		pthread_mutex_init(&batch.lock, NULL);
+
+		// The calling thread is one of the workers
+		pthread_t pool[CSV_MAX_THREADS];
+		uint8_t started[CSV_MAX_THREADS] = { 0 };
+		for(size_t i = 1; i < threads; i++) { started[i] = (pthread_create(&pool[i], NULL, csvBatchThread, &batch) == 0); }
+		csvBatchThread(&batch);
+		for(size_t i = 1; i < threads; i++) {
+			if(started[i]) { pthread_join(pool[i], NULL); }
+		}
+		pthread_mutex_destroy(&batch.lock);
+	}
+	else
+#endif
+	{
+		for(size_t i = 0; i < count; i++) { jobs[i].ret = matrixFromCSV(jobs[i].path, jobs[i].h, jobs[i].w, jobs[i].mat); }
+	}
+
+	for(size_t i = 0; i < count; i++) {
+		if(jobs[i].ret) { return jobs[i].ret; }
+	}
+	return 0;
+}
@@ -1,22 +1,123 @@
-#ifdef DEBUG
-#include <stdio.h>
-#endif
-
+#include <stdio.h>  // snprintf
 #include <string.h> // memcpy
 
 #include "lstm.h"
 #include "csv.h"
+#include "bundle.h"
 
 // Calculates all gates and outputs of an LSTM cell
 inline void lstm_process(matrix32f_t *input, lstm_t *lstm);
 // This function is private; it is not available outside 'lstm.c'
 
+// Second half of `lstm_process`; expects input * W to be stored in the gates' scratchpads
+static void lstm_recurrent(lstm_t *lstm);
+
+// Fused version of `lstm_process` for cells created with LSTM_PACKED_WEIGHTS
+// If `xw` is not NULL it should point to the (packed) input * W row and `input` is not read.
+static void lstm_process_packed(matrix32f_t *input, const float32_t *xw, lstm_t *lstm);
+
+// Frees a parameter matrix; Parameters borrowed from a bundle are only detached
+static inline void lstmReleaseParameter(matrix32f_t *mat, lstm_t *lstm) {
+	if(lstm->borrowed_params) 	{ mat->d = NULL; }
+	else 						{ deleteMatrix(mat); }
+}
+
+// Converts the loaded float parameters to the layout/format selected by the cell's options
+static int lstmPrepareParameters(lstm_t *lstm);
+
+// Converts W, U and biases to fixed point (LSTM_FIXED_POINT) and frees the float matrices; W and U use the
+// smallest format that fits their values, biases are stored in the gates' format
+static int lstmFixParameters(lstm_t *lstm) {
+	matrix32f_t * const param_mat[3][4] = {
+		{ &lstm->f_w, &lstm->c_w, &lstm->i_w, &lstm->o_w },
+		{ &lstm->f_u, &lstm->c_u, &lstm->i_u, &lstm->o_u },
+		{ &lstm->f_bias, &lstm->c_bias, &lstm->i_bias, &lstm->o_bias }
+	};
+	matrix16q_t * const q16_mat[] = { lstm->w_q16, lstm->u_q16, lstm->bias_q16 };
+
+	for(uint8_t m = 0; m < 3; m++) {
+		for(uint8_t gate = 0; gate < 4; gate++) {
+			matrix32f_t *mat = param_mat[m][gate];
+			uint8_t int_bits = (m < 2) ? matrixIntBits16q(mat) : LSTM_Q16_GATE_INT_BITS;
+
+			if(newMatrix16q(mat->h, mat->w, int_bits, &q16_mat[m][gate])) {
+#ifdef DEBUG
+				printf("Error in lstmFixParameters: Failed to allocate fixed point matrix #%d.\n", m*4+gate);
+#endif
+				return 1;
+			}
+			matrixTo16q(mat, &q16_mat[m][gate]);
+			lstmReleaseParameter(mat, lstm);
+		}
+	}
+	return 0;
+}
+
+// Vector by Matrix Multiplication with the float, the quantized (LSTM_QUANTIZED_WEIGHTS) or the half precision
+// (LSTM_HALF_WEIGHTS) matrix
+static inline void lstmMultVecByMat(matrix32f_t *vec, matrix32f_t *mat, matrix8q_t *qmat, matrix16f_t *hmat, matrix32f_t *out, lstm_t *lstm) {
+	if(lstm->options & LSTM_QUANTIZED_WEIGHTS)	{ multVecByMat_q8(vec, qmat, out); }
+	else if(lstm->options & LSTM_HALF_WEIGHTS)	{ multVecByMat_f16w(vec, hmat, out); }
+	else 										{ multVecByMat(vec, mat, out); }
+}
+
+// In-place activations with the LUTs or the approximations (`lstmSetApproximations`)
+static inline void lstmSigmoid(matrix32f_t *mat, lstm_t *lstm) {
+	if(lstm->approx_activations)	{ sigmoidApprox(mat, NULL); }
+	else 							{ clampingLUT(mat, lstm->sigmoid_lut_ptr, NULL); }
+}
+static inline void lstmTanh(matrix32f_t *mat, lstm_t *lstm) {
+	if(lstm->approx_activations)	{ tanhApprox(mat, NULL); }
+	else 							{ clampingLUT(mat, lstm->tanh_lut_ptr, NULL); }
+}
+
+// Interleaves the gates' parameters into the packed matrices (LSTM_PACKED_WEIGHTS)
+static int lstmPackParameters(lstm_t *lstm);
+
+// Fixed point version of `lstm_process` (LSTM_FIXED_POINT); The input should be stored in `x_q`
+static void lstm_process_q16(lstm_t *lstm);
+
+// Concatenates the fixed point Hs of the input cells into `x_q`
+static inline void lstmConcat_q16(lstm_t *lstm) {
+	size_t len0 = lstm->h_q_in0_ptr->w * lstm->h_q_in0_ptr->h;
+	memcpy(lstm->x_q.d, lstm->h_q_in0_ptr->d, len0*sizeof(int16_t));
+	memcpy(lstm->x_q.d + len0, lstm->h_q_in1_ptr->d, (lstm->input_size - len0)*sizeof(int16_t));
+	lstm->x_q.int_bits = LSTM_Q16_STATE_INT_BITS;
+}
+
 // Initializes an LSTM cell, allocating the appropriate memory
 // Depending on the layer of the LSTM, additional operations will be required before `lstm` will be used
-int lstmCreate(size_t input_size, size_t hidden_size, uint8_t dir, lstm_t *lstm) {
+int lstmCreate(size_t input_size, size_t hidden_size, uint8_t dir, uint8_t options, lstm_t *lstm) {
 	lstm->input_size  = input_size;
 	lstm->hidden_size = hidden_size;
 	lstm->direction = dir;
+	lstm->options = options;
+
+	// Packed rows interleave the gates in groups of LSTM_PACK_WIDTH columns
+	if((options & LSTM_PACKED_WEIGHTS) && (hidden_size % LSTM_PACK_WIDTH)) {
+#ifdef DEBUG
+		printf("Error in create_lstm: hidden_size must be a multiple of %d for packed weights.\n", LSTM_PACK_WIDTH);
+#endif
+		return 2;
+	}
+	if((options & LSTM_PACKED_WEIGHTS) && (options & LSTM_QUANTIZED_WEIGHTS)) {
+#ifdef DEBUG
+		printf("Error in create_lstm: Packed weights can't be quantized.\n");
+#endif
+		return 3;
+	}
+	if((options & LSTM_FIXED_POINT) && (options & (LSTM_PACKED_WEIGHTS | LSTM_QUANTIZED_WEIGHTS))) {
+#ifdef DEBUG
+		printf("Error in create_lstm: Fixed point can't be combined with other weight options.\n");
+#endif
+		return 3;
+	}
+	if((options & LSTM_HALF_WEIGHTS) && (options & (LSTM_PACKED_WEIGHTS | LSTM_QUANTIZED_WEIGHTS | LSTM_FIXED_POINT))) {
+#ifdef DEBUG
+		printf("Error in create_lstm: Half precision weights can't be combined with other weight options.\n");
+#endif
+		return 3;
+	}
 
 	// We'll create an array of matrix32f_t pointers to initialize; All matrices are
 	// vectors of `input_size` length
@@ -28,6 +129,15 @@ int lstmCreate(size_t input_size, size_t hidden_size, uint8_t dir, lstm_t *lstm)
 	};
 
 
+	// The state and the scratchpads are carved out of a single arena, so a cell's per-frame memory is
+	// contiguous and every vector starts on its own cache line
+	if(matrixArenaCreate(6*matrixArenaBytes(1, hidden_size) + matrixArenaBytes(1, input_size), &lstm->arena)) {
+#ifdef DEBUG
+		printf("Error in create_lstm: Failed to allocate memory (arena).\n");
+#endif
+		return 1;
+	}
+
 	// Init matrices
 	size_t mat_w;
 	for(size_t i = 0; i < 7; i++) {
@@ -36,18 +146,19 @@ int lstmCreate(size_t input_size, size_t hidden_size, uint8_t dir, lstm_t *lstm)
 		// to "hide" extra memory from matrix_math functions when required.
 		// NOTE: Since 2 out of 6 cells don't need a large gp_scratchpad, 512*2 floats or 2KiB are unused.
 		mat_w = (i != 6) ? hidden_size : input_size;
-		if(newMatrix32f(1, mat_w, mat_to_init[i])) {
+		if(newMatrix32fIn(&lstm->arena, 1, mat_w, mat_to_init[i])) {
 #ifdef DEBUG
 			printf("Error in create_lstm: Failed to allocate memory (matrix %d).\n", i);
 #endif
+			matrixArenaDelete(&lstm->arena);
 			return 1;
 		}
 
 		// Hide extra memory from other functions
 		lstm->gp_scratchpad.w = hidden_size;
 		// note: `lstm_mid` or `lstm_out` will change this value for their runtime and revert it back
-		// to `hidden_size` before returning. Since `free()` is used for de-allocation, the width value
-		// can be safely changed to any arbitrary value.
+		// to `hidden_size` before returning. The arena owns the memory, so the width value can be
+		// safely changed to any arbitrary value.
 	}
 
 	// Clear both internal matrices
@@ -59,6 +170,7 @@ int lstmCreate(size_t input_size, size_t hidden_size, uint8_t dir, lstm_t *lstm)
 	lstm->h_in1_ptr = NULL;
 	lstm->sigmoid_lut_ptr = NULL;
 	lstm->tanh_lut_ptr = NULL;
+	lstm->approx_activations = 0;
 
 	// Same for parameters/biases
 	lstm->f_w.d = NULL; lstm->c_w.d = NULL;
@@ -69,6 +181,53 @@ int lstmCreate(size_t input_size, size_t hidden_size, uint8_t dir, lstm_t *lstm)
 
 	lstm->f_bias.d = NULL; lstm->c_bias.d = NULL;
 	lstm->i_bias.d = NULL; lstm->o_bias.d = NULL;
+
+	lstm->w_packed.d = NULL; lstm->u_packed.d = NULL; lstm->bias_packed.d = NULL;
+	lstm->borrowed_params = 0;
+
+	matrix8q_t* qparams[] = {
+		&lstm->f_wq, &lstm->c_wq, &lstm->i_wq, &lstm->o_wq,
+		&lstm->f_uq, &lstm->c_uq, &lstm->i_uq, &lstm->o_uq
+	};
+	for(uint8_t i = 0; i < 8; i++) { qparams[i]->d = NULL; qparams[i]->scale = NULL; }
+
+	matrix16f_t* hparams[] = {
+		&lstm->f_wh, &lstm->c_wh, &lstm->i_wh, &lstm->o_wh,
+		&lstm->f_uh, &lstm->c_uh, &lstm->i_uh, &lstm->o_uh
+	};
+	for(uint8_t i = 0; i < 8; i++) { hparams[i]->d = NULL; }
+
+	// Sequence buffers are allocated by `lstmReserveSequence`
+	lstm->x_seq.d = NULL; lstm->xw_seq.d = NULL; lstm->gemm_ws.d = NULL;
+	lstm->seq_capacity = 0;
+
+	// Fixed point parameters and state
+	for(uint8_t gate = 0; gate < 4; gate++) {
+		lstm->w_q16[gate].d = NULL; lstm->u_q16[gate].d = NULL;
+		lstm->bias_q16[gate].d = NULL; lstm->gate_q16[gate].d = NULL;
+	}
+	lstm->h_q.d = NULL; lstm->c_q.d = NULL; lstm->x_q.d = NULL; lstm->gp_q16.d = NULL;
+	lstm->h_q_in0_ptr = NULL; lstm->h_q_in1_ptr = NULL;
+	lstm->sigmoid_lut16_ptr = NULL; lstm->tanh_lut16_ptr = NULL;
+
+	if(options & LSTM_FIXED_POINT) {
+		matrix16q_t* q16_to_init[] = {
+			&lstm->h_q, &lstm->c_q, &lstm->gp_q16,
+			&lstm->gate_q16[0], &lstm->gate_q16[1], &lstm->gate_q16[2], &lstm->gate_q16[3], &lstm->x_q
+		};
+		for(uint8_t i = 0; i < 8; i++) {
+			if(newMatrix16q(1, (i != 7) ? hidden_size : input_size, LSTM_Q16_STATE_INT_BITS, q16_to_init[i])) {
+#ifdef DEBUG
+				printf("Error in create_lstm: Failed to allocate memory (fixed point matrix %d).\n", i);
+#endif
+				for(uint8_t j = 0; j < i; j++) { deleteMatrix16q(q16_to_init[j]); }
+				matrixArenaDelete(&lstm->arena);
+				return 1;
+			}
+		}
+		memset(lstm->h_q.d, 0, hidden_size*sizeof(int16_t));
+		memset(lstm->c_q.d, 0, hidden_size*sizeof(int16_t));
+	}
 	return 0;
 }
 
@@ -76,6 +235,33 @@ void lstmSetLUTs(lut32f_t *sigmoid_lut, lut32f_t *tanh_lut, lstm_t *lstm) {
 	// Store LUT Pointers
 	lstm->sigmoid_lut_ptr 	= sigmoid_lut;
 	lstm->tanh_lut_ptr 		= tanh_lut;
+	lstm->approx_activations = 0;
+}
+
+void lstmSetApproximations(lstm_t *lstm) {
+	lstm->sigmoid_lut_ptr 	= NULL;
+	lstm->tanh_lut_ptr 		= NULL;
+	lstm->approx_activations = 1;
+}
+
+void lstmSetLUTs_q16(lut16q_t *sigmoid_lut, lut16q_t *tanh_lut, lstm_t *lstm) {
+#ifdef DEBUG
+	if(sigmoid_lut->in_int_bits != LSTM_Q16_GATE_INT_BITS || tanh_lut->in_int_bits != LSTM_Q16_GATE_INT_BITS) {
+		printf("Warning in lstmSetLUTs_q16: The LUTs' input format should have %d integer bits.\n", LSTM_Q16_GATE_INT_BITS);
+	}
+#endif
+	lstm->sigmoid_lut16_ptr = sigmoid_lut;
+	lstm->tanh_lut16_ptr 	= tanh_lut;
+}
+
+// Clears H and C
+void lstmReset(lstm_t *lstm) {
+	clearMatrix(&lstm->h);
+	clearMatrix(&lstm->c);
+	if(lstm->options & LSTM_FIXED_POINT) {
+		memset(lstm->h_q.d, 0, lstm->hidden_size*sizeof(int16_t));
+		memset(lstm->c_q.d, 0, lstm->hidden_size*sizeof(int16_t));
+	}
 }
 
 int lstmLoadParameters(const char **param_paths, lstm_t *lstm){
@@ -86,20 +272,158 @@ int lstmLoadParameters(const char **param_paths, lstm_t *lstm){
 		&lstm->f_bias, &lstm->c_bias, &lstm->i_bias, &lstm->o_bias
 	};
 
-	size_t h;
+	csv_job_t jobs[12];
+	for(int i = 0; i < 12; i++) {
+		jobs[i].path = param_paths[i];
+		jobs[i].mat = param_mat[i];
+		jobs[i].w = lstm->hidden_size;
+		if(i < 4)		{ jobs[i].h = lstm->input_size; }
+		else if(i < 8) 	{ jobs[i].h = lstm->hidden_size;}
+		else			{ jobs[i].h = 1; }
+	}
+
+	// Parameters loaded before (or borrowed from a bundle) are released; the new ones are owned
+	for(int i = 0; i < 12; i++) { lstmReleaseParameter(param_mat[i], lstm); }
+	lstm->borrowed_params = 0;
+
 	int test;
+	if(test = matrixFromCSVBatch(jobs, 12, LSTM_LOAD_THREADS)) {
+#ifdef DEBUG
+		for(int i = 0; i < 12; i++) {
+			if(jobs[i].ret) { printf("Error in lstmLoadParameters: Failed to load matrix #%d, function returned: %d.\n", i, jobs[i].ret); }
+		}
+#endif
+		return test;
+	}
+
+	return lstmPrepareParameters(lstm);
+}
+
+int lstmLoadParametersBundle(bundle_t *bundle, const char *prefix, lstm_t *lstm) {
+	static const char * const suffix[] = {
+		"wf", "wc", "wi", "wo", "uf", "uc", "ui", "uo", "fbias", "cbias", "ibias", "obias"
+	};
+	matrix32f_t * const param_mat[] = {
+		&lstm->f_w, &lstm->c_w, &lstm->i_w, &lstm->o_w,
+		&lstm->f_u, &lstm->c_u, &lstm->i_u, &lstm->o_u,
+		&lstm->f_bias, &lstm->c_bias, &lstm->i_bias, &lstm->o_bias
+	};
+
+	// Parameters loaded before are released; From here on the matrices point into the bundle,
+	// so on errors every one of them is detached (not freed) by `lstmDelete`
+	for(int i = 0; i < 12; i++) { lstmReleaseParameter(param_mat[i], lstm); }
+	lstm->borrowed_params = 1;
+
+	char name[BUNDLE_NAME_LENGTH];
+	size_t h;
 	for(int i = 0; i < 12; i++) {
 		if(i < 4)		{ h = lstm->input_size; }
 		else if(i < 8) 	{ h = lstm->hidden_size;}
 		else			{ h = 1; }
 
-		if(test = matrixFromCSV(param_paths[i], h, lstm->hidden_size, param_mat[i])) {
+		if((size_t)snprintf(name, BUNDLE_NAME_LENGTH, "%s%s", prefix, suffix[i]) >= BUNDLE_NAME_LENGTH || bundleMatrix(bundle, name, param_mat[i])) {
+#ifdef DEBUG
+			printf("Error in lstmLoadParametersBundle: Failed to find matrix #%d (%s%s).\n", i, prefix, suffix[i]);
+#endif
+			for(int j = 0; j < 12; j++) { param_mat[j]->d = NULL; }
+			return 40;
+		}
+		if(param_mat[i]->h != h || param_mat[i]->w != lstm->hidden_size) {
 #ifdef DEBUG
-			printf("Error in lstmLoadParameters: Failed to load matrix #%d, function returned: %d.\n", i, test);
+			printf("Error in lstmLoadParametersBundle: %s is %dx%d, expected %dx%d.\n", name, param_mat[i]->h, param_mat[i]->w, h, lstm->hidden_size);
 #endif
-			return test;
+			for(int j = 0; j < 12; j++) { param_mat[j]->d = NULL; }
+			return 41;
 		}
 	}
+
+	return lstmPrepareParameters(lstm);
+}
+
+static int lstmPrepareParameters(lstm_t *lstm) {
+	matrix32f_t * const param_mat[] = {
+		&lstm->f_w, &lstm->c_w, &lstm->i_w, &lstm->o_w,
+		&lstm->f_u, &lstm->c_u, &lstm->i_u, &lstm->o_u
+	};
+	int test;
+
+	if(lstm->options & LSTM_PACKED_WEIGHTS) { return lstmPackParameters(lstm); }
+	if(lstm->options & LSTM_FIXED_POINT) { return lstmFixParameters(lstm); }
+
+	// Quantize W and U; biases stay in float
+	if(lstm->options & LSTM_QUANTIZED_WEIGHTS) {
+		matrix8q_t * const qparam_mat[] = {
+			&lstm->f_wq, &lstm->c_wq, &lstm->i_wq, &lstm->o_wq,
+			&lstm->f_uq, &lstm->c_uq, &lstm->i_uq, &lstm->o_uq
+		};
+		for(int i = 0; i < 8; i++) {
+			if(test = quantizeMatrix8q(param_mat[i], qparam_mat[i])) {
+#ifdef DEBUG
+				printf("Error in lstmLoadParameters: Failed to quantize matrix #%d, function returned: %d.\n", i, test);
+#endif
+				return test;
+			}
+			lstmReleaseParameter(param_mat[i], lstm);
+		}
+	}
+
+	// Convert W and U to half precision; biases stay in float
+	if(lstm->options & LSTM_HALF_WEIGHTS) {
+		matrix16f_t * const hparam_mat[] = {
+			&lstm->f_wh, &lstm->c_wh, &lstm->i_wh, &lstm->o_wh,
+			&lstm->f_uh, &lstm->c_uh, &lstm->i_uh, &lstm->o_uh
+		};
+		for(int i = 0; i < 8; i++) {
+			if(newMatrix16f(param_mat[i]->h, param_mat[i]->w, hparam_mat[i])) {
+#ifdef DEBUG
+				printf("Error in lstmLoadParameters: Failed to allocate half precision matrix #%d.\n", i);
+#endif
+				return 1;
+			}
+			matrixTo16f(param_mat[i], hparam_mat[i]);
+			lstmReleaseParameter(param_mat[i], lstm);
+		}
+	}
+	return 0;
+}
+
+// Interleaves the columns of the four gates' W, U and bias matrices into `w_packed`, `u_packed`
+// and `bias_packed`. Every row of a packed matrix holds LSTM_PACK_WIDTH columns of the forget gate,
+// then the same columns of the control, input and output gates, then the next LSTM_PACK_WIDTH
+// columns of the forget gate and so on. This way the fused kernel reads the weights for all gates
+// of a group of hidden units from one cache line. The separate matrices are freed afterwards.
+static int lstmPackParameters(lstm_t *lstm) {
+	size_t hidden = lstm->hidden_size;
+
+	matrix32f_t * const gate_mat[3][4] = {
+		{ &lstm->f_w, &lstm->c_w, &lstm->i_w, &lstm->o_w },
+		{ &lstm->f_u, &lstm->c_u, &lstm->i_u, &lstm->o_u },
+		{ &lstm->f_bias, &lstm->c_bias, &lstm->i_bias, &lstm->o_bias }
+	};
+	matrix32f_t * const packed_mat[] = { &lstm->w_packed, &lstm->u_packed, &lstm->bias_packed };
+	const size_t rows[] = { lstm->input_size, hidden, 1 };
+
+	for(uint8_t m = 0; m < 3; m++) {
+		if(newMatrix32f(rows[m], 4*hidden, packed_mat[m])) {
+#ifdef DEBUG
+			printf("Error in lstmPackParameters: Failed to allocate packed matrix #%d.\n", m);
+#endif
+			return 1;
+		}
+
+		float32_t *dest = packed_mat[m]->d;
+		for(size_t r = 0; r < rows[m]; r++) {
+			for(size_t col = 0; col < hidden; col += LSTM_PACK_WIDTH) {
+				for(uint8_t gate = 0; gate < 4; gate++) {
+					memcpy(dest, &(gate_mat[m][gate]->d[r*hidden + col]), LSTM_PACK_WIDTH*sizeof(float32_t));
+					dest += LSTM_PACK_WIDTH;
+				}
+			}
+		}
+
+		for(uint8_t gate = 0; gate < 4; gate++) { lstmReleaseParameter(gate_mat[m][gate], lstm); }
+	}
+	return 0;
 }
 
 // Frees memory of an LSTM Cell
@@ -110,7 +434,42 @@ void lstmDelete(lstm_t *lstm) {
 							&lstm->i_scratchpad, &lstm->o_scratchpad,
 		/* General Purp. */ &lstm->gp_scratchpad
 	};
-	for(uint8_t i = 0; i < 7; i++) { deleteMatrix(mat_to_del[i]); }
+	// Allocated in the arena; Released all together below
+	for(uint8_t i = 0; i < 7; i++) { mat_to_del[i]->d = NULL; }
+	matrixArenaDelete(&lstm->arena);
+
+	// Parameters; matrices that were never loaded (or were packed) are NULL
+	matrix32f_t* param_to_del[] = {
+		&lstm->f_w, &lstm->c_w, &lstm->i_w, &lstm->o_w,
+		&lstm->f_u, &lstm->c_u, &lstm->i_u, &lstm->o_u,
+		&lstm->f_bias, &lstm->c_bias, &lstm->i_bias, &lstm->o_bias
+	};
+	for(uint8_t i = 0; i < 12; i++) { lstmReleaseParameter(param_to_del[i], lstm); }
+	deleteMatrix(&lstm->w_packed); deleteMatrix(&lstm->u_packed); deleteMatrix(&lstm->bias_packed);
+
+	matrix8q_t* qparam_to_del[] = {
+		&lstm->f_wq, &lstm->c_wq, &lstm->i_wq, &lstm->o_wq,
+		&lstm->f_uq, &lstm->c_uq, &lstm->i_uq, &lstm->o_uq
+	};
+	for(uint8_t i = 0; i < 8; i++) { deleteMatrix8q(qparam_to_del[i]); }
+
+	matrix16f_t* hparam_to_del[] = {
+		&lstm->f_wh, &lstm->c_wh, &lstm->i_wh, &lstm->o_wh,
+		&lstm->f_uh, &lstm->c_uh, &lstm->i_uh, &lstm->o_uh
+	};
+	for(uint8_t i = 0; i < 8; i++) { deleteMatrix16f(hparam_to_del[i]); }
+
+	for(uint8_t gate = 0; gate < 4; gate++) {
+		deleteMatrix16q(&lstm->w_q16[gate]); deleteMatrix16q(&lstm->u_q16[gate]);
+		deleteMatrix16q(&lstm->bias_q16[gate]); deleteMatrix16q(&lstm->gate_q16[gate]);
+	}
+	deleteMatrix16q(&lstm->h_q); deleteMatrix16q(&lstm->c_q);
+	deleteMatrix16q(&lstm->x_q); deleteMatrix16q(&lstm->gp_q16);
+
+	deleteMatrix(&lstm->x_seq);
+	deleteMatrix(&lstm->xw_seq);
+	deleteMatrix(&lstm->gemm_ws);
+	lstm->seq_capacity = 0;
 }
 
 // Configures `lstm0` to use `lstm_in0`'s and `lstm_in1`'s Hs as inputs
@@ -121,6 +480,8 @@ void lstmConnect(lstm_t *lstm0, lstm_t *lstm_in0, lstm_t *lstm_in1) {
 #endif
 	lstm0->h_in0_ptr = &lstm_in0->h;
 	lstm0->h_in1_ptr = &lstm_in1->h;
+	lstm0->h_q_in0_ptr = &lstm_in0->h_q;
+	lstm0->h_q_in1_ptr = &lstm_in1->h_q;
 }
 
 // Executes code for LSTMs of input layer (layer 0)
@@ -141,6 +502,13 @@ void lstm_mid(lstm_t *lstm) {
 	if(lstm->h.d == NULL || lstm->c.d == NULL) { printf("Error in lstm: lstm->h->d == NULL || lstm->c->d == NULL\n"); return; }
 	if((lstm->h_in0_ptr == NULL) || (lstm->h_in1_ptr == NULL)) { printf("Error in lstm: (lstm->h_in0 == NULL) || (lstm->h_in1 == NULL)\n"); return; }
 #endif
+	// Concatenate the input cells' fixed point Hs directly
+	if(lstm->options & LSTM_FIXED_POINT) {
+		lstmConcat_q16(lstm);
+		lstm_process_q16(lstm);
+		return;
+	}
+
 	// Un-hide `gp_scratchpad` extra memory
 	lstm->gp_scratchpad.w = lstm->input_size;
 
@@ -161,6 +529,14 @@ void lstm_out(lstm_t *lstm, matrix32f_t *output){
 	if((lstm->h_in0_ptr == NULL) || (lstm->h_in1_ptr == NULL)) { printf("Error in lstm_out: (lstm->h_in0 == NULL) || (lstm->h_in1 == NULL)\n"); return; }
 #endif
 
+	// Concatenate the input cells' fixed point Hs directly
+	if(lstm->options & LSTM_FIXED_POINT) {
+		lstmConcat_q16(lstm);
+		lstm_process_q16(lstm);
+		memcpy(output->d + ((lstm->direction == 0) ? 0 : lstm->hidden_size), lstm->h.d, sizeof(float32_t) * lstm->hidden_size);
+		return;
+	}
+
 	// Un-hide `gp_scratchpad` extra memory
 	lstm->gp_scratchpad.w = lstm->input_size;
 
@@ -175,47 +551,186 @@ void lstm_out(lstm_t *lstm, matrix32f_t *output){
 	memcpy(output->d + out_offset, lstm->h.d, sizeof(float32_t) * lstm->hidden_size);
 }
 
+// Allocates the buffers of `lstm_in_sequence` for up to `max_T` frames, including the workspace of its
+// matrix multiplication, so that it never allocates; Replaces buffers reserved before. Returns 0 on success.
+int lstmReserveSequence(size_t max_T, lstm_t *lstm) {
+#ifdef DEBUG
+	if(lstm == NULL) { printf("Error in lstmReserveSequence: lstm == NULL\n"); return 1; }
+	if(max_T == 0) { printf("Error in lstmReserveSequence: max_T == 0\n"); return 1; }
+#endif
+	deleteMatrix(&lstm->x_seq);
+	deleteMatrix(&lstm->xw_seq);
+	deleteMatrix(&lstm->gemm_ws);
+	lstm->seq_capacity = 0;
+
+	// Per gate products are (max_T x input) * (input x hidden); the packed one is 4 times wider
+	size_t ws_floats = matrixMultiplyWsFloats(max_T, 4*lstm->hidden_size, lstm->input_size);
+	if(newMatrix32f(max_T, lstm->input_size, &lstm->x_seq) || newMatrix32f(max_T, 4*lstm->hidden_size, &lstm->xw_seq) ||
+	   newMatrix32f(1, (ws_floats > 0) ? ws_floats : 1, &lstm->gemm_ws)) {
+#ifdef DEBUG
+		printf("Error in lstmReserveSequence: Failed to allocate sequence buffers.\n");
+#endif
+		deleteMatrix(&lstm->x_seq);
+		deleteMatrix(&lstm->xw_seq);
+		deleteMatrix(&lstm->gemm_ws);
+		return 1;
+	}
+	lstm->seq_capacity = max_T;
+	return 0;
+}
+
+// Frames `t0` to `t0 + T - 1` of `lstm_in_sequence`; T <= seq_capacity
+static void lstmSequenceChunk(matrix32f_t *frames, size_t t0, size_t T, lstm_t *lstm, matrix32f_t *output) {
+	size_t hidden = lstm->hidden_size;
+	lstm->x_seq.h = T;
+	lstm->xw_seq.h = T;
+
+	// Gather frames into one T x input_size matrix
+	for(size_t t = 0; t < T; t++) {
+		memcpy(&(lstm->x_seq.d[t*lstm->input_size]), frames[t0 + t].d, lstm->input_size*sizeof(float32_t));
+	}
+
+	// X * W for all frames; packed W gives gate-interleaved rows, otherwise the four gates
+	// are stored one after the other in each row of `xw_seq`
+	matrix32f_t xw_gate;
+	if(lstm->options & LSTM_PACKED_WEIGHTS) {
+		xw_gate = lstm->xw_seq;
+		xw_gate.w = 4*hidden;
+		matrixMultiplyWs(&lstm->x_seq, &lstm->w_packed, &xw_gate, lstm->gemm_ws.d);
+	}
+	else {
+		matrix32f_t *gate_w[] = { &lstm->f_w, &lstm->c_w, &lstm->i_w, &lstm->o_w };
+		// Use a T x hidden_size matrix for each gate, stored in the first T*hidden_size*4 floats
+		xw_gate.h = T;
+		xw_gate.w = hidden;
+		for(uint8_t gate = 0; gate < 4; gate++) {
+			xw_gate.d = lstm->xw_seq.d + gate*T*hidden;
+			matrixMultiplyWs(&lstm->x_seq, gate_w[gate], &xw_gate, lstm->gemm_ws.d);
+		}
+	}
+
+	// Recurrence
+	matrix32f_t *scratchpad[] = { &lstm->f_scratchpad, &lstm->c_scratchpad, &lstm->i_scratchpad, &lstm->o_scratchpad };
+	for(size_t step = 0; step < T; step++) {
+		size_t t = (lstm->direction == 0) ? step : T - step - 1;
+
+		if(lstm->options & LSTM_PACKED_WEIGHTS) {
+			lstm_process_packed(NULL, &(lstm->xw_seq.d[t*4*hidden]), lstm);
+		}
+		else {
+			for(uint8_t gate = 0; gate < 4; gate++) {
+				memcpy(scratchpad[gate]->d, &(lstm->xw_seq.d[(gate*T + t)*hidden]), hidden*sizeof(float32_t));
+			}
+			lstm_recurrent(lstm);
+		}
+
+		if(output != NULL) { memcpy(&(output->d[(t0 + t)*hidden]), lstm->h.d, hidden*sizeof(float32_t)); }
+	}
+}
+
+// Executes a whole sequence of `T` frames on an input layer LSTM.
+// Since input * W doesn't depend on the recurrence, it is calculated for `seq_capacity` frames at a time
+// with one matrix multiplication; only h * U is calculated step by step. Frames are given in time order
+// and are walked backwards when `lstm->direction` is 1. If `output` is not NULL (T x hidden_size),
+// the H of every step is stored in the row of the frame it was calculated for.
+void lstm_in_sequence(matrix32f_t *frames, size_t T, lstm_t *lstm, matrix32f_t *output) {
+#ifdef DEBUG
+	if(lstm == NULL) { printf("Error in lstm_in_sequence: lstm == NULL\n"); return; }
+	if(lstm->h.d == NULL || lstm->c.d == NULL) { printf("Error in lstm_in_sequence: lstm->h->d == NULL || lstm->c->d == NULL\n"); return; }
+	if((lstm->h_in0_ptr != NULL) || (lstm->h_in1_ptr != NULL)) { printf("Warning in lstm_in_sequence: h_in0/1 are not NULL.\n"); return; }
+	if(output != NULL && (output->h != T || output->w != lstm->hidden_size)) { printf("Error in lstm_in_sequence: (output->h != T || output->w != hidden_size)\n"); return; }
+#endif
+	if(T == 0) { return; }
+	size_t hidden = lstm->hidden_size;
+
+	// There's no quantized/fixed point/half precision matrix multiplication and without reserved
+	// buffers there's nowhere to batch frames; process the frames one by one
+	if((lstm->options & (LSTM_QUANTIZED_WEIGHTS | LSTM_FIXED_POINT | LSTM_HALF_WEIGHTS)) || lstm->seq_capacity == 0) {
+		for(size_t step = 0; step < T; step++) {
+			size_t t = (lstm->direction == 0) ? step : T - step - 1;
+			lstm_process(&frames[t], lstm);
+			if(output != NULL) { memcpy(&(output->d[t*hidden]), lstm->h.d, hidden*sizeof(float32_t)); }
+		}
+		return;
+	}
+
+	// Chunks are visited in processing order; backwards from the last frame for direction 1
+	for(size_t done = 0; done < T; ) {
+		size_t n = (T - done < lstm->seq_capacity) ? T - done : lstm->seq_capacity;
+		size_t t0 = (lstm->direction == 0) ? done : T - done - n;
+		lstmSequenceChunk(frames, t0, n, lstm, output);
+		done += n;
+	}
+}
+
 void lstm_process(matrix32f_t *input, lstm_t *lstm) {
+	if(lstm->options & LSTM_PACKED_WEIGHTS) { lstm_process_packed(input, NULL, lstm); return; }
+	if(lstm->options & LSTM_FIXED_POINT) {
+		lstm->x_q.int_bits = LSTM_Q16_INPUT_INT_BITS;
+		matrixTo16q(input, &lstm->x_q);
+		lstm_process_q16(lstm);
+		return;
+	}
+
 	// Input * W is stored in `X_scratchpad`, depending on the gate.
 	// Note that in some cases `gp_scratchpad` == `input` (arg); a
 	// All Input multiplications should be completed before overwriting `gp_scratchpad`
 
 	// Do input multiplications
-	multVecByMat(input, &lstm->f_w, 	&lstm->f_scratchpad);
-	multVecByMat(input, &lstm->c_w, 	&lstm->c_scratchpad);
-	multVecByMat(input, &lstm->i_w, 	&lstm->i_scratchpad);
-	multVecByMat(input, &lstm->o_w, 	&lstm->o_scratchpad);
+	lstmMultVecByMat(input, &lstm->f_w, &lstm->f_wq, &lstm->f_wh, &lstm->f_scratchpad, lstm);
+	lstmMultVecByMat(input, &lstm->c_w, &lstm->c_wq, &lstm->c_wh, &lstm->c_scratchpad, lstm);
+	lstmMultVecByMat(input, &lstm->i_w, &lstm->i_wq, &lstm->i_wh, &lstm->i_scratchpad, lstm);
+	lstmMultVecByMat(input, &lstm->o_w, &lstm->o_wq, &lstm->o_wh, &lstm->o_scratchpad, lstm);
 	// (gp_scratchpad can be overwritten now)
 
+	lstm_recurrent(lstm);
+}
+
+static void lstm_recurrent(lstm_t *lstm) {
 	// Hide `gp_scratchpad` extra memory (see `lstmCreate`)
 	// This line has no effect when executed from within `lstm_in`
 	lstm->gp_scratchpad.w = lstm->hidden_size;
 
 	matrix32f_t *gp_scratchpad = &lstm->gp_scratchpad;
 
-	// Forget Gate
-	multVecByMat(&lstm->h, 			&lstm->f_u, 	gp_scratchpad);
-	matrixSum(&lstm->f_scratchpad,	gp_scratchpad, 	NULL); // (input * w) += (h * u)
-	matrixSum(&lstm->f_scratchpad, 	&lstm->f_bias, 	NULL); // += bias
-	clampingLUT(&lstm->f_scratchpad, lstm->sigmoid_lut_ptr, NULL);
-
-	// Control Gate
-	multVecByMat(&lstm->h, 			&lstm->c_u, 	gp_scratchpad);
-	matrixSum(&lstm->c_scratchpad,	gp_scratchpad, 	NULL); // (input * w) += (h * u)
-	matrixSum(&lstm->c_scratchpad, 	&lstm->c_bias, 	NULL); // += bias
-	clampingLUT(&lstm->c_scratchpad, lstm->tanh_lut_ptr, NULL);
-
-	// Input Gate
-	multVecByMat(&lstm->h, 			&lstm->i_u, 	gp_scratchpad);
-	matrixSum(&lstm->i_scratchpad,	gp_scratchpad, 	NULL); // (input * w) += (h * u)
-	matrixSum(&lstm->i_scratchpad, 	&lstm->i_bias, 	NULL); // += bias
-	clampingLUT(&lstm->i_scratchpad, lstm->tanh_lut_ptr, NULL);
-
-	// Output Gate
-	multVecByMat(&lstm->h, 			&lstm->o_u, 	gp_scratchpad);
-	matrixSum(&lstm->o_scratchpad,	gp_scratchpad, 	NULL); // (input * w) += (h * u)
-	matrixSum(&lstm->o_scratchpad, 	&lstm->o_bias, 	NULL); // += bias
-	clampingLUT(&lstm->o_scratchpad, lstm->sigmoid_lut_ptr, NULL);
+	// Float weights; (input * w + bias) is the starting value of each h * u product and the activation is
+	// applied as the outputs are stored (`multVecByMatEx`), instead of three more passes per gate
+	if(!(lstm->options & (LSTM_QUANTIZED_WEIGHTS | LSTM_HALF_WEIGHTS))) {
+		lut32f_t *sigmoid_lut = (lstm->approx_activations) ? NULL : lstm->sigmoid_lut_ptr;
+		lut32f_t *tanh_lut = (lstm->approx_activations) ? NULL : lstm->tanh_lut_ptr;
+		matrixSum(&lstm->f_scratchpad, &lstm->f_bias, NULL);
+		matrixSum(&lstm->c_scratchpad, &lstm->c_bias, NULL);
+		matrixSum(&lstm->i_scratchpad, &lstm->i_bias, NULL);
+		matrixSum(&lstm->o_scratchpad, &lstm->o_bias, NULL);
+		multVecByMatEx(&lstm->h, &lstm->f_u, &lstm->f_scratchpad, ACTIVATION_SIGMOID, sigmoid_lut, &lstm->f_scratchpad);
+		multVecByMatEx(&lstm->h, &lstm->c_u, &lstm->c_scratchpad, ACTIVATION_TANH, tanh_lut, &lstm->c_scratchpad);
+		multVecByMatEx(&lstm->h, &lstm->i_u, &lstm->i_scratchpad, ACTIVATION_TANH, tanh_lut, &lstm->i_scratchpad);
+		multVecByMatEx(&lstm->h, &lstm->o_u, &lstm->o_scratchpad, ACTIVATION_SIGMOID, sigmoid_lut, &lstm->o_scratchpad);
+	} else {
+		// Forget Gate
+		lstmMultVecByMat(&lstm->h, &lstm->f_u, &lstm->f_uq, &lstm->f_uh, gp_scratchpad, lstm);
+		matrixSum(&lstm->f_scratchpad,	gp_scratchpad, 	NULL); // (input * w) += (h * u)
+		matrixSum(&lstm->f_scratchpad, 	&lstm->f_bias, 	NULL); // += bias
+		lstmSigmoid(&lstm->f_scratchpad, lstm);
+
+		// Control Gate
+		lstmMultVecByMat(&lstm->h, &lstm->c_u, &lstm->c_uq, &lstm->c_uh, gp_scratchpad, lstm);
+		matrixSum(&lstm->c_scratchpad,	gp_scratchpad, 	NULL); // (input * w) += (h * u)
+		matrixSum(&lstm->c_scratchpad, 	&lstm->c_bias, 	NULL); // += bias
+		lstmTanh(&lstm->c_scratchpad, lstm);
+
+		// Input Gate
+		lstmMultVecByMat(&lstm->h, &lstm->i_u, &lstm->i_uq, &lstm->i_uh, gp_scratchpad, lstm);
+		matrixSum(&lstm->i_scratchpad,	gp_scratchpad, 	NULL); // (input * w) += (h * u)
+		matrixSum(&lstm->i_scratchpad, 	&lstm->i_bias, 	NULL); // += bias
+		lstmTanh(&lstm->i_scratchpad, lstm);
+
+		// Output Gate
+		lstmMultVecByMat(&lstm->h, &lstm->o_u, &lstm->o_uq, &lstm->o_uh, gp_scratchpad, lstm);
+		matrixSum(&lstm->o_scratchpad,	gp_scratchpad, 	NULL); // (input * w) += (h * u)
+		matrixSum(&lstm->o_scratchpad, 	&lstm->o_bias, 	NULL); // += bias
+		lstmSigmoid(&lstm->o_scratchpad, lstm);
+	}
 
 	// Update C and H
 	// ct = ct-1 .* ft + it .* ct
@@ -228,3 +743,203 @@ void lstm_process(matrix32f_t *input, lstm_t *lstm) {
 	hadamardProduct(&lstm->o_scratchpad, &lstm->c, &lstm->h);
 }
 
+
+static void lstm_process_q16(lstm_t *lstm) {
+	lut16q_t *gate_lut[] = { lstm->sigmoid_lut16_ptr, lstm->tanh_lut16_ptr, lstm->tanh_lut16_ptr, lstm->sigmoid_lut16_ptr };
+	matrix16q_t *gate = lstm->gate_q16;
+	matrix16q_t *gp = &lstm->gp_q16;
+
+	// Gates; (input * w) + (h * u) + bias, then the activation turns them to LUT's output format
+	for(uint8_t g = 0; g < 4; g++) {
+		gate[g].int_bits = LSTM_Q16_GATE_INT_BITS;
+		gp->int_bits = LSTM_Q16_GATE_INT_BITS;
+		multVecByMat_q16(&lstm->x_q, &lstm->w_q16[g], &gate[g]);
+		multVecByMat_q16(&lstm->h_q, &lstm->u_q16[g], gp);
+		matrixSum_q16(&gate[g], gp, NULL);
+		matrixSum_q16(&gate[g], &lstm->bias_q16[g], NULL);
+		clampingLUT_q16(&gate[g], gate_lut[g], NULL);
+	}
+
+	// ct = ct-1 .* ft + it .* ct
+	hadamardProduct_q16(&lstm->c_q, &gate[0], NULL);
+	gp->int_bits = LSTM_Q16_STATE_INT_BITS;
+	hadamardProduct_q16(&gate[2], &gate[1], gp);
+	matrixSum_q16(&lstm->c_q, gp, NULL);
+
+	// ht = ot .* ct
+	hadamardProduct_q16(&gate[3], &lstm->c_q, &lstm->h_q);
+	matrixFrom16q(&lstm->h_q, &lstm->h);
+}
+
+#ifndef SERIAL
+// NEON Code * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+// Calculates all four gates for LSTM_PACK_WIDTH hidden units at a time. For each group of units the
+// input and H are read once, the gates' pre-activations are accumulated in registers, bias and
+// activations are applied and C and H are updated before anything is written back to memory.
+static void lstm_process_packed(matrix32f_t *input, const float32_t *xw, lstm_t *lstm) {
+	size_t hidden = lstm->hidden_size;
+	size_t row_len = 4*hidden; // floats in a packed row
+
+	float32_t *h = lstm->h.d;
+	float32_t *c = lstm->c.d;
+	// H is read by every group so the new H is kept in a scratchpad until all groups are done
+	float32_t *h_next = lstm->f_scratchpad.d;
+
+	// Two sets of accumulators (even/odd rows) so consecutive FMAs don't depend on each other
+	float32x4_t vacc[2][4];
+	float32x4_t vin, vct, vht;
+
+	for(size_t g = 0; g < hidden; g += LSTM_PACK_WIDTH) {
+		const float32_t *bias = &(lstm->bias_packed.d[g*4]);
+		for(uint8_t gate = 0; gate < 4; gate++) {
+			vacc[0][gate] = vld1q_f32(bias + gate*LSTM_PACK_WIDTH);
+			vacc[1][gate] = vld1q_dup_f32(&fzero);
+		}
+
+		// input * W; if it was precalculated it only has to be loaded
+		size_t k;
+		if(xw != NULL) {
+			for(uint8_t gate = 0; gate < 4; gate++) { vacc[1][gate] = vld1q_f32(xw + g*4 + gate*LSTM_PACK_WIDTH); }
+		}
+		else {
+			const float32_t *x = input->d;
+			const float32_t *w = &(lstm->w_packed.d[g*4]);
+			for(k = 0; k+2 <= lstm->input_size; k += 2) {
+				vin = vld1q_dup_f32(x + k);
+				vacc[0][0] = vfmaq_f32(vacc[0][0], vin, vld1q_f32(w));
+				vacc[0][1] = vfmaq_f32(vacc[0][1], vin, vld1q_f32(w + 4));
+				vacc[0][2] = vfmaq_f32(vacc[0][2], vin, vld1q_f32(w + 8));
+				vacc[0][3] = vfmaq_f32(vacc[0][3], vin, vld1q_f32(w + 12));
+				w += row_len;
+
+				vin = vld1q_dup_f32(x + k+1);
+				vacc[1][0] = vfmaq_f32(vacc[1][0], vin, vld1q_f32(w));
+				vacc[1][1] = vfmaq_f32(vacc[1][1], vin, vld1q_f32(w + 4));
+				vacc[1][2] = vfmaq_f32(vacc[1][2], vin, vld1q_f32(w + 8));
+				vacc[1][3] = vfmaq_f32(vacc[1][3], vin, vld1q_f32(w + 12));
+				w += row_len;
+			}
+			for(k; k < lstm->input_size; k++) {
+				vin = vld1q_dup_f32(x + k);
+				for(uint8_t gate = 0; gate < 4; gate++) { vacc[0][gate] = vfmaq_f32(vacc[0][gate], vin, vld1q_f32(w + gate*4)); }
+				w += row_len;
+			}
+		}
+
+		// h * U
+		const float32_t *u = &(lstm->u_packed.d[g*4]);
+		for(k = 0; k+2 <= hidden; k += 2) {
+			vin = vld1q_dup_f32(h + k);
+			vacc[0][0] = vfmaq_f32(vacc[0][0], vin, vld1q_f32(u));
+			vacc[0][1] = vfmaq_f32(vacc[0][1], vin, vld1q_f32(u + 4));
+			vacc[0][2] = vfmaq_f32(vacc[0][2], vin, vld1q_f32(u + 8));
+			vacc[0][3] = vfmaq_f32(vacc[0][3], vin, vld1q_f32(u + 12));
+			u += row_len;
+
+			vin = vld1q_dup_f32(h + k+1);
+			vacc[1][0] = vfmaq_f32(vacc[1][0], vin, vld1q_f32(u));
+			vacc[1][1] = vfmaq_f32(vacc[1][1], vin, vld1q_f32(u + 4));
+			vacc[1][2] = vfmaq_f32(vacc[1][2], vin, vld1q_f32(u + 8));
+			vacc[1][3] = vfmaq_f32(vacc[1][3], vin, vld1q_f32(u + 12));
+			u += row_len;
+		}
+		for(k; k < hidden; k++) {
+			vin = vld1q_dup_f32(h + k);
+			for(uint8_t gate = 0; gate < 4; gate++) { vacc[0][gate] = vfmaq_f32(vacc[0][gate], vin, vld1q_f32(u + gate*4)); }
+			u += row_len;
+		}
+
+		for(uint8_t gate = 0; gate < 4; gate++) { vacc[0][gate] = vaddq_f32(vacc[0][gate], vacc[1][gate]); }
+
+		// Activations; same functions as in `lstm_process`
+		if(lstm->approx_activations) {
+			vacc[0][0] = vsigmoidApproxq_f32(vacc[0][0]);
+			vacc[0][1] = vtanhApproxq_f32(vacc[0][1]);
+			vacc[0][2] = vtanhApproxq_f32(vacc[0][2]);
+			vacc[0][3] = vsigmoidApproxq_f32(vacc[0][3]);
+		}
+		else {
+			vacc[0][0] = vclampingLUTq_f32(vacc[0][0], lstm->sigmoid_lut_ptr);	// forget
+			vacc[0][1] = vclampingLUTq_f32(vacc[0][1], lstm->tanh_lut_ptr);		// control
+			vacc[0][2] = vclampingLUTq_f32(vacc[0][2], lstm->tanh_lut_ptr);		// input
+			vacc[0][3] = vclampingLUTq_f32(vacc[0][3], lstm->sigmoid_lut_ptr);	// output
+		}
+
+		// ct = ct-1 .* ft + it .* ct
+		vct = vmulq_f32(vld1q_f32(c + g), vacc[0][0]);
+		vct = vfmaq_f32(vct, vacc[0][2], vacc[0][1]);
+		vst1q_f32(c + g, vct);
+
+		// ht = ot .* ct
+		vht = vmulq_f32(vacc[0][3], vct);
+		vst1q_f32(h_next + g, vht);
+	}
+
+	memcpy(h, h_next, hidden*sizeof(float32_t));
+
+	// Hide `gp_scratchpad` extra memory (see `lstmCreate`)
+	lstm->gp_scratchpad.w = hidden;
+}
+
+#else
+// Serial Code * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+static void lstm_process_packed(matrix32f_t *input, const float32_t *xw, lstm_t *lstm) {
+	size_t hidden = lstm->hidden_size;
+	size_t row_len = 4*hidden; // floats in a packed row
+
+	float32_t *h = lstm->h.d;
+	float32_t *c = lstm->c.d;
+	// H is read by every group so the new H is kept in a scratchpad until all groups are done
+	float32_t *h_next = lstm->f_scratchpad.d;
+
+	float32_t acc[4*LSTM_PACK_WIDTH];
+	float32_t ft, ct, it, ot;
+
+	for(size_t g = 0; g < hidden; g += LSTM_PACK_WIDTH) {
+		for(uint8_t a = 0; a < 4*LSTM_PACK_WIDTH; a++) { acc[a] = lstm->bias_packed.d[g*4 + a]; }
+
+		// input * W; skipped if it was precalculated
+		if(xw != NULL) {
+			for(uint8_t a = 0; a < 4*LSTM_PACK_WIDTH; a++) { acc[a] += xw[g*4 + a]; }
+		}
+		else {
+			const float32_t *x = input->d;
+			const float32_t *w = &(lstm->w_packed.d[g*4]);
+			for(size_t k = 0; k < lstm->input_size; k++) {
+				for(uint8_t a = 0; a < 4*LSTM_PACK_WIDTH; a++) { acc[a] += x[k] * w[a]; }
+				w += row_len;
+			}
+		}
+
+		// h * U
+		const float32_t *u = &(lstm->u_packed.d[g*4]);
+		for(size_t k = 0; k < hidden; k++) {
+			for(uint8_t a = 0; a < 4*LSTM_PACK_WIDTH; a++) { acc[a] += h[k] * u[a]; }
+			u += row_len;
+		}
+
+		for(uint8_t j = 0; j < LSTM_PACK_WIDTH; j++) {
+			if(lstm->approx_activations) {
+				ft = sigmoidApproxScalar(acc[j]);
+				ct = tanhApproxScalar(acc[j + LSTM_PACK_WIDTH]);
+				it = tanhApproxScalar(acc[j + 2*LSTM_PACK_WIDTH]);
+				ot = sigmoidApproxScalar(acc[j + 3*LSTM_PACK_WIDTH]);
+			}
+			else {
+				ft = clampingLUTScalar(acc[j], 						lstm->sigmoid_lut_ptr);
+				ct = clampingLUTScalar(acc[j + LSTM_PACK_WIDTH], 	lstm->tanh_lut_ptr);
+				it = clampingLUTScalar(acc[j + 2*LSTM_PACK_WIDTH], 	lstm->tanh_lut_ptr);
+				ot = clampingLUTScalar(acc[j + 3*LSTM_PACK_WIDTH], 	lstm->sigmoid_lut_ptr);
+			}
+
+			c[g+j] = c[g+j]*ft + it*ct;
+			h_next[g+j] = ot * c[g+j];
+		}
+	}
+
+	memcpy(h, h_next, hidden*sizeof(float32_t));
+
+	// Hide `gp_scratchpad` extra memory (see `lstmCreate`)
+	lstm->gp_scratchpad.w = hidden;
+}
+#endif
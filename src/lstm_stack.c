@@ -0,0 +1,312 @@
+#ifndef BAREMETAL
+#define _GNU_SOURCE // pthread_setaffinity_np
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#ifdef DEBUG
+#include <stdio.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h> // memcpy
+#include <time.h>
+
+#include "lstm_stack.h"
+#include "clock.h"
+
+#ifndef BAREMETAL
+#define STACK_LOCK(s)		pthread_mutex_lock(&(s)->lock)
+#define STACK_UNLOCK(s)		pthread_mutex_unlock(&(s)->lock)
+#define STACK_WAIT(s)		pthread_cond_wait(&(s)->progress_cond, &(s)->lock)
+#define STACK_SIGNAL(s)		pthread_cond_broadcast(&(s)->progress_cond)
+#else
+// Single worker; a ready cell always exists so no waiting is required
+#define STACK_LOCK(s)
+#define STACK_UNLOCK(s)
+#define STACK_WAIT(s)
+#define STACK_SIGNAL(s)
+#endif
+
+// Wall clock in ms; `clock()` counts the CPU time of all threads
+static double stackTimeMS() {
+#ifndef BAREMETAL
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+#else
+	return clockToMS(clock());
+#endif
+}
+
+// Processes all timesteps of the cells mapped to `thread`
+static void lstmStackWork(lstm_stack_t *stack, size_t thread);
+
+#ifndef BAREMETAL
+// Worker thread; pins itself to a core and waits for runs to be started until the stack is deleted
+static void *lstmStackThread(void *arg);
+#endif
+
+
+int lstmStackCreate(lstm_t *lstm_f, lstm_t *lstm_b, size_t layers, size_t threads, lstm_stack_t *stack) {
+#ifdef DEBUG
+	if(lstm_f == NULL || lstm_b == NULL) { printf("Error in lstmStackCreate: lstm_f == NULL || lstm_b == NULL\n"); return 1; }
+	if(layers == 0) { printf("Error in lstmStackCreate: layers == 0\n"); return 1; }
+#endif
+#ifdef BAREMETAL
+	threads = 1;
+#endif
+	if(threads == 0) { threads = 1; }
+	if(threads > LSTM_STACK_MAX_THREADS) { threads = LSTM_STACK_MAX_THREADS; }
+
+	size_t cells = 2*layers;
+	stack->layers = layers;
+	stack->threads = threads;
+	stack->seq_capacity = 0;
+	stack->run_time_ms = 0;
+
+	stack->cells        = (lstm_t**)malloc(cells * sizeof(lstm_t*));
+	stack->h_seq        = (matrix32f_t*)malloc(cells * sizeof(matrix32f_t));
+	stack->in_buf       = (matrix32f_t*)malloc(cells * sizeof(matrix32f_t));
+	stack->progress     = (size_t*)malloc(cells * sizeof(size_t));
+	stack->cell_time_ms = (float*)malloc(cells * sizeof(float));
+	if(!stack->cells || !stack->h_seq || !stack->in_buf || !stack->progress || !stack->cell_time_ms) {
+#ifdef DEBUG
+		printf("Error in lstmStackCreate: Failed to allocate memory.\n");
+#endif
+		free(stack->cells); free(stack->h_seq); free(stack->in_buf); free(stack->progress); free(stack->cell_time_ms);
+		stack->cells = NULL;
+		return 2;
+	}
+
+	for(size_t c = 0; c < cells; c++) {
+		stack->h_seq[c].d = NULL;
+		stack->in_buf[c].d = NULL;
+	}
+	for(size_t c = 0; c < cells; c++) {
+		stack->cells[c] = (c % 2 == 0) ? &lstm_f[c/2] : &lstm_b[c/2];
+		stack->cell_time_ms[c] = 0;
+
+		// The stack passes the inputs itself
+		stack->cells[c]->h_in0_ptr = NULL;
+		stack->cells[c]->h_in1_ptr = NULL;
+
+		if(c >= 2 && newMatrix32f(1, stack->cells[c]->input_size, &stack->in_buf[c])) {
+#ifdef DEBUG
+			printf("Error in lstmStackCreate: Failed to allocate input buffer (cell %d).\n", c);
+#endif
+			stack->threads = 0;
+			lstmStackDelete(stack);
+			return 2;
+		}
+	}
+	for(size_t i = 0; i < LSTM_STACK_MAX_THREADS; i++) { stack->thread_wait_ms[i] = 0; }
+
+#ifndef BAREMETAL
+	pthread_mutex_init(&stack->lock, NULL);
+	pthread_cond_init(&stack->progress_cond, NULL);
+	pthread_cond_init(&stack->run_cond, NULL);
+	stack->generation = 0;
+	stack->threads_done = 0;
+	stack->shutdown = 0;
+	stack->next_thread = 0;
+
+	// Start the pool
+	for(size_t i = 0; i < threads; i++) {
+		if(pthread_create(&stack->pool[i], NULL, lstmStackThread, stack)) {
+#ifdef DEBUG
+			printf("Error in lstmStackCreate: Failed to create thread %d.\n", i);
+#endif
+			stack->threads = i;
+			lstmStackDelete(stack);
+			return 3;
+		}
+	}
+#endif
+
+	return 0;
+}
+
+int lstmStackRun(lstm_stack_t *stack, matrix32f_t *frames, size_t T, matrix32f_t *outputs) {
+#ifdef DEBUG
+	if(stack == NULL || stack->cells == NULL) { printf("Error in lstmStackRun: stack is uninitialized.\n"); return 1; }
+	if(frames == NULL || outputs == NULL) { printf("Error in lstmStackRun: frames == NULL || outputs == NULL\n"); return 1; }
+#endif
+	size_t cells = 2*stack->layers;
+	if(T == 0) { return 0; }
+
+	// Grow the H history if required
+	if(T > stack->seq_capacity) {
+		for(size_t c = 0; c < cells; c++) {
+			deleteMatrix(&stack->h_seq[c]);
+			if(newMatrix32f(T, stack->cells[c]->hidden_size, &stack->h_seq[c])) {
+#ifdef DEBUG
+				printf("Error in lstmStackRun: Failed to allocate H history (cell %d).\n", c);
+#endif
+				stack->seq_capacity = 0;
+				return 2;
+			}
+		}
+		stack->seq_capacity = T;
+	}
+
+	// Reset cells
+	for(size_t c = 0; c < cells; c++) {
+		lstmReset(stack->cells[c]);
+		stack->progress[c] = 0;
+		stack->cell_time_ms[c] = 0;
+	}
+	for(size_t i = 0; i < stack->threads; i++) { stack->thread_wait_ms[i] = 0; }
+
+	stack->T = T;
+	stack->frames = frames;
+	stack->outputs = outputs;
+
+	double start_time = stackTimeMS();
+#ifndef BAREMETAL
+	// Start the run and wait for all workers to finish
+	pthread_mutex_lock(&stack->lock);
+	stack->threads_done = 0;
+	stack->generation++;
+	pthread_cond_broadcast(&stack->run_cond);
+	while(stack->threads_done < stack->threads) { pthread_cond_wait(&stack->run_cond, &stack->lock); }
+	pthread_mutex_unlock(&stack->lock);
+#else
+	lstmStackWork(stack, 0);
+#endif
+	stack->run_time_ms = stackTimeMS() - start_time;
+
+	return 0;
+}
+
+void lstmStackDelete(lstm_stack_t *stack) {
+	if(stack->cells == NULL) { return; }
+
+#ifndef BAREMETAL
+	if(stack->threads) {
+		pthread_mutex_lock(&stack->lock);
+		stack->shutdown = 1;
+		pthread_cond_broadcast(&stack->run_cond);
+		pthread_mutex_unlock(&stack->lock);
+		for(size_t i = 0; i < stack->threads; i++) { pthread_join(stack->pool[i], NULL); }
+
+		pthread_cond_destroy(&stack->run_cond);
+		pthread_cond_destroy(&stack->progress_cond);
+		pthread_mutex_destroy(&stack->lock);
+	}
+#endif
+
+	for(size_t c = 0; c < 2*stack->layers; c++) {
+		deleteMatrix(&stack->h_seq[c]);
+		deleteMatrix(&stack->in_buf[c]);
+	}
+	free(stack->cells);
+	free(stack->h_seq);
+	free(stack->in_buf);
+	free(stack->progress);
+	free(stack->cell_time_ms);
+	stack->cells = NULL;
+	stack->threads = 0;
+	stack->seq_capacity = 0;
+}
+
+#ifndef BAREMETAL
+static void *lstmStackThread(void *arg) {
+	lstm_stack_t *stack = (lstm_stack_t*)arg;
+	size_t generation = 0;
+
+	pthread_mutex_lock(&stack->lock);
+	size_t thread = stack->next_thread++;
+	pthread_mutex_unlock(&stack->lock);
+
+	// Thread i is pinned to core i
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	if(cores > 0) {
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		CPU_SET(thread % cores, &cpuset);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+	}
+
+	pthread_mutex_lock(&stack->lock);
+	while(1) {
+		while(stack->generation == generation && !stack->shutdown) { pthread_cond_wait(&stack->run_cond, &stack->lock); }
+		if(stack->shutdown) { break; }
+		generation = stack->generation;
+		pthread_mutex_unlock(&stack->lock);
+
+		lstmStackWork(stack, thread);
+
+		pthread_mutex_lock(&stack->lock);
+		stack->threads_done++;
+		pthread_cond_broadcast(&stack->run_cond);
+	}
+	pthread_mutex_unlock(&stack->lock);
+
+	return NULL;
+}
+#endif
+
+static void lstmStackWork(lstm_stack_t *stack, size_t thread) {
+	size_t cells = 2*stack->layers;
+	size_t T = stack->T;
+
+	// Timesteps left for this thread's cells
+	size_t remaining = 0;
+	for(size_t c = thread; c < cells; c += stack->threads) { remaining += T; }
+
+	STACK_LOCK(stack);
+	while(remaining) {
+		// Find one of our cells whose inputs for the next timestep are ready
+		size_t cell = cells;
+		size_t t = 0;
+		for(size_t c = thread; c < cells; c += stack->threads) {
+			size_t step = stack->progress[c];
+			if(step == T) { continue; }
+			t = (c % 2 == 0) ? step : T - step - 1;
+
+			// Layer k > 0 needs time t of layer k-1: step t of the forward cell and step T-t-1 of the backward one
+			if(c >= 2 && (stack->progress[c - 2 - c%2] <= t || stack->progress[c - 1 - c%2] < T - t)) { continue; }
+			cell = c;
+			break;
+		}
+
+		if(cell == cells) {
+			double wait_time = stackTimeMS();
+			STACK_WAIT(stack);
+			stack->thread_wait_ms[thread] += stackTimeMS() - wait_time;
+			continue;
+		}
+		STACK_UNLOCK(stack);
+
+		double cell_time = stackTimeMS();
+		lstm_t *lstm = stack->cells[cell];
+		size_t hidden = lstm->hidden_size;
+		if(cell < 2) {
+			lstm_in(&stack->frames[t], lstm);
+		}
+		else {
+			// Concatenate the previous layer's Hs at time t; own direction first
+			matrix32f_t h_own   = { 1, stack->cells[cell - 2]->hidden_size, NULL };
+			matrix32f_t h_other = { 1, stack->cells[cell - 2 + 1 - 2*(cell%2)]->hidden_size, NULL };
+			h_own.d   = &(stack->h_seq[cell - 2].d[t * h_own.w]);
+			h_other.d = &(stack->h_seq[cell - 2 + 1 - 2*(cell%2)].d[t * h_other.w]);
+			matrixConcat(&h_own, &h_other, &stack->in_buf[cell]);
+			lstm_in(&stack->in_buf[cell], lstm);
+		}
+		memcpy(&(stack->h_seq[cell].d[t * hidden]), lstm->h.d, hidden * sizeof(float32_t));
+
+		// Last layer; write to the output
+		if(cell >= cells - 2) {
+			size_t out_offset = (cell % 2 == 0) ? 0 : hidden;
+			memcpy(stack->outputs[t].d + out_offset, lstm->h.d, hidden * sizeof(float32_t));
+		}
+		stack->cell_time_ms[cell] += stackTimeMS() - cell_time;
+		remaining--;
+
+		STACK_LOCK(stack);
+		stack->progress[cell]++;
+		STACK_SIGNAL(stack);
+	}
+	STACK_UNLOCK(stack);
+}
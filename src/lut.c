@@ -1,4 +1,5 @@
 #include <stdio.h> // needed for File I/O
+#include <math.h>
 #include <arm_neon.h>
 
 #include "matrix.h"
@@ -25,32 +26,37 @@ uint8_t load32fLUT(lut32f_t *lut, const char *path) {
     float32_t mult_factor = *(float32_t*)(&buffer[4]);
     float32_t bias        = *(float32_t*)(&buffer[8]);
 
+    // Linear LUTs are flagged in the length field and hold a (value, slope) pair per entry
+    uint8_t mode = (lut_length & LUT_LINEAR_FLAG) ? LUT_LINEAR : LUT_NEAREST;
+    lut_length &= ~LUT_LINEAR_FLAG;
+    uint32_t floats = (mode == LUT_LINEAR) ? lut_length*2 : lut_length;
+
     // Allocate memory for the LUT's content
-    float32_t *data = malloc(sizeof(float32_t) * lut_length);
+    float32_t *data = malloc(sizeof(float32_t) * floats);
     if(data == NULL) { ret = 101; goto exception; }
     // Read floats; the buffer does not necessarily have all the floats
     uint32_t i;
     uint32_t buffer_idx = 4*3; // Skip the 32-bit fields in the file's header
 
-    for(i = 0; i < lut_length; i++) {
+    for(i = 0; i < floats; i++) {
         data[i] = *(float32_t*)(&buffer[buffer_idx]);
 
         buffer_idx += 4;
-        // Check the buffer didn't underflow
-        if(buffer_idx > 16*1024) { break; }
+        // Stop at the end of the buffer
+        if(buffer_idx >= 16*1024) { i++; break; }
     }
 
     // Check if more floats should be read from the file
-    while(i < lut_length) {
+    while(i < floats) {
         // Read the rest of the file into our buffer
         bytes_read = fread(buffer, 1, 16*1024, bin_file);
         buffer_idx = 0;
-        for(i; i < lut_length; i++) {
+        for(i; i < floats; i++) {
             data[i] = *(float32_t*)(&buffer[buffer_idx]);
 
             buffer_idx += 4;
-            // Check the buffer didn't underflow
-            if(buffer_idx > 16*1024) { break; }
+            // Stop at the end of the buffer
+            if(buffer_idx >= 16*1024) { i++; break; }
         }
     }
     fclose(bin_file);
@@ -60,6 +66,7 @@ uint8_t load32fLUT(lut32f_t *lut, const char *path) {
     lut->length         = lut_length;
     lut->mult_factor    = mult_factor;
     lut->bias           = bias;
+    lut->mode           = mode;
     lut->data = data;
 
     return 0;
@@ -70,6 +77,57 @@ exception:
     return ret;
 }
 
+uint8_t save32fLUT(lut32f_t *lut, const char *path) {
+#ifdef DEBUG
+    if(lut->data == NULL) { printf("Error in save32fLUT: The LUT is not initiated.\n"); return 1; }
+#endif
+    FILE *bin_file = fopen(path, "wb");
+    if(bin_file == NULL) { return 30; }
+
+    // Same header as `load32fLUT` reads; Linear tables are flagged in the length field
+    uint32_t length_field = lut->length | ((lut->mode == LUT_LINEAR) ? LUT_LINEAR_FLAG : 0);
+    size_t floats = lutFloats(lut);
+    uint8_t ret = 0;
+    if(fwrite(&length_field, sizeof(uint32_t), 1, bin_file) != 1 || fwrite(&lut->mult_factor, sizeof(float32_t), 1, bin_file) != 1 ||
+       fwrite(&lut->bias, sizeof(float32_t), 1, bin_file) != 1 || fwrite(lut->data, sizeof(float32_t), floats, bin_file) != floats) {
+        ret = 30;
+    }
+    fclose(bin_file);
+    return ret;
+}
+
+uint8_t lutGenerate(lut32f_t *lut, float32_t (*fn)(float32_t), float32_t min, float32_t max, uint32_t length, uint8_t mode) {
+#ifdef DEBUG
+    if(fn == NULL) { printf("Error in lutGenerate: fn is NULL.\n"); return 1; }
+    if(length < 2 || length >= LUT_LINEAR_FLAG) { printf("Error in lutGenerate: length should be within [2, 2^31).\n"); return 1; }
+    if(!(max > min)) { printf("Error in lutGenerate: The range should have max > min.\n"); return 1; }
+    if(mode != LUT_NEAREST && mode != LUT_LINEAR) { printf("Error in lutGenerate: Unknown mode %d.\n", mode); return 1; }
+#endif
+    float32_t *data = malloc(sizeof(float32_t) * length * ((mode == LUT_LINEAR) ? 2 : 1));
+    if(data == NULL) { return 101; }
+
+    // Entry i is fn(min + i*step); The input is mapped to the index range by x*mult_factor + bias
+    double step = ((double)max - min) / (length - 1);
+    lut->length      = length;
+    lut->mult_factor = (float32_t)(1.0 / step);
+    lut->bias        = (float32_t)(-min / step);
+    lut->mode        = mode;
+    lut->data        = data;
+
+    if(mode == LUT_NEAREST) {
+        for(uint32_t i = 0; i < length; i++) { data[i] = fn((float32_t)(min + i*step)); }
+    }
+    else {
+        // (value, slope) pairs; The slope is per entry, the last one is 0 as inputs beyond max are clamped
+        for(uint32_t i = 0; i < length; i++) { data[2*i] = fn((float32_t)(min + i*step)); }
+        for(uint32_t i = 0; i < length-1; i++) { data[2*i+1] = data[2*i+2] - data[2*i]; }
+        data[2*length-1] = 0;
+    }
+    return 0;
+}
+
+float32_t lutSigmoid(float32_t x) { return 1.0f / (1.0f + expf(-x)); }
+
 void deleteLUT32f(lut32f_t *lut) {
     if(lut->data != NULL) {
         free(lut->data);
@@ -77,6 +135,92 @@ void deleteLUT32f(lut32f_t *lut) {
     }
 }
 
+// Largest error of interpolating every `step`-th entry of `lut`, measured at all entries in between
+static float32_t lutLinearError(lut32f_t *lut, uint32_t step) {
+    float32_t max_error = 0, y0, y1, error;
+
+    for(uint32_t start = 0; start+step < lut->length; start += step) {
+        y0 = lut->data[start];
+        y1 = lut->data[start+step];
+        for(uint32_t j = 1; j < step; j++) {
+            error = y0 + (y1 - y0) * (float32_t)j / (float32_t)step - lut->data[start+j];
+            error = (error < 0) ? -error : error;
+            max_error = (error > max_error) ? error : max_error;
+        }
+    }
+    return max_error;
+}
+
+uint8_t lutToLinear(lut32f_t *lut, float32_t max_error, lut32f_t *out) {
+#ifdef DEBUG
+    if(lut->data == NULL) { printf("Error in lutToLinear: The LUT is not initiated.\n"); return 1; }
+    if(lut->mode != LUT_NEAREST) { printf("Error in lutToLinear: The LUT is already linear.\n"); return 1; }
+    if(lut->length < 2) { printf("Error in lutToLinear: The LUT should have at least 2 entries.\n"); return 1; }
+#endif
+    // Double the step while the error stays within bounds; The step should divide the LUT's range so that
+    // the last entry is kept and inputs are clamped at the same point, e.g. any power of 2 for 2^n + 1 entries
+    uint32_t last = lut->length - 1;
+    uint32_t step = 1;
+    while(step*2 <= last && last % (step*2) == 0 && lutLinearError(lut, step*2) <= max_error) { step *= 2; }
+
+    uint32_t length = last / step + 1;
+    float32_t *data = malloc(sizeof(float32_t) * length * 2);
+    if(data == NULL) { return 101; }
+
+    for(uint32_t i = 0; i < length; i++) {
+        data[2*i]   = lut->data[i*step];
+        data[2*i+1] = (i == length-1) ? 0 : lut->data[(i+1)*step] - lut->data[i*step];
+    }
+
+    // One entry of the new table covers `step` entries of the source
+    out->length      = length;
+    out->mult_factor = lut->mult_factor / step;
+    out->bias        = lut->bias / step;
+    out->mode        = LUT_LINEAR;
+    out->data        = data;
+    return 0;
+}
+
+uint8_t lutTo16q(lut32f_t *lut, uint8_t in_int_bits, uint8_t out_int_bits, uint8_t index_bits, lut16q_t *out) {
+#ifdef DEBUG
+    if(lut->data == NULL) { printf("Error in lutTo16q: The LUT is not initiated.\n"); return 1; }
+    if(index_bits == 0 || index_bits > 16) { printf("Error in lutTo16q: index_bits should be within [1, 16]\n"); return 1; }
+    if(in_int_bits > 15 || out_int_bits > 15) { printf("Error in lutTo16q: `int_bits > 15`\n"); return 1; }
+#endif
+    uint32_t length = (uint32_t)1 << index_bits;
+    uint8_t shift = 16 - index_bits;
+
+    int16_t *data = malloc(sizeof(int16_t) * length);
+    if(data == NULL) { return 101; }
+
+    int32_t raw;
+    float32_t ftemp;
+    for(uint32_t i = 0; i < length; i++) {
+        // Input value at the centre of the range of index i
+        raw = (int32_t)(i << shift) - 32768 + ((shift) ? (1 << (shift-1)) : 0);
+        ftemp = clampingLUTScalar((float32_t)raw * quant_div_factor[in_int_bits], lut);
+
+        ftemp = ftemp * quant_mul_factor[out_int_bits];
+        ftemp += (ftemp < 0) ? -0.5 : 0.5;
+        if(ftemp <= -32768)     { data[i] = -32768; }
+        else if(ftemp >= 32767) { data[i] = +32767; }
+        else                    { data[i] = (int16_t)ftemp; }
+    }
+
+    out->index_bits   = index_bits;
+    out->in_int_bits  = in_int_bits;
+    out->out_int_bits = out_int_bits;
+    out->data = data;
+    return 0;
+}
+
+void deleteLUT16q(lut16q_t *lut) {
+    if(lut->data != NULL) {
+        free(lut->data);
+        lut->data = NULL;
+    }
+}
+
 #ifndef SERIAL
 // NEON Code * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 void clampingLUT(matrix32f_t *input0, lut32f_t *lut, matrix32f_t *output0) {
@@ -88,14 +232,21 @@ void clampingLUT(matrix32f_t *input0, lut32f_t *lut, matrix32f_t *output0) {
             printf("Error in clampingLUT: (input0.w != output0.w) || (input0.h != output0.h)\n");
             return;
         }
+    }
     if(lut->data == NULL) { printf("Error in clampingLUT: The LUT is not initiated.\n"); return; }
-
 #endif
     // Note a matrix' dimensions have no effect when applying an LUT.
     size_t length = input0->h * input0->w;
     // Select the active output
     float32_t *output = (output0 == NULL) ? input0->d : output0->d;
 
+    if(lut->mode == LUT_LINEAR) {
+        size_t i;
+        for(i = 0; i+4 <= length; i+=4) { vst1q_f32(&output[i], vlinearLUTq_f32(vld1q_f32(&input0->d[i]), lut)); }
+        for(i; i < length; i++) { output[i] = clampingLUTScalar(input0->d[i], lut); }
+        return;
+    }
+
     // Multiplication factor for normalizing input to lut length
     float32_t mult_factor = lut->mult_factor;
     // Bias for mapping negative inputs to positive values
@@ -153,12 +304,50 @@ void clampingLUT(matrix32f_t *input0, lut32f_t *lut, matrix32f_t *output0) {
 
         // Convert to uint32 and clamp big numbers
         utemp = (uint32_t)ftemp;
-        utemp = (utemp > lut->length)? lut->length : utemp;
+        utemp = (utemp > last_lut_idx)? last_lut_idx : utemp;
 
         output[i] = lut->data[utemp];
     }
 }
 
+void clampingLUT_q16(matrix16q_t *input0, lut16q_t *lut, matrix16q_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL) { printf("Error in clampingLUT_q16: input0 is not initiated.\n"); return; }
+    if(lut->data == NULL) { printf("Error in clampingLUT_q16: The LUT is not initiated.\n"); return; }
+    if(input0->int_bits != lut->in_int_bits) { printf("Error in clampingLUT_q16: The input's format doesn't match the LUT's.\n"); return; }
+    if(output0 != NULL && ((input0->w != output0->w) || (input0->h != output0->h))) {
+        printf("Error in clampingLUT_q16: (input0.w != output0.w) || (input0.h != output0.h)\n");
+        return;
+    }
+#endif
+    size_t length = input0->h * input0->w;
+    matrix16q_t *output = (output0 == NULL) ? input0 : output0;
+
+    // Offsetting by 2^15 maps the signed input range to [0, 2^16); the upper bits are the index
+    uint8_t shift = 16 - lut->index_bits;
+    uint16x8_t voffset = vdupq_n_u16(0x8000);
+    int16x8_t vshift = vdupq_n_s16(-shift);
+    uint16x8_t vidx;
+
+    size_t i;
+    for(i = 0; i+8 <= length; i+=8) {
+        vidx = vshlq_u16(veorq_u16(vreinterpretq_u16_s16(vld1q_s16(&input0->d[i])), voffset), vshift);
+
+        // There is no gather instruction; look-ups are scalar
+        output->d[i+0] = lut->data[ vgetq_lane_u16(vidx, 0) ];
+        output->d[i+1] = lut->data[ vgetq_lane_u16(vidx, 1) ];
+        output->d[i+2] = lut->data[ vgetq_lane_u16(vidx, 2) ];
+        output->d[i+3] = lut->data[ vgetq_lane_u16(vidx, 3) ];
+        output->d[i+4] = lut->data[ vgetq_lane_u16(vidx, 4) ];
+        output->d[i+5] = lut->data[ vgetq_lane_u16(vidx, 5) ];
+        output->d[i+6] = lut->data[ vgetq_lane_u16(vidx, 6) ];
+        output->d[i+7] = lut->data[ vgetq_lane_u16(vidx, 7) ];
+    }
+    for(i; i < length; i++) { output->d[i] = lut->data[ ((uint16_t)input0->d[i] ^ 0x8000) >> shift ]; }
+
+    output->int_bits = lut->out_int_bits;
+}
+
 void sqrtLUT(matrix32f_t *input0, lut32f_t *lut, matrix32f_t *output0) {
 #ifdef DEBUG
     if(input0->d == NULL) { printf("Error in sqrtLUT: input0 is not initialized.\n"); return; }
@@ -171,6 +360,9 @@ void sqrtLUT(matrix32f_t *input0, lut32f_t *lut, matrix32f_t *output0) {
         if(lut->data == NULL) { printf("Error in sqrtLUT: The LUT is not initiliazed.\n"); return; }
     }
 #endif
+    // Linear tables interpolate from the LUT's start instead of rounding; The bias is 0 for square root LUTs
+    if(lut->mode == LUT_LINEAR) { clampingLUT(input0, lut, output0); return; }
+
     // NOTE: A matrix' dimensions have no effect when applying an LUT.
     size_t length = input0->h * input0->w;
     // Select the active output
@@ -231,6 +423,17 @@ void angleLUT_c(matrix32c_t *input0, lut32f_t *lut, matrix32f_t *output0) {
     float32_t *indf  = (float32_t*)input0->d;
     float32_t *outdf = (float32_t*)output0->d;
 
+    // Linear tables interpolate the ratios like `clampingLUT`
+    if(lut->mode == LUT_LINEAR) {
+        size_t i, o = 0;
+        for(i = 0; i+8 <= len; i+=8, o+=4) {
+            float32x4x2_t vc = vld2q_f32(&indf[i]);
+            vst1q_f32(&outdf[o], vlinearLUTq_f32(vdivq_f32(vc.val[1], vc.val[0]), lut));
+        }
+        for(i; i < len; i+=2, o++) { outdf[o] = clampingLUTScalar(indf[i+1] / indf[i], lut); }
+        return;
+    }
+
     float32_t fbuffer[4];
     float32x4_t vreal, vimag, vdiv;
     uint32x4_t vuint;
@@ -291,7 +494,7 @@ void angleLUT_c(matrix32c_t *input0, lut32f_t *lut, matrix32f_t *output0) {
         ftemp = (ftemp < 0.0)? 0.0 : ftemp;
 
         utemp = (uint32_t)ftemp;
-        utemp = (utemp > lut->length)? lut->length : utemp;
+        utemp = (utemp > last_lut_idx)? last_lut_idx : utemp;
         outdf[o] = lut->data[utemp];
         o++;
     }
@@ -313,6 +516,23 @@ void expiLUT(matrix32f_t *input0, lut32f_t *sinlut, lut32f_t *coslut, matrix32c_
     float32_t *indf  = (float32_t*)input0->d;
     float32_t *outdf = (float32_t*)output0->d;
 
+    // Linear tables (either of the two) are interpolated and clamped like `clampingLUT`
+    if(sinlut->mode == LUT_LINEAR || coslut->mode == LUT_LINEAR) {
+        size_t i;
+        for(i = 0; i+4 <= len; i+=4) {
+            float32x4_t vin = vld1q_f32(&indf[i]);
+            float32x4x2_t vc;
+            vc.val[0] = vclampingLUTq_f32(vin, coslut);
+            vc.val[1] = vclampingLUTq_f32(vin, sinlut);
+            vst2q_f32(&outdf[2*i], vc);
+        }
+        for(i; i < len; i++) {
+            outdf[2*i]   = clampingLUTScalar(indf[i], coslut);
+            outdf[2*i+1] = clampingLUTScalar(indf[i], sinlut);
+        }
+        return;
+    }
+
     float32x4_t vfin;
     uint32x4_t  vuint;
 
@@ -393,6 +613,11 @@ void clampingLUT(matrix32f_t *input0, lut32f_t *lut, matrix32f_t *output0) {
     // Select the active output
     float32_t *output = (output0 == NULL) ? input0->d : output0->d;
 
+    if(lut->mode == LUT_LINEAR) {
+        for(size_t i = 0; i < length; i++) { output[i] = clampingLUTScalar(input0->d[i], lut); }
+        return;
+    }
+
     // Multiplication factor for normalizing input to lut length
     float32_t mult_factor = lut->mult_factor;
     // Bias for mapping negative inputs to positive values
@@ -403,7 +628,7 @@ void clampingLUT(matrix32f_t *input0, lut32f_t *lut, matrix32f_t *output0) {
     // Get leftover numbers
     float32_t ftemp;
     uint32_t  utemp;
-    for(size_t i; i < length; i++) {
+    for(size_t i = 0; i < length; i++) {
         ftemp = input0->d[i] * mult_factor + bias;
 
         // Clamp negative numbers
@@ -411,12 +636,28 @@ void clampingLUT(matrix32f_t *input0, lut32f_t *lut, matrix32f_t *output0) {
 
         // Convert to uint32 and clamp big numbers
         utemp = (uint32_t)ftemp;
-        utemp = (utemp > lut->length)? lut->length : utemp;
+        utemp = (utemp > last_lut_idx)? last_lut_idx : utemp;
 
         output[i] = lut->data[utemp];
     }
 }
 
+void clampingLUT_q16(matrix16q_t *input0, lut16q_t *lut, matrix16q_t *output0) {
+#ifdef DEBUG
+    if(input0->d == NULL) { printf("Error in clampingLUT_q16: input0 is not initiated.\n"); return; }
+    if(lut->data == NULL) { printf("Error in clampingLUT_q16: The LUT is not initiated.\n"); return; }
+    if(input0->int_bits != lut->in_int_bits) { printf("Error in clampingLUT_q16: The input's format doesn't match the LUT's.\n"); return; }
+#endif
+    size_t length = input0->h * input0->w;
+    matrix16q_t *output = (output0 == NULL) ? input0 : output0;
+    uint8_t shift = 16 - lut->index_bits;
+
+    // Offsetting by 2^15 maps the signed input range to [0, 2^16); the upper bits are the index
+    for(size_t i = 0; i < length; i++) { output->d[i] = lut->data[ ((uint16_t)input0->d[i] ^ 0x8000) >> shift ]; }
+
+    output->int_bits = lut->out_int_bits;
+}
+
 void sqrtLUT(matrix32f_t *input0, lut32f_t *lut, matrix32f_t *output0) {
     #ifdef DEBUG
     if(input0->d == NULL) { printf("Error in sqrtLUT: input0 is not initiated.\n"); return; }
@@ -429,6 +670,9 @@ void sqrtLUT(matrix32f_t *input0, lut32f_t *lut, matrix32f_t *output0) {
         if(lut->data == NULL) { printf("Error in sqrtLUT: The LUT is not initiated.\n"); return; }
     }
     #endif
+    // Linear tables interpolate from the LUT's start instead of rounding; The bias is 0 for square root LUTs
+    if(lut->mode == LUT_LINEAR) { clampingLUT(input0, lut, output0); return; }
+
     // NOTE: A matrix' dimensions have no effect when applying an LUT.
     size_t length = input0->h * input0->w;
     // Select the active output
@@ -470,18 +714,23 @@ void angleLUT_c(matrix32c_t *input0, lut32f_t *lut, matrix32f_t *output0) {
     float32_t *indf  = (float32_t*)input0->d;
     float32_t *outdf = (float32_t*)output0->d;
 
+    if(lut->mode == LUT_LINEAR) {
+        for(size_t i = 0, o = 0; i < len; i+=2, o++) { outdf[o] = clampingLUTScalar(indf[i+1] / indf[i], lut); }
+        return;
+    }
+
     // Handle leftovers
     float32_t ftemp;
     uint32_t  utemp;
     size_t o = 0; // indexes real output
-    for(size_t i; i < len; i+=2) {
+    for(size_t i = 0; i < len; i+=2) {
         ftemp = indf[i+1] / indf[i];
         ftemp = ftemp * mult_factor + bias;
 
         ftemp = (ftemp < 0.0)? 0.0 : ftemp;
 
         utemp = (uint32_t)ftemp;
-        utemp = (utemp > lut->length)? lut->length : utemp;
+        utemp = (utemp > last_lut_idx)? last_lut_idx : utemp;
         outdf[o] = lut->data[utemp];
         o++;
     }
@@ -508,6 +757,15 @@ void expiLUT(matrix32f_t *input0, lut32f_t *sinlut, lut32f_t *coslut, matrix32c_
     float32_t *indf  = input0->d;
     float32_t *outdc = (float32_t*)output0->d;
 
+    // Linear tables (either of the two) are interpolated and clamped like `clampingLUT`
+    if(sinlut->mode == LUT_LINEAR || coslut->mode == LUT_LINEAR) {
+        for(size_t i = 0; i < len; i++) {
+            outdc[2*i]   = clampingLUTScalar(indf[i], coslut);
+            outdc[2*i+1] = clampingLUTScalar(indf[i], sinlut);
+        }
+        return;
+    }
+
     // Get leftover numbers
     float32_t ftemp;
     uint32_t  utemp;
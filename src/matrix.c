@@ -6,10 +6,17 @@
 #endif
 
 #include <string.h> // memset, memcpy
+#include <math.h>   // fabsf
+
+// Rounds a size in bytes up to a whole number of cache lines (at least one)
+static inline size_t matrixPaddedBytes(size_t bytes) {
+    return (bytes == 0) ? MATRIX_ALIGNMENT : (bytes + MATRIX_ALIGNMENT - 1) & ~((size_t)MATRIX_ALIGNMENT - 1);
+}
 
 int newMatrix32f(size_t h, size_t w, matrix32f_t *mat) {
-    float32_t *mem = (float32_t*)malloc(w*h*sizeof(float32_t));
-    if(mem == NULL) { return 0; }
+    // `aligned_alloc` requires a multiple of the alignment
+    float32_t *mem = (float32_t*)aligned_alloc(MATRIX_ALIGNMENT, matrixPaddedBytes(w*h*sizeof(float32_t)));
+    if(mem == NULL) { return 1; }
 
     mat->w  = w;
     mat->h = h;
@@ -19,8 +26,8 @@ int newMatrix32f(size_t h, size_t w, matrix32f_t *mat) {
 }
 
 int newMatrix32c(size_t h, size_t w, matrix32c_t *mat) {
-    float complex *mem = (float complex*)malloc(w*h*sizeof(float complex));
-    if(mem == NULL) { return 0; }
+    float complex *mem = (float complex*)aligned_alloc(MATRIX_ALIGNMENT, matrixPaddedBytes(w*h*sizeof(float complex)));
+    if(mem == NULL) { return 1; }
 
     mat->w  = w;
     mat->h = h;
@@ -29,6 +36,86 @@ int newMatrix32c(size_t h, size_t w, matrix32c_t *mat) {
     return 0;
 }
 
+size_t matrixBytes(size_t h, size_t w) {
+    return matrixPaddedBytes(w*h*sizeof(float32_t));
+}
+
+int matrixArenaCreate(size_t size, matrix_arena_t *arena) {
+    size = matrixPaddedBytes(size);
+    arena->mem = (uint8_t*)aligned_alloc(MATRIX_ALIGNMENT, size);
+    if(arena->mem == NULL) {
+#ifdef DEBUG
+        printf("Error in matrixArenaCreate: Failed to allocate %lu bytes.\n", size);
+#endif
+        arena->size = 0;
+        arena->used = 0;
+        return 1;
+    }
+    arena->size = size;
+    arena->used = 0;
+    return 0;
+}
+
+void matrixArenaDelete(matrix_arena_t *arena) {
+    if(arena->mem != NULL) {
+        free(arena->mem);
+        arena->mem = NULL;
+    }
+    arena->size = 0;
+    arena->used = 0;
+}
+
+size_t matrixArenaBytes(size_t h, size_t w) {
+    return matrixPaddedBytes(w*h*sizeof(float32_t));
+}
+
+size_t matrixArenaMark(matrix_arena_t *arena) {
+    return arena->used;
+}
+
+void matrixArenaReset(matrix_arena_t *arena, size_t mark) {
+#ifdef DEBUG
+    if(mark > arena->used) { printf("Error in matrixArenaReset: mark is past the arena's current position.\n"); return; }
+#endif
+    arena->used = mark;
+}
+
+// Takes `bytes` (padded) from the arena; Returns NULL when the arena is full
+static void *matrixArenaTake(matrix_arena_t *arena, size_t bytes) {
+    bytes = matrixPaddedBytes(bytes);
+    if(arena->mem == NULL || arena->size - arena->used < bytes) {
+#ifdef DEBUG
+        printf("Error in newMatrix32fIn/newMatrix32cIn: Arena is full (%lu of %lu bytes used, %lu requested).\n", arena->used, arena->size, bytes);
+#endif
+        return NULL;
+    }
+    void *mem = arena->mem + arena->used;
+    arena->used += bytes;
+    return mem;
+}
+
+int newMatrix32fIn(matrix_arena_t *arena, size_t h, size_t w, matrix32f_t *mat) {
+    float32_t *mem = (float32_t*)matrixArenaTake(arena, w*h*sizeof(float32_t));
+    if(mem == NULL) { return 1; }
+
+    mat->w = w;
+    mat->h = h;
+    mat->d = mem;
+
+    return 0;
+}
+
+int newMatrix32cIn(matrix_arena_t *arena, size_t h, size_t w, matrix32c_t *mat) {
+    float complex *mem = (float complex*)matrixArenaTake(arena, w*h*sizeof(float complex));
+    if(mem == NULL) { return 1; }
+
+    mat->w = w;
+    mat->h = h;
+    mat->d = mem;
+
+    return 0;
+}
+
 void deleteMatrix(matrix32f_t *mat) {
     if(mat->d != NULL) {
         free(mat->d);
@@ -75,6 +162,48 @@ void matrixConcat(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0) {
     memcpy(out0->d+len0, in1->d, len1 * sizeof(float32_t));
 }
 
+void matrixTranspose(matrix32f_t *in0, matrix32f_t *out0) {
+#ifdef DEBUG
+    if(in0->d == NULL || out0->d == NULL) { printf("Error in matrixTranspose: Matrices are not initialized.\n"); return; }
+    if(in0->d == out0->d) { printf("Error in matrixTranspose: This operation is not done in-place.\n"); return; }
+    if(in0->w * in0->h != out0->w * out0->h) { printf("Error in matrixTranspose: Dimensions of arguments don't match.\n"); return; }
+#endif
+    size_t h = in0->h, w = in0->w;
+    size_t row = 0, col;
+
+#ifndef SERIAL
+    // 4x4 blocks are transposed in registers
+    float32x4_t vrow[4], vtemp[4];
+    for(row = 0; row+4 <= h; row+=4) {
+        for(col = 0; col+4 <= w; col+=4) {
+            for(uint8_t r = 0; r < 4; r++) { vrow[r] = vld1q_f32(&(in0->d[(row+r)*w + col])); }
+
+            // [a0 b0 a2 b2], [a1 b1 a3 b3], [c0 d0 c2 d2], [c1 d1 c3 d3]
+            vtemp[0] = vtrn1q_f32(vrow[0], vrow[1]);
+            vtemp[1] = vtrn2q_f32(vrow[0], vrow[1]);
+            vtemp[2] = vtrn1q_f32(vrow[2], vrow[3]);
+            vtemp[3] = vtrn2q_f32(vrow[2], vrow[3]);
+
+            vst1q_f32(&(out0->d[(col+0)*h + row]), vcombine_f32(vget_low_f32(vtemp[0]),  vget_low_f32(vtemp[2])));
+            vst1q_f32(&(out0->d[(col+1)*h + row]), vcombine_f32(vget_low_f32(vtemp[1]),  vget_low_f32(vtemp[3])));
+            vst1q_f32(&(out0->d[(col+2)*h + row]), vcombine_f32(vget_high_f32(vtemp[0]), vget_high_f32(vtemp[2])));
+            vst1q_f32(&(out0->d[(col+3)*h + row]), vcombine_f32(vget_high_f32(vtemp[1]), vget_high_f32(vtemp[3])));
+        }
+        // Leftover columns of these rows
+        for(col; col < w; col++) {
+            for(size_t r = row; r < row+4; r++) { out0->d[col*h + r] = in0->d[r*w + col]; }
+        }
+    }
+#endif
+    // Leftover rows
+    for(row; row < h; row++) {
+        for(col = 0; col < w; col++) { out0->d[col*h + row] = in0->d[row*w + col]; }
+    }
+
+    out0->h = w;
+    out0->w = h;
+}
+
 
 void flipVector(matrix32f_t *in0, matrix32f_t *out0) {
 #ifndef SERIAL
@@ -304,7 +433,7 @@ void matrixFrom8bit(int8_t *src, uint32_t int_bits, matrix32f_t *mat) {
 #endif
     // Handle left-overs
     float32_t ftemp;
-    uint32_t itemp;
+    int32_t itemp;
 
     for(i; i < len; i++) {
         itemp = (int32_t)(src[i]);
@@ -366,7 +495,7 @@ void matrixFrom16bit(int16_t *src, uint32_t int_bits, matrix32f_t *mat){
 #endif
     // Handle left-overs
     float32_t ftemp;
-    uint32_t itemp;
+    int32_t itemp;
 
     for(i; i < len; i++) {
         itemp = (int32_t)(src[i]);
@@ -374,3 +503,196 @@ void matrixFrom16bit(int16_t *src, uint32_t int_bits, matrix32f_t *mat){
         mat->d[i] = ftemp;
     }
 }
+
+
+int newMatrix8q(size_t h, size_t w, matrix8q_t *mat) {
+#ifdef MATRIX8Q_DOT_LAYOUT
+    size_t rows = (h + 3) & ~(size_t)3;
+#else
+    size_t rows = h;
+#endif
+    int8_t *mem = (int8_t*)malloc(rows*w*sizeof(int8_t));
+    float32_t *scale = (float32_t*)malloc(w*sizeof(float32_t));
+    if(mem == NULL || scale == NULL) {
+        free(mem);
+        free(scale);
+        return 1;
+    }
+
+    mat->h = h;
+    mat->w = w;
+    mat->d = mem;
+    mat->scale = scale;
+
+    return 0;
+}
+
+void deleteMatrix8q(matrix8q_t *mat) {
+    if(mat->d != NULL) {
+        free(mat->d);
+        mat->d = NULL;
+    }
+    if(mat->scale != NULL) {
+        free(mat->scale);
+        mat->scale = NULL;
+    }
+}
+
+int quantizeMatrix8q(matrix32f_t *in, matrix8q_t *out) {
+#ifdef DEBUG
+    if(in == NULL || in->d == NULL) { printf("Error in quantizeMatrix8q: Input matrix is not initialized.\n"); return 1; }
+#endif
+    if(newMatrix8q(in->h, in->w, out)) {
+#ifdef DEBUG
+        printf("Error in quantizeMatrix8q: Failed to allocate memory.\n");
+#endif
+        return 2;
+    }
+
+    size_t h = in->h, w = in->w;
+
+    // Find each column's range; Quantization is symmetric so only the max. magnitude is required
+    for(size_t j = 0; j < w; j++) { out->scale[j] = 0; }
+    for(size_t i = 0; i < h; i++) {
+        for(size_t j = 0; j < w; j++) {
+            float32_t mag = fabsf(in->d[i*w + j]);
+            if(mag > out->scale[j]) { out->scale[j] = mag; }
+        }
+    }
+    for(size_t j = 0; j < w; j++) { out->scale[j] /= 127.0; }
+
+#ifdef MATRIX8Q_DOT_LAYOUT
+    // Zero the padding rows
+    memset(out->d, 0, ((h + 3) & ~(size_t)3) * w);
+#endif
+
+    float32_t ftemp;
+    for(size_t i = 0; i < h; i++) {
+        for(size_t j = 0; j < w; j++) {
+            // Columns of zeros have a zero scale
+            ftemp = (out->scale[j] > 0) ? in->d[i*w + j] / out->scale[j] : 0;
+            ftemp += (ftemp < 0) ? -0.5 : 0.5; // round to nearest
+#ifdef MATRIX8Q_DOT_LAYOUT
+            out->d[(i/4)*w*4 + j*4 + i%4] = (int8_t)ftemp;
+#else
+            out->d[i*w + j] = (int8_t)ftemp;
+#endif
+        }
+    }
+
+    return 0;
+}
+
+
+int newMatrix16q(size_t h, size_t w, uint8_t int_bits, matrix16q_t *mat) {
+    int16_t *mem = (int16_t*)malloc(w*h*sizeof(int16_t));
+    if(mem == NULL) { return 1; }
+
+    mat->h = h;
+    mat->w = w;
+    mat->d = mem;
+    mat->int_bits = int_bits;
+
+    return 0;
+}
+
+void deleteMatrix16q(matrix16q_t *mat) {
+    if(mat->d != NULL) {
+        free(mat->d);
+        mat->d = NULL;
+    }
+}
+
+uint8_t matrixIntBits16q(matrix32f_t *mat) {
+    float32_t max = 0;
+    for(size_t i = 0; i < mat->w*mat->h; i++) { max = (fabsf(mat->d[i]) > max) ? fabsf(mat->d[i]) : max; }
+
+    uint8_t int_bits;
+    for(int_bits = 0; int_bits < 15 && max >= (float32_t)(1 << int_bits); int_bits++);
+    return int_bits;
+}
+
+void matrixTo16q(matrix32f_t *in, matrix16q_t *out) {
+#ifdef DEBUG
+    if(in->d == NULL || out->d == NULL) { printf("Error in matrixTo16q: Matrices are not initialized.\n"); return; }
+    if(in->w * in->h != out->w * out->h) { printf("Error in matrixTo16q: Dimensions of arguments don't match.\n"); return; }
+    if(out->int_bits > 15) { printf("Error in matrixTo16q: `int_bits > 15`\n"); return; }
+#endif
+    size_t len = in->w * in->h;
+    size_t i = 0;
+    float32_t factor = quant_mul_factor[out->int_bits];
+
+#ifndef SERIAL
+    float32x4_t vfactor = vld1q_dup_f32(&factor);
+    int32x4_t vlo, vhi;
+    for(i = 0; i+8 <= len; i+=8) {
+        // Round to nearest, `vqmovn` saturates
+        vlo = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(in->d + i), vfactor));
+        vhi = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(in->d + i + 4), vfactor));
+        vst1q_s16(out->d + i, vcombine_s16(vqmovn_s32(vlo), vqmovn_s32(vhi)));
+    }
+#endif
+    // Handle left-overs
+    float32_t ftemp;
+    for(i; i < len; i++) {
+        ftemp = in->d[i] * factor;
+        ftemp += (ftemp < 0) ? -0.5 : 0.5;
+
+        if(ftemp <= -32768)     { out->d[i] = -32768; }
+        else if(ftemp >= 32767) { out->d[i] = +32767; }
+        else                    { out->d[i] = (int16_t)ftemp; }
+    }
+}
+
+void matrixFrom16q(matrix16q_t *in, matrix32f_t *out) {
+    matrixFrom16bit(in->d, in->int_bits, out);
+}
+
+
+int newMatrix16f(size_t h, size_t w, matrix16f_t *mat) {
+    float16_t *mem = (float16_t*)malloc(w*h*sizeof(float16_t));
+    if(mem == NULL) { return 1; }
+
+    mat->h = h;
+    mat->w = w;
+    mat->d = mem;
+
+    return 0;
+}
+
+void deleteMatrix16f(matrix16f_t *mat) {
+    if(mat->d != NULL) {
+        free(mat->d);
+        mat->d = NULL;
+    }
+}
+
+void matrixTo16f(matrix32f_t *in, matrix16f_t *out) {
+#ifdef DEBUG
+    if(in->d == NULL || out->d == NULL) { printf("Error in matrixTo16f: Matrices are not initialized.\n"); return; }
+    if(in->w * in->h != out->w * out->h) { printf("Error in matrixTo16f: Dimensions of arguments don't match.\n"); return; }
+#endif
+    size_t len = in->w * in->h;
+    size_t i = 0;
+
+#ifndef SERIAL
+    for(i = 0; i+4 <= len; i+=4) { vst1_f16(out->d + i, vcvt_f16_f32(vld1q_f32(in->d + i))); }
+#endif
+    // Handle left-overs
+    for(i; i < len; i++) { out->d[i] = (float16_t)in->d[i]; }
+}
+
+void matrixFrom16f(matrix16f_t *in, matrix32f_t *out) {
+#ifdef DEBUG
+    if(in->d == NULL || out->d == NULL) { printf("Error in matrixFrom16f: Matrices are not initialized.\n"); return; }
+    if(in->w * in->h != out->w * out->h) { printf("Error in matrixFrom16f: Dimensions of arguments don't match.\n"); return; }
+#endif
+    size_t len = in->w * in->h;
+    size_t i = 0;
+
+#ifndef SERIAL
+    for(i = 0; i+4 <= len; i+=4) { vst1q_f32(out->d + i, vcvt_f32_f16(vld1_f16(in->d + i))); }
+#endif
+    // Handle left-overs
+    for(i; i < len; i++) { out->d[i] = (float32_t)in->d[i]; }
+}
@@ -8,6 +8,8 @@
 #endif
 
 #include <stdio.h>
+#include <string.h> // memcpy
+#include <math.h>   // sqrtf
 
 
 // Adds two matrices together
@@ -53,7 +55,66 @@ void matrixDiff(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0) {
         i+=4;
     };
 
-    for(i; i<len; i++) { output[i] = in0->d[i] + in1->d[i]; }
+    for(i; i<len; i++) { output[i] = in0->d[i] - in1->d[i]; }
+}
+
+// Activation of `multVecByMatEx`'s epilogue on a register
+static inline float32x4_t vactivationq_f32(float32x4_t vin, uint8_t act, lut32f_t *act_lut) {
+    switch(act) {
+        case ACTIVATION_RELU:       return vmaxq_f32(vin, vdupq_n_f32(0));
+        case ACTIVATION_TANH:       return (act_lut != NULL) ? vclampingLUTq_f32(vin, act_lut) : vtanhApproxq_f32(vin);
+        case ACTIVATION_SIGMOID:    return (act_lut != NULL) ? vclampingLUTq_f32(vin, act_lut) : vsigmoidApproxq_f32(vin);
+        default:                    return vin;
+    }
+}
+
+static inline float32_t activationScalar(float32_t in, uint8_t act, lut32f_t *act_lut) {
+    switch(act) {
+        case ACTIVATION_RELU:       return (in < 0) ? 0 : in;
+        case ACTIVATION_TANH:       return (act_lut != NULL) ? clampingLUTScalar(in, act_lut) : tanhApproxScalar(in);
+        case ACTIVATION_SIGMOID:    return (act_lut != NULL) ? clampingLUTScalar(in, act_lut) : sigmoidApproxScalar(in);
+        default:                    return in;
+    }
+}
+
+// Accumulates `vec0` x columns [col, col + 4*blocks) of `mat1` in `blocks` registers; Two rows of `mat1` are
+// read per iteration and the output is written once. `blocks` is a constant in every call so the loops unroll.
+// The accumulators start from `bias` (if not NULL) and `act` is applied before storing (`multVecByMatEx`).
+static inline void multVecByMatTile(matrix32f_t *vec0, matrix32f_t *mat1, matrix32f_t *out0, size_t col, const uint8_t blocks,
+                                    const float32_t *bias, uint8_t act, lut32f_t *act_lut) {
+    size_t rows = mat1->h, cols = mat1->w;
+    float32x4_t vacc[8];
+    float32x4_t vx0, vx1;
+    uint8_t b;
+
+    for(b = 0; b < blocks; b++) { vacc[b] = (bias != NULL) ? vld1q_f32(bias + col + 4*b) : vdupq_n_f32(0); }
+
+    const float32_t *w = &(mat1->d[col]);
+    size_t k = 0;
+    for(k = 0; k+2 <= rows; k+=2) {
+        vx0 = vld1q_dup_f32(&(vec0->d[k]));
+        vx1 = vld1q_dup_f32(&(vec0->d[k+1]));
+        for(b = 0; b < blocks; b++) { vacc[b] = vfmaq_f32(vacc[b], vx0, vld1q_f32(w + 4*b)); }
+        for(b = 0; b < blocks; b++) { vacc[b] = vfmaq_f32(vacc[b], vx1, vld1q_f32(w + cols + 4*b)); }
+        w += 2*cols;
+    }
+    if(k < rows) {
+        vx0 = vld1q_dup_f32(&(vec0->d[k]));
+        for(b = 0; b < blocks; b++) { vacc[b] = vfmaq_f32(vacc[b], vx0, vld1q_f32(w + 4*b)); }
+    }
+
+    for(b = 0; b < blocks; b++) { vst1q_f32(&(out0->d[col + 4*b]), vactivationq_f32(vacc[b], act, act_lut)); }
+}
+
+// Register-blocked Vector by Matrix Multiplication of the first (w & ~3) columns; The output is tiled
+// in 32 floats (8 registers) that stay in registers for the whole input vector, then 16 and 4 floats
+static inline void multVecByMatBlocked(matrix32f_t *vec0, matrix32f_t *mat1, matrix32f_t *out0, const float32_t *bias, uint8_t act, lut32f_t *act_lut) {
+    size_t cols = mat1->w;
+    size_t col = 0;
+
+    for(col = 0; col+32 <= cols; col+=32) { multVecByMatTile(vec0, mat1, out0, col, 8, bias, act, act_lut); }
+    for(col; col+16 <= cols; col+=16) { multVecByMatTile(vec0, mat1, out0, col, 4, bias, act, act_lut); }
+    for(col; col+4 <= cols; col+=4) { multVecByMatTile(vec0, mat1, out0, col, 1, bias, act, act_lut); }
 }
 
 // Vector by Matrix Multiplication; if `in0.h == 0` some loops can be skipped
@@ -69,6 +130,12 @@ void multVecByMat(matrix32f_t *vec0, matrix32f_t *mat1, matrix32f_t *out0) {
     if((out0->h != 1) || (mat1->w != out0->w)) { printf("Error in multVecByMat: (out0->h != 1) || (mat1->w != out0->w)\n"); return; }
     if(vec_dim != mat1->h) { printf("Error in multVecByMat: vec_dim != mat1->h\n"); return; }
 #endif
+    // Rows made of whole vectors; keep the output in registers
+    if(mat1->w % 4 == 0) {
+        multVecByMatBlocked(vec0, mat1, out0, NULL, ACTIVATION_NONE, NULL);
+        return;
+    }
+
     // `out0` must be all zeros
     clearMatrix(out0);
 
@@ -108,52 +175,611 @@ void multVecByMat(matrix32f_t *vec0, matrix32f_t *mat1, matrix32f_t *out0) {
     }
 }
 
+void multVecByMatEx(matrix32f_t *vec0, matrix32f_t *mat1, matrix32f_t *bias, uint8_t act, lut32f_t *act_lut, matrix32f_t *out0) {
+#ifdef DEBUG
+    if(out0 == NULL) { printf("Error in multVecByMatEx: out0==NULL\n"); return; }
+    if(vec0->d == NULL || mat1->d == NULL || out0->d == NULL) { printf("Error in multVecByMatEx: (vec0->d == NULL || mat1->d == NULL || out0->d == NULL)\n"); return; }
+    if((vec0->w!=1) && (vec0->h!=1)) { printf("Error in multVecByMatEx: (vec0->w!=1) && (vec0->h!=1)\n"); return; }
+    size_t vec_dim = (vec0->w > vec0->h) ? vec0->w : vec0->h;
+    if((out0->h != 1) || (mat1->w != out0->w)) { printf("Error in multVecByMatEx: (out0->h != 1) || (mat1->w != out0->w)\n"); return; }
+    if(vec_dim != mat1->h) { printf("Error in multVecByMatEx: vec_dim != mat1->h\n"); return; }
+    if(bias != NULL && bias->h*bias->w != mat1->w) { printf("Error in multVecByMatEx: The bias should have mat1->w elements\n"); return; }
+    if(act > ACTIVATION_SIGMOID) { printf("Error in multVecByMatEx: Unknown activation %d\n", act); return; }
+#endif
+    const float32_t *bias_d = (bias != NULL) ? bias->d : NULL;
+    size_t rows = mat1->h, cols = mat1->w;
+    multVecByMatBlocked(vec0, mat1, out0, bias_d, act, act_lut);
+
+    // Up to 3 columns are left; Each is accumulated whole, so `bias` may be `out0`
+    float32_t acc;
+    for(size_t col = cols & ~(size_t)3; col < cols; col++) {
+        acc = (bias_d != NULL) ? bias_d[col] : 0;
+        for(size_t k = 0; k < rows; k++) { acc += vec0->d[k] * mat1->d[col + cols*k]; }
+        out0->d[col] = activationScalar(acc, act, act_lut);
+    }
+}
+
+int foldBatchNorm(matrix32f_t *fc_w, matrix32f_t *mean, matrix32f_t *gammavar, matrix32f_t *beta, matrix32f_t *fused_w, matrix32f_t *fused_bias) {
+#ifdef DEBUG
+    if(fc_w->d == NULL || mean->d == NULL || gammavar->d == NULL || beta->d == NULL) { printf("Error in foldBatchNorm: Input matrices are not initialized.\n"); return 1; }
+    if(mean->h*mean->w != fc_w->w || gammavar->h*gammavar->w != fc_w->w || beta->h*beta->w != fc_w->w) {
+        printf("Error in foldBatchNorm: mean, gammavar and beta should have fc_w->w elements\n");
+        return 1;
+    }
+#endif
+    size_t rows = fc_w->h, cols = fc_w->w;
+    if(fused_w != fc_w && newMatrix32f(rows, cols, fused_w)) { return 1; }
+    if(newMatrix32f(1, cols, fused_bias)) {
+        if(fused_w != fc_w) { deleteMatrix(fused_w); }
+        return 1;
+    }
+
+    size_t i, k;
+    float32x4_t vgv;
+    for(i = 0; i+4 <= cols; i+=4) {
+        vgv = vld1q_f32(&gammavar->d[i]);
+        // beta - mean .* gammavar
+        vst1q_f32(&fused_bias->d[i], vmlsq_f32(vld1q_f32(&beta->d[i]), vld1q_f32(&mean->d[i]), vgv));
+        for(k = 0; k < rows; k++) { vst1q_f32(&fused_w->d[k*cols + i], vmulq_f32(vld1q_f32(&fc_w->d[k*cols + i]), vgv)); }
+    }
+    for(i; i < cols; i++) {
+        fused_bias->d[i] = beta->d[i] - mean->d[i]*gammavar->d[i];
+        for(k = 0; k < rows; k++) { fused_w->d[k*cols + i] = fc_w->d[k*cols + i]*gammavar->d[i]; }
+    }
+    return 0;
+}
+
+// Quantizes `len` floats to int8 with a single (symmetric) scale; Returns the scale, or 0 if all inputs are 0
+static float32_t quantizeVector8(const float32_t *in, size_t len, int8_t *out) {
+    float32x4_t vmax = vdupq_n_f32(0);
+    size_t i = 0;
+    for(i = 0; i+4 <= len; i+=4) { vmax = vmaxq_f32(vmax, vabsq_f32(vld1q_f32(in+i))); }
+    float32_t max = vmaxvq_f32(vmax);
+    for(i; i < len; i++) { max = (fabsf(in[i]) > max) ? fabsf(in[i]) : max; }
+    if(max == 0) { return 0; }
+
+    float32x4_t vfactor = vdupq_n_f32(127.0 / max);
+    for(i = 0; i+8 <= len; i+=8) {
+        int32x4_t vlo = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(in+i), vfactor));
+        int32x4_t vhi = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(in+i+4), vfactor));
+        vst1_s8(out+i, vqmovn_s16(vcombine_s16(vqmovn_s32(vlo), vqmovn_s32(vhi))));
+    }
+    float32_t ftemp;
+    for(i; i < len; i++) {
+        ftemp = in[i] * (127.0 / max);
+        out[i] = (int8_t)(ftemp + ((ftemp < 0) ? -0.5 : 0.5));
+    }
+    return max / 127.0;
+}
+
+// Quantized Vector by Matrix Multiplication; the input is quantized with a single scale, products are
+// accumulated in int32 and every output is dequantized once with the input's and its column's scale.
+// Uses SDOT with the dot product extension, SMLAL otherwise (Cortex-A53).
+void multVecByMat_q8(matrix32f_t *vec0, matrix8q_t *mat1, matrix32f_t *out0) {
+#ifdef DEBUG
+    if(out0 == NULL) { printf("Error in multVecByMat_q8: out0==NULL\n"); return; }
+    if(vec0->d == NULL || mat1->d == NULL || out0->d == NULL) { printf("Error in multVecByMat_q8: (vec0->d == NULL || mat1->d == NULL || out0->d == NULL)\n"); return; }
+    if((vec0->w!=1) && (vec0->h!=1)) { printf("Error in multVecByMat_q8: (vec0->w!=1) && (vec0->h!=1)\n"); return; }
+    size_t vec_dim = (vec0->w > vec0->h) ? vec0->w : vec0->h;
+    if((out0->h != 1) || (mat1->w != out0->w)) { printf("Error in multVecByMat_q8: (out0->h != 1) || (mat1->w != out0->w)\n"); return; }
+    if(vec_dim != mat1->h) { printf("Error in multVecByMat_q8: vec_dim != mat1->h\n"); return; }
+#endif
+    size_t rows = mat1->h, cols = mat1->w;
+    const int8_t *mat = mat1->d;
+
+    // Quantized input; padded with zeros to a multiple of 4 for SDOT
+    int8_t vec_q[(rows + 3) & ~(size_t)3];
+    float32_t vec_scale = quantizeVector8(vec0->d, rows, vec_q);
+    if(vec_scale == 0) { clearMatrix(out0); return; }
+    for(size_t k = rows; k < ((rows + 3) & ~(size_t)3); k++) { vec_q[k] = 0; }
+
+    int32x4_t vacc[8];
+    size_t j = 0, k;
+
+#define Q8_DEQUANTIZE(acc, col) \
+    vst1q_f32(&(out0->d[col]), vmulq_f32(vcvtq_f32_s32(acc), vmulq_n_f32(vld1q_f32(&(mat1->scale[col])), vec_scale)))
+
+#ifdef MATRIX8Q_DOT_LAYOUT
+    // Every group of 4 rows holds 4 values per column; one 16-byte load covers 4 columns
+    size_t group_len = cols * 4;
+    int32_t vec_group;
+    int8x16_t vx;
+
+    for(j = 0; j+16 <= cols; j+=16) {
+        for(uint8_t a = 0; a < 4; a++) { vacc[a] = vdupq_n_s32(0); }
+
+        const int8_t *w = &(mat[j*4]);
+        for(k = 0; k < rows; k+=4) {
+            memcpy(&vec_group, &(vec_q[k]), 4);
+            vx = vreinterpretq_s8_s32(vdupq_n_s32(vec_group));
+            vacc[0] = vdotq_s32(vacc[0], vld1q_s8(w),      vx);
+            vacc[1] = vdotq_s32(vacc[1], vld1q_s8(w + 16), vx);
+            vacc[2] = vdotq_s32(vacc[2], vld1q_s8(w + 32), vx);
+            vacc[3] = vdotq_s32(vacc[3], vld1q_s8(w + 48), vx);
+            w += group_len;
+        }
+        for(uint8_t a = 0; a < 4; a++) { Q8_DEQUANTIZE(vacc[a], j + a*4); }
+    }
+    for(j; j+4 <= cols; j+=4) {
+        vacc[0] = vdupq_n_s32(0);
+        const int8_t *w = &(mat[j*4]);
+        for(k = 0; k < rows; k+=4) {
+            memcpy(&vec_group, &(vec_q[k]), 4);
+            vacc[0] = vdotq_s32(vacc[0], vld1q_s8(w), vreinterpretq_s8_s32(vdupq_n_s32(vec_group)));
+            w += group_len;
+        }
+        Q8_DEQUANTIZE(vacc[0], j);
+    }
+
+    // Leftover columns
+    int32_t acc;
+    for(j; j < cols; j++) {
+        acc = 0;
+        for(k = 0; k < rows; k++) { acc += (int32_t)vec_q[k] * mat[(k/4)*group_len + j*4 + k%4]; }
+        out0->d[j] = (float32_t)acc * mat1->scale[j] * vec_scale;
+    }
 
-// Vector by Matrix Multiplication; (when `vec0.h == 1` the vmaq optimization breaks)
+#else
+    // Row-major; each row is widened to int16 and multiplied with the input element by SMLAL.
+    // 32 columns (half a cache line per row) are accumulated in 8 registers at a time.
+    int8x16_t vrow[2];
+    int16x8_t vrow16[4];
+    int16_t x;
+
+    for(j = 0; j+32 <= cols; j+=32) {
+        for(uint8_t a = 0; a < 8; a++) { vacc[a] = vdupq_n_s32(0); }
+
+        const int8_t *w = &(mat[j]);
+        for(k = 0; k < rows; k++) {
+            x = vec_q[k];
+            vrow[0] = vld1q_s8(w);
+            vrow[1] = vld1q_s8(w + 16);
+            vrow16[0] = vmovl_s8(vget_low_s8(vrow[0]));
+            vrow16[1] = vmovl_high_s8(vrow[0]);
+            vrow16[2] = vmovl_s8(vget_low_s8(vrow[1]));
+            vrow16[3] = vmovl_high_s8(vrow[1]);
+
+            vacc[0] = vmlal_n_s16(vacc[0], vget_low_s16(vrow16[0]), x);
+            vacc[1] = vmlal_high_n_s16(vacc[1], vrow16[0], x);
+            vacc[2] = vmlal_n_s16(vacc[2], vget_low_s16(vrow16[1]), x);
+            vacc[3] = vmlal_high_n_s16(vacc[3], vrow16[1], x);
+            vacc[4] = vmlal_n_s16(vacc[4], vget_low_s16(vrow16[2]), x);
+            vacc[5] = vmlal_high_n_s16(vacc[5], vrow16[2], x);
+            vacc[6] = vmlal_n_s16(vacc[6], vget_low_s16(vrow16[3]), x);
+            vacc[7] = vmlal_high_n_s16(vacc[7], vrow16[3], x);
+            w += cols;
+        }
+        for(uint8_t a = 0; a < 8; a++) { Q8_DEQUANTIZE(vacc[a], j + a*4); }
+    }
+    for(j; j+8 <= cols; j+=8) {
+        vacc[0] = vdupq_n_s32(0);
+        vacc[1] = vdupq_n_s32(0);
+
+        const int8_t *w = &(mat[j]);
+        for(k = 0; k < rows; k++) {
+            vrow16[0] = vmovl_s8(vld1_s8(w));
+            vacc[0] = vmlal_n_s16(vacc[0], vget_low_s16(vrow16[0]), vec_q[k]);
+            vacc[1] = vmlal_high_n_s16(vacc[1], vrow16[0], vec_q[k]);
+            w += cols;
+        }
+        Q8_DEQUANTIZE(vacc[0], j);
+        Q8_DEQUANTIZE(vacc[1], j + 4);
+    }
+
+    // Leftover columns
+    int32_t acc;
+    for(j; j < cols; j++) {
+        acc = 0;
+        for(k = 0; k < rows; k++) { acc += (int32_t)vec_q[k] * mat[k*cols + j]; }
+        out0->d[j] = (float32_t)acc * mat1->scale[j] * vec_scale;
+    }
+#endif
+#undef Q8_DEQUANTIZE
+}
+
+// Saturating scalar helpers for the leftovers of the fixed point routines; they match the NEON instructions
+static inline int32_t q16Saturate32(int64_t x) { return (x > INT32_MAX) ? INT32_MAX : ((x < INT32_MIN) ? INT32_MIN : (int32_t)x); }
+static inline int16_t q16Saturate16(int64_t x) { return (x > INT16_MAX) ? INT16_MAX : ((x < INT16_MIN) ? INT16_MIN : (int16_t)x); }
+// Rounding shift right by `shift` (left if negative), like vqrshl with a negative shift
+static inline int64_t q16RoundingShift(int64_t x, int32_t shift) { return (shift > 0) ? ((x + ((int64_t)1 << (shift-1))) >> shift) : (x << -shift); }
+
+// Fixed point Vector by Matrix Multiplication; Products are accumulated with saturation (SQDMLAL) in int32
+// and converted to `out0`'s format once per output element.
+// The accumulators have 31-(30-vec0.int_bits-mat1.int_bits+1) integer bits of headroom.
+void multVecByMat_q16(matrix16q_t *vec0, matrix16q_t *mat1, matrix16q_t *out0) {
+#ifdef DEBUG
+    if(out0 == NULL) { printf("Error in multVecByMat_q16: out0==NULL\n"); return; }
+    if(vec0->d == NULL || mat1->d == NULL || out0->d == NULL) { printf("Error in multVecByMat_q16: (vec0->d == NULL || mat1->d == NULL || out0->d == NULL)\n"); return; }
+    if((vec0->w!=1) && (vec0->h!=1)) { printf("Error in multVecByMat_q16: (vec0->w!=1) && (vec0->h!=1)\n"); return; }
+    size_t vec_dim = (vec0->w > vec0->h) ? vec0->w : vec0->h;
+    if((out0->h != 1) || (mat1->w != out0->w)) { printf("Error in multVecByMat_q16: (out0->h != 1) || (mat1->w != out0->w)\n"); return; }
+    if(vec_dim != mat1->h) { printf("Error in multVecByMat_q16: vec_dim != mat1->h\n"); return; }
+#endif
+    size_t rows = mat1->h, cols = mat1->w;
+
+    // Doubling products have (15-vec0.int_bits) + (15-mat1.int_bits) + 1 fractional bits
+    int32_t shift = (15 - vec0->int_bits) + (15 - mat1->int_bits) + 1 - (15 - out0->int_bits);
+    int32x4_t vshift = vdupq_n_s32(-shift);
+
+    int32x4_t vacc[8];
+    int16x8_t vrow[4];
+    int16_t x;
+    size_t j, k;
+
+    // 32 columns (one cache line per row) are accumulated in 8 registers at a time
+    for(j = 0; j+32 <= cols; j+=32) {
+        for(uint8_t a = 0; a < 8; a++) { vacc[a] = vdupq_n_s32(0); }
+
+        const int16_t *w = &(mat1->d[j]);
+        for(k = 0; k < rows; k++) {
+            x = vec0->d[k];
+            vrow[0] = vld1q_s16(w);
+            vrow[1] = vld1q_s16(w + 8);
+            vrow[2] = vld1q_s16(w + 16);
+            vrow[3] = vld1q_s16(w + 24);
+
+            vacc[0] = vqdmlal_n_s16(vacc[0], vget_low_s16(vrow[0]), x);
+            vacc[1] = vqdmlal_high_n_s16(vacc[1], vrow[0], x);
+            vacc[2] = vqdmlal_n_s16(vacc[2], vget_low_s16(vrow[1]), x);
+            vacc[3] = vqdmlal_high_n_s16(vacc[3], vrow[1], x);
+            vacc[4] = vqdmlal_n_s16(vacc[4], vget_low_s16(vrow[2]), x);
+            vacc[5] = vqdmlal_high_n_s16(vacc[5], vrow[2], x);
+            vacc[6] = vqdmlal_n_s16(vacc[6], vget_low_s16(vrow[3]), x);
+            vacc[7] = vqdmlal_high_n_s16(vacc[7], vrow[3], x);
+            w += cols;
+        }
+
+        // Rounding shift to the output's format and saturating narrow
+        for(uint8_t a = 0; a < 4; a++) {
+            vst1q_s16(&(out0->d[j + a*8]), vcombine_s16(
+                vqmovn_s32(vqrshlq_s32(vacc[2*a], vshift)), vqmovn_s32(vqrshlq_s32(vacc[2*a+1], vshift))
+            ));
+        }
+    }
+    for(j; j+8 <= cols; j+=8) {
+        vacc[0] = vdupq_n_s32(0);
+        vacc[1] = vdupq_n_s32(0);
+
+        const int16_t *w = &(mat1->d[j]);
+        for(k = 0; k < rows; k++) {
+            vrow[0] = vld1q_s16(w);
+            vacc[0] = vqdmlal_n_s16(vacc[0], vget_low_s16(vrow[0]), vec0->d[k]);
+            vacc[1] = vqdmlal_high_n_s16(vacc[1], vrow[0], vec0->d[k]);
+            w += cols;
+        }
+        vst1q_s16(&(out0->d[j]), vcombine_s16(vqmovn_s32(vqrshlq_s32(vacc[0], vshift)), vqmovn_s32(vqrshlq_s32(vacc[1], vshift))));
+    }
+
+    // Leftover columns
+    int32_t acc;
+    for(j; j < cols; j++) {
+        acc = 0;
+        for(k = 0; k < rows; k++) { acc = q16Saturate32((int64_t)acc + 2*(int32_t)vec0->d[k]*mat1->d[k*cols + j]); }
+        out0->d[j] = q16Saturate16(q16RoundingShift(acc, shift));
+    }
+}
+
+// Vector by Matrix Multiplication with half precision weights; every row is widened with `vcvt_f32_f16` as it's loaded
+void multVecByMat_f16w(matrix32f_t *vec0, matrix16f_t *mat1, matrix32f_t *out0) {
+#ifdef DEBUG
+    if(out0 == NULL) { printf("Error in multVecByMat_f16w: out0==NULL\n"); return; }
+    if(vec0->d == NULL || mat1->d == NULL || out0->d == NULL) { printf("Error in multVecByMat_f16w: (vec0->d == NULL || mat1->d == NULL || out0->d == NULL)\n"); return; }
+    if((vec0->w!=1) && (vec0->h!=1)) { printf("Error in multVecByMat_f16w: (vec0->w!=1) && (vec0->h!=1)\n"); return; }
+    size_t vec_dim = (vec0->w > vec0->h) ? vec0->w : vec0->h;
+    if((out0->h != 1) || (mat1->w != out0->w)) { printf("Error in multVecByMat_f16w: (out0->h != 1) || (mat1->w != out0->w)\n"); return; }
+    if(vec_dim != mat1->h) { printf("Error in multVecByMat_f16w: vec_dim != mat1->h\n"); return; }
+#endif
+    size_t rows = mat1->h, cols = mat1->w;
+
+    float32x4_t vacc[8];
+    float16x8_t vrow[4];
+    float32x4_t vx;
+    size_t j, k;
+
+    // 32 columns (one cache line of weights per row) are accumulated in 8 registers at a time
+    for(j = 0; j+32 <= cols; j+=32) {
+        for(uint8_t a = 0; a < 8; a++) { vacc[a] = vdupq_n_f32(0); }
+
+        const float16_t *w = &(mat1->d[j]);
+        for(k = 0; k < rows; k++) {
+            vx = vld1q_dup_f32(&(vec0->d[k]));
+            vrow[0] = vld1q_f16(w);
+            vrow[1] = vld1q_f16(w + 8);
+            vrow[2] = vld1q_f16(w + 16);
+            vrow[3] = vld1q_f16(w + 24);
+
+            vacc[0] = vfmaq_f32(vacc[0], vx, vcvt_f32_f16(vget_low_f16(vrow[0])));
+            vacc[1] = vfmaq_f32(vacc[1], vx, vcvt_high_f32_f16(vrow[0]));
+            vacc[2] = vfmaq_f32(vacc[2], vx, vcvt_f32_f16(vget_low_f16(vrow[1])));
+            vacc[3] = vfmaq_f32(vacc[3], vx, vcvt_high_f32_f16(vrow[1]));
+            vacc[4] = vfmaq_f32(vacc[4], vx, vcvt_f32_f16(vget_low_f16(vrow[2])));
+            vacc[5] = vfmaq_f32(vacc[5], vx, vcvt_high_f32_f16(vrow[2]));
+            vacc[6] = vfmaq_f32(vacc[6], vx, vcvt_f32_f16(vget_low_f16(vrow[3])));
+            vacc[7] = vfmaq_f32(vacc[7], vx, vcvt_high_f32_f16(vrow[3]));
+            w += cols;
+        }
+        for(uint8_t a = 0; a < 8; a++) { vst1q_f32(&(out0->d[j + a*4]), vacc[a]); }
+    }
+    for(j; j+8 <= cols; j+=8) {
+        vacc[0] = vdupq_n_f32(0);
+        vacc[1] = vdupq_n_f32(0);
+
+        const float16_t *w = &(mat1->d[j]);
+        for(k = 0; k < rows; k++) {
+            vx = vld1q_dup_f32(&(vec0->d[k]));
+            vrow[0] = vld1q_f16(w);
+            vacc[0] = vfmaq_f32(vacc[0], vx, vcvt_f32_f16(vget_low_f16(vrow[0])));
+            vacc[1] = vfmaq_f32(vacc[1], vx, vcvt_high_f32_f16(vrow[0]));
+            w += cols;
+        }
+        vst1q_f32(&(out0->d[j]), vacc[0]);
+        vst1q_f32(&(out0->d[j + 4]), vacc[1]);
+    }
+
+    // Leftover columns
+    float32_t acc;
+    for(j; j < cols; j++) {
+        acc = 0;
+        for(k = 0; k < rows; k++) { acc += vec0->d[k] * (float32_t)mat1->d[k*cols + j]; }
+        out0->d[j] = acc;
+    }
+}
+
+// Matrix by Vector Multiplication; Rows of `mat0` are processed 4 at a time with one vector accumulator each,
+// so the horizontal reductions happen once per row (combined with pairwise additions) instead of once per 4 columns
 void multMatByVec(matrix32f_t *mat0, matrix32f_t *vec1, matrix32f_t *out0) {
 #ifdef DEBUG
     // In-place multiplication isn't defined, unlike other functions
     if(out0 == NULL) { printf("Error in multMatByVec: out0==NULL\n"); return; }
-    if(mat0->d == NULL || vec1->d == NULL || out0->d == NULL) { printf("Error in multMatByVec: (mat0->d == NULL || vec1->d == NULL || out0->d == NULL)\n"); }
+    if(mat0->d == NULL || vec1->d == NULL || out0->d == NULL) { printf("Error in multMatByVec: (mat0->d == NULL || vec1->d == NULL || out0->d == NULL)\n"); return; }
     // Check vec1 is actually a vector
     if((vec1->w!=1) && (vec1->h!=1)) { printf("Error in multMatByVec: (vec1->w!=1) && (vec1->h!=1)\n"); return; }
     // Find vec1's length and check out0 is appropriately sized
     size_t vec_dim = (vec1->w > vec1->h) ? vec1->w : vec1->h;
     if((out0->w != 1) || (mat0->h != out0->h)) { printf("Error in multMatByVec: (vec_dim != out0->w) || (mat0->h != out0->h)\n"); return; }
     if(vec_dim != mat0->w) { printf("Error in multMatByVec: mat0->w != vec_dim\n"); return; }
-    // This function should be used only on multiple-of-4 vectors/matrices; Check this as well
-    if((vec_dim % 4 != 0) || (mat0->w % 4 != 0)) { printf("Error in multMatByVec: (vec_dim % 4 != 0) || (mat0->w % 4 != 0)\n"); return; }
 #endif
-    // `out0` must be all zeros
-    clearMatrix(out0);
+    size_t rows = mat0->h, cols = mat0->w;
+    size_t row, col;
+
+    float32x4_t vvec, vacc[4];
+    const float32_t *r0, *r1, *r2, *r3;
+    float32_t tail[4];
+
+    for(row = 0; row+4 <= rows; row+=4) {
+        r0 = &(mat0->d[row*cols]);
+        r1 = r0 + cols;
+        r2 = r1 + cols;
+        r3 = r2 + cols;
+
+        for(uint8_t a = 0; a < 4; a++) { vacc[a] = vdupq_n_f32(0); }
+        for(col = 0; col+4 <= cols; col+=4) {
+            vvec = vld1q_f32(&(vec1->d[col]));
+            vacc[0] = vfmaq_f32(vacc[0], vld1q_f32(r0 + col), vvec);
+            vacc[1] = vfmaq_f32(vacc[1], vld1q_f32(r1 + col), vvec);
+            vacc[2] = vfmaq_f32(vacc[2], vld1q_f32(r2 + col), vvec);
+            vacc[3] = vfmaq_f32(vacc[3], vld1q_f32(r3 + col), vvec);
+        }
 
-    float32x4_t vvec, vmat, vtemp, vout0;
+        // [sum(acc0), sum(acc1), sum(acc2), sum(acc3)]
+        vacc[0] = vpaddq_f32(vpaddq_f32(vacc[0], vacc[1]), vpaddq_f32(vacc[2], vacc[3]));
 
-    // Move through parts of `vec1`
-    for(size_t pos_in_vec = 0; pos_in_vec < mat0->w; pos_in_vec +=4) {
-        vvec = vld1q_f32(&(vec1->d[pos_in_vec]));
+        // Leftover columns
+        tail[0] = 0; tail[1] = 0; tail[2] = 0; tail[3] = 0;
+        for(col; col < cols; col++) {
+            tail[0] += r0[col] * vec1->d[col];
+            tail[1] += r1[col] * vec1->d[col];
+            tail[2] += r2[col] * vec1->d[col];
+            tail[3] += r3[col] * vec1->d[col];
+        }
+        vst1q_f32(&(out0->d[row]), vaddq_f32(vacc[0], vld1q_f32(tail)));
+    }
 
-        // Move through rows of `mat0`
-        for(size_t row_idx = 0; row_idx < mat0->h; row_idx++) {
-            size_t pos_in_mat = pos_in_vec + row_idx*mat0->w;
-            vmat = vld1q_f32(&(mat0->d[pos_in_mat]));
+    // Leftover rows
+    for(row; row < rows; row++) {
+        r0 = &(mat0->d[row*cols]);
+        vacc[0] = vdupq_n_f32(0);
+        for(col = 0; col+4 <= cols; col+=4) { vacc[0] = vfmaq_f32(vacc[0], vld1q_f32(r0 + col), vld1q_f32(&(vec1->d[col]))); }
 
-            vtemp = vmulq_f32(vvec, vmat);          // multiply vector elements with matrix elements
-            out0->d[row_idx] += vaddvq_f32(vtemp);  // "across-vector" addition of products and addition to output's vector element
+        tail[0] = vaddvq_f32(vacc[0]);
+        for(col; col < cols; col++) { tail[0] += r0[col] * vec1->d[col]; }
+        out0->d[row] = tail[0];
+    }
+}
+
+// Packs rows [row0, row0+mc) and columns [k0, k0+kc) of `a` into `GEMM_MR`-row micro-panels.
+// Within a micro-panel the GEMM_MR elements of each column are stored next to each other,
+// so the micro-kernel reads the panel sequentially. Rows past the end of `a` are zero-padded.
+static void gemmPackA(matrix32f_t *a, size_t row0, size_t mc, size_t k0, size_t kc, float32_t *buffer) {
+    for(size_t ir = 0; ir < mc; ir += GEMM_MR) {
+        for(size_t r = 0; r < GEMM_MR; r++) {
+            float32_t *dest = buffer + r;
+            // Zero-pad rows beyond `mc`
+            if(ir + r >= mc) {
+                for(size_t k = 0; k < kc; k++) { dest[k*GEMM_MR] = 0.00; }
+                continue;
+            }
+
+            float32_t *src = &(a->d[(row0 + ir + r)*a->w + k0]);
+            for(size_t k = 0; k < kc; k++) { dest[k*GEMM_MR] = src[k]; }
         }
+        buffer += kc*GEMM_MR;
     }
+}
 
-    /* For the left-over vector part
-    for(pos_in_vec; pos_in_vec < mat0->w; pos_in_vec++) {
-        // TODO
+// Packs rows [k0, k0+kc) and columns [col0, col0+nc) of `b` into `GEMM_NR`-column micro-panels.
+// Each row of a micro-panel is GEMM_NR contiguous floats; columns past the end of `b` are zero-padded.
+static void gemmPackB(matrix32f_t *b, size_t k0, size_t kc, size_t col0, size_t nc, float32_t *buffer) {
+    float32x4_t vreg[2];
+
+    for(size_t jr = 0; jr < nc; jr += GEMM_NR) {
+        size_t cols = (nc - jr < GEMM_NR) ? nc - jr : GEMM_NR;
+        float32_t *src = &(b->d[k0*b->w + col0 + jr]);
+
+        // Full micro-panel; copy whole rows with vector registers
+        if(cols == GEMM_NR) {
+            for(size_t k = 0; k < kc; k++) {
+                vreg[0] = vld1q_f32(src);
+                vreg[1] = vld1q_f32(src + 4);
+                vst1q_f32(buffer,     vreg[0]);
+                vst1q_f32(buffer + 4, vreg[1]);
+                src += b->w;
+                buffer += GEMM_NR;
+            }
+            continue;
+        }
+
+        // Last micro-panel of the matrix; copy valid columns and zero the rest
+        for(size_t k = 0; k < kc; k++) {
+            size_t c;
+            for(c = 0; c < cols; c++)    { buffer[c] = src[c]; }
+            for(c; c < GEMM_NR; c++)     { buffer[c] = 0.00; }
+            src += b->w;
+            buffer += GEMM_NR;
+        }
     }
-    */
+}
+
+// Multiplies a packed GEMM_MRxkc micro-panel of A with a packed kcxGEMM_NR micro-panel of B and adds the
+// result to the `mr`x`nr` tile of C at `c` (with a row stride of `ldc`).
+// The full 8x8 accumulator tile is kept in 16 vector registers throughout the `kc` loop.
+static void gemmMicroKernel(size_t kc, const float32_t *a, const float32_t *b, float32_t *c, size_t ldc, size_t mr, size_t nr) {
+    float32x4_t va[2], vb[2];
+    float32x4_t vc[GEMM_MR][2];
+
+    for(uint8_t r = 0; r < GEMM_MR; r++) {
+        vc[r][0] = vld1q_dup_f32(&fzero);
+        vc[r][1] = vld1q_dup_f32(&fzero);
+    }
+
+    // _laneq_ instructions need a constant lane argument, so the row updates are unrolled with a macro
+#define GEMM_FMA_ROW(r, vreg, lane) \
+    vc[r][0] = vfmaq_laneq_f32(vc[r][0], vb[0], vreg, lane); \
+    vc[r][1] = vfmaq_laneq_f32(vc[r][1], vb[1], vreg, lane);
+
+    for(size_t k = 0; k < kc; k++) {
+        va[0] = vld1q_f32(a);
+        va[1] = vld1q_f32(a + 4);
+        vb[0] = vld1q_f32(b);
+        vb[1] = vld1q_f32(b + 4);
+
+        GEMM_FMA_ROW(0, va[0], 0); GEMM_FMA_ROW(1, va[0], 1);
+        GEMM_FMA_ROW(2, va[0], 2); GEMM_FMA_ROW(3, va[0], 3);
+        GEMM_FMA_ROW(4, va[1], 0); GEMM_FMA_ROW(5, va[1], 1);
+        GEMM_FMA_ROW(6, va[1], 2); GEMM_FMA_ROW(7, va[1], 3);
+
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+#undef GEMM_FMA_ROW
+
+    // Full tile; accumulate directly into C
+    if(mr == GEMM_MR && nr == GEMM_NR) {
+        for(uint8_t r = 0; r < GEMM_MR; r++) {
+            vst1q_f32(c,     vaddq_f32(vld1q_f32(c),     vc[r][0]));
+            vst1q_f32(c + 4, vaddq_f32(vld1q_f32(c + 4), vc[r][1]));
+            c += ldc;
+        }
+        return;
+    }
+
+    // Edge tile; spill the accumulators and only add the valid part
+    float32_t tile[GEMM_MR*GEMM_NR];
+    for(uint8_t r = 0; r < GEMM_MR; r++) {
+        vst1q_f32(tile + r*GEMM_NR,     vc[r][0]);
+        vst1q_f32(tile + r*GEMM_NR + 4, vc[r][1]);
+    }
+    for(size_t r = 0; r < mr; r++) {
+        for(size_t j = 0; j < nr; j++) { c[j] += tile[r*GEMM_NR + j]; }
+        c += ldc;
+    }
+}
+
+// Sizes (floats) of the packing buffers of an (m x k) * (k x n) product; Only as large as the problem requires.
+// The buffer of `in0` is rounded up to a cache line so the buffer of `in1` starts on one in an aligned workspace.
+static void gemmPackSizes(size_t m, size_t n, size_t k, size_t *a_floats, size_t *b_floats) {
+    size_t mc_max = (m < GEMM_MC) ? ((m + GEMM_MR - 1) / GEMM_MR) * GEMM_MR : GEMM_MC;
+    size_t nc_max = (n < GEMM_NC) ? ((n + GEMM_NR - 1) / GEMM_NR) * GEMM_NR : GEMM_NC;
+    size_t kc_max = (k < GEMM_KC) ? k : GEMM_KC;
+    size_t line = MATRIX_ALIGNMENT / sizeof(float32_t);
+
+    *a_floats = ((mc_max * kc_max + line - 1) / line) * line;
+    *b_floats = nc_max * kc_max;
+}
+
+size_t matrixMultiplyWsFloats(size_t m, size_t n, size_t k) {
+    size_t a_floats, b_floats;
+    gemmPackSizes(m, n, k, &a_floats, &b_floats);
+    return a_floats + b_floats;
 }
 
 // Matrix multiplication; out0.h=in0.h, out10.w=in1.w
-// Not implemented as it was not required.
+// Allocates the packing buffers and runs `matrixMultiplyWs`
 void matrixMultiply(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0) {
-    return;
+    // A single row gains nothing from packing
+    if(in0->h == 1) { multVecByMat(in0, in1, out0); return; }
+
+    float32_t *work = (float32_t*)malloc(matrixMultiplyWsFloats(in0->h, in1->w, in0->w) * sizeof(float32_t));
+    if(work == NULL) {
+#ifdef DEBUG
+        printf("Error in matrixMultiply: Failed to allocate packing buffers.\n");
+#endif
+        return;
+    }
+    matrixMultiplyWs(in0, in1, out0, work);
+    free(work);
+}
+
+// Blocked GEMM: `in1` is packed in GEMM_KCxGEMM_NC blocks (kept in L2), `in0` in GEMM_MCxGEMM_KC blocks
+// and an 8x8 register-tiled micro-kernel walks the packed panels. Edges are zero-padded during packing.
+void matrixMultiplyWs(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0, float32_t *work) {
+#ifdef DEBUG
+    if(out0 == NULL) { printf("Error in matrixMultiplyWs: out0==NULL\n"); return; }
+    if(in0->d == NULL || in1->d == NULL || out0->d == NULL) { printf("Error in matrixMultiplyWs: (in0->d == NULL || in1->d == NULL || out0->d == NULL)\n"); return; }
+    if(in0->w != in1->h) { printf("Error in matrixMultiplyWs: in0->w != in1->h\n"); return; }
+    if((out0->h != in0->h) || (out0->w != in1->w)) { printf("Error in matrixMultiplyWs: (out0->h != in0->h) || (out0->w != in1->w)\n"); return; }
+    if(work == NULL && in0->h != 1) { printf("Error in matrixMultiplyWs: work==NULL\n"); return; }
+#endif
+    // A single row gains nothing from packing
+    if(in0->h == 1) { multVecByMat(in0, in1, out0); return; }
+
+    size_t m = in0->h;
+    size_t n = in1->w;
+    size_t k = in0->w;
+
+    size_t a_floats, b_floats;
+    gemmPackSizes(m, n, k, &a_floats, &b_floats);
+    float32_t *apack = work;
+    float32_t *bpack = work + a_floats;
+
+    // Micro-kernels accumulate into `out0`
+    clearMatrix(out0);
+
+    for(size_t jc = 0; jc < n; jc += GEMM_NC) {
+        size_t nc = (n - jc < GEMM_NC) ? n - jc : GEMM_NC;
+
+        for(size_t pc = 0; pc < k; pc += GEMM_KC) {
+            size_t kc = (k - pc < GEMM_KC) ? k - pc : GEMM_KC;
+            gemmPackB(in1, pc, kc, jc, nc, bpack);
+
+            for(size_t ic = 0; ic < m; ic += GEMM_MC) {
+                size_t mc = (m - ic < GEMM_MC) ? m - ic : GEMM_MC;
+                gemmPackA(in0, ic, mc, pc, kc, apack);
+
+                // Walk the packed block one micro-tile at a time
+                for(size_t jr = 0; jr < nc; jr += GEMM_NR) {
+                    size_t nr = (nc - jr < GEMM_NR) ? nc - jr : GEMM_NR;
+
+                    for(size_t ir = 0; ir < mc; ir += GEMM_MR) {
+                        size_t mr = (mc - ir < GEMM_MR) ? mc - ir : GEMM_MR;
+
+                        gemmMicroKernel(kc, apack + ir*kc, bpack + jr*kc,
+                            &(out0->d[(ic + ir)*n + jc + jr]), n, mr, nr);
+                    }
+                }
+            }
+        }
+    }
 }
 
 // Hadamard product (Elementwise multiplication)
@@ -183,6 +809,77 @@ void hadamardProduct(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0) {
     for(i; i < len; i++) { output[i] = in0->d[i]*in1->d[i]; }
 }
 
+void affineTransform(matrix32f_t *in0, matrix32f_t *scale, matrix32f_t *shift, matrix32f_t *out0) {
+#ifdef DEBUG
+    if(in0->d == NULL || scale->d == NULL || shift->d == NULL) { printf("Error in affineTransform: (in0->d == NULL || scale->d == NULL || shift->d == NULL)\n"); return; }
+    if((scale->w*scale->h != 1 && scale->w*scale->h != in0->w) || (shift->w*shift->h != 1 && shift->w*shift->h != in0->w)) {
+        printf("Error in affineTransform: scale and shift should have 1 or in0->w elements\n");
+        return;
+    }
+    if(out0 != NULL && (out0->w != in0->w || out0->h != in0->h)) { printf("Error in affineTransform: (out0->w != in0->w || out0->h != in0->h)\n"); return; }
+#endif
+    // If `out0` is NULL store result in `in0`
+    float32_t *output = (out0 == NULL) ? in0->d : out0->d;
+    size_t rows = in0->h, cols = in0->w;
+    // Vectors are indexed per column; Single values are broadcast
+    uint8_t scale_vec = (scale->w*scale->h != 1), shift_vec = (shift->w*shift->h != 1);
+
+    float32x4_t vscale = vld1q_dup_f32(scale->d), vshift = vld1q_dup_f32(shift->d);
+    size_t i, r;
+    for(i = 0; i+4 <= cols; i+=4) {
+        if(scale_vec) { vscale = vld1q_f32(&scale->d[i]); }
+        if(shift_vec) { vshift = vld1q_f32(&shift->d[i]); }
+        for(r = 0; r < rows; r++) { vst1q_f32(&output[r*cols + i], vfmaq_f32(vshift, vld1q_f32(&in0->d[r*cols + i]), vscale)); }
+    }
+    float32_t s, b;
+    for(i; i < cols; i++) {
+        s = scale->d[scale_vec ? i : 0];
+        b = shift->d[shift_vec ? i : 0];
+        for(r = 0; r < rows; r++) { output[r*cols + i] = in0->d[r*cols + i]*s + b; }
+    }
+}
+
+// Fixed point Hadamard product; the result is stored in `out0`'s format (`in0`'s if `out0` is NULL)
+void hadamardProduct_q16(matrix16q_t *in0, matrix16q_t *in1, matrix16q_t *out0) {
+#ifdef DEBUG
+    if((in0->w != in1->w) || (in0->h != in1->h)) { printf("Error in hadamardProduct_q16: (in0->w != in1->w) || (in0->h != in1->h)\n"); return; }
+#endif
+    matrix16q_t *out = (out0 == NULL) ? in0 : out0;
+    size_t len = in0->w * in0->h;
+
+    // Products have (15-in0.int_bits) + (15-in1.int_bits) fractional bits
+    int32_t shift = (15 - in0->int_bits) + (15 - in1->int_bits) - (15 - out->int_bits);
+    int32x4_t vshift = vdupq_n_s32(-shift);
+
+    int16x8_t vin0, vin1;
+    size_t i;
+    for(i = 0; i+8 <= len; i+=8) {
+        vin0 = vld1q_s16(&(in0->d[i]));
+        vin1 = vld1q_s16(&(in1->d[i]));
+        vst1q_s16(&(out->d[i]), vcombine_s16(
+            vqmovn_s32(vqrshlq_s32(vmull_s16(vget_low_s16(vin0), vget_low_s16(vin1)), vshift)),
+            vqmovn_s32(vqrshlq_s32(vmull_high_s16(vin0, vin1), vshift))
+        ));
+    }
+    for(i; i < len; i++) { out->d[i] = q16Saturate16(q16RoundingShift((int32_t)in0->d[i] * in1->d[i], shift)); }
+}
+
+// Fixed point saturating sum; all matrices should have the same format
+void matrixSum_q16(matrix16q_t *in0, matrix16q_t *in1, matrix16q_t *out0) {
+#ifdef DEBUG
+    if((in0->w != in1->w) || (in0->h != in1->h)) { printf("Error in matrixSum_q16: (in0->w != in1->w) || (in0->h != in1->h)\n"); return; }
+    if((in0->int_bits != in1->int_bits) || (out0 != NULL && out0->int_bits != in0->int_bits)) { printf("Error in matrixSum_q16: Formats of arguments don't match.\n"); return; }
+#endif
+    int16_t *output = (out0 == NULL) ? in0->d : out0->d;
+    size_t len = in0->w * in0->h;
+
+    size_t i;
+    for(i = 0; i+8 <= len; i+=8) {
+        vst1q_s16(&(output[i]), vqaddq_s16(vld1q_s16(&(in0->d[i])), vld1q_s16(&(in1->d[i]))));
+    }
+    for(i; i < len; i++) { output[i] = q16Saturate16((int32_t)in0->d[i] + in1->d[i]); }
+}
+
 // Elemetwise power of 2
 void elementwisePow2(matrix32f_t *in0, matrix32f_t *out0) {
 #ifdef DEBUG
@@ -227,10 +924,25 @@ void relu(matrix32f_t *in0, matrix32f_t *out0) {
         vst1q_f32(&(output[i]), vin);
     }
     for(i; i < len; i++) {
-        in0->d[i] = (in0->d[i] < 0)? 0.0 : in0->d[i];
+        output[i] = (in0->d[i] < 0)? 0.0 : in0->d[i];
     }
 }
 
+void relu_q16(matrix16q_t *in0, matrix16q_t *out0) {
+#ifdef DEBUG
+    if(in0->d == NULL) { printf("Error in relu_q16: in0->d==NULL\n"); return; }
+    if(out0 != NULL && ((in0->w != out0->w) || (in0->h != out0->h))) { printf("Error in relu_q16: (in0->w != out0->w) || (in0->h != out0->h)\n"); return; }
+#endif
+    matrix16q_t *out = (out0 == NULL) ? in0 : out0;
+    size_t len = in0->w * in0->h;
+
+    int16x8_t vzero = vdupq_n_s16(0);
+    size_t i;
+    for(i = 0; i+8 <= len; i+=8) { vst1q_s16(&(out->d[i]), vmaxq_s16(vld1q_s16(&(in0->d[i])), vzero)); }
+    for(i; i < len; i++) { out->d[i] = (in0->d[i] < 0) ? 0 : in0->d[i]; }
+    out->int_bits = in0->int_bits;
+}
+
 // Complex Matrix Operations - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void squaredMagnitude(matrix32c_t *in0, matrix32f_t *out0) {
 #ifdef DEBUG
@@ -445,6 +1157,101 @@ void hadamardProduct_cbr(matrix32c_t *cin0, matrix32f_t *rin1, matrix32c_t *out0
     }
 }
 
+// Scales every complex number of `cin0` to the magnitude in `mask`, keeping its phase: out = X * mask/|X|
+void applyMagnitudeMask_c(matrix32c_t *cin0, matrix32f_t *mask, matrix32c_t *out0) {
+    size_t len = cin0->w * cin0->h;
+#ifdef DEBUG
+    if(cin0->d == NULL || mask->d == NULL) { printf("Error in applyMagnitudeMask_c: (cin0->d == NULL || mask->d == NULL)\n"); return; }
+    if(mask->w * mask->h != len) { printf("Error in applyMagnitudeMask_c: Mismatched input lengths\n"); return; }
+    // Note: In-place operation is allowed
+    if(out0 != NULL) {
+        if(out0->d == NULL) { printf("Error in applyMagnitudeMask_c: out0->d == NULL\n"); return; }
+        if(out0->w != cin0->w || out0->h != cin0->h) { printf("Error in applyMagnitudeMask_c: (out0->w != cin0->w || out0->h != cin0->h)\n"); return; }
+    }
+#endif
+    float32_t *indf  = (float32_t*)cin0->d;
+    float32_t *outdf = (out0 != NULL) ? (float32_t*)out0->d : indf;
+
+    // 1/|X| is an estimate refined by one Newton-Raphson step (< 3e-5 relative error). Bins with |X| = 0 have
+    // no phase; they are given the phase 0 (out = mask), like angle(0) = 0.
+    const float32x4_t vmin = vdupq_n_f32(1e-30f);
+    float32x4x2_t vc;
+    float32x4_t vpow, vrsqrt, vscale;
+    uint32x4_t vnonzero;
+    size_t i;
+    for(i = 0; i+4 <= len; i+=4) {
+        vc = vld2q_f32(indf + 2*i);
+        vpow = vmulq_f32(vc.val[0], vc.val[0]);
+        vpow = vmlaq_f32(vpow, vc.val[1], vc.val[1]);
+        vnonzero = vcgtq_f32(vpow, vmin);
+
+        vrsqrt = vrsqrteq_f32(vpow);
+        vrsqrt = vmulq_f32(vrsqrt, vrsqrtsq_f32(vmulq_f32(vpow, vrsqrt), vrsqrt));
+        vscale = vmulq_f32(vld1q_f32(&mask->d[i]), vrsqrt);
+
+        vc.val[0] = vbslq_f32(vnonzero, vmulq_f32(vc.val[0], vscale), vld1q_f32(&mask->d[i]));
+        vc.val[1] = vbslq_f32(vnonzero, vmulq_f32(vc.val[1], vscale), vdupq_n_f32(0));
+        vst2q_f32(outdf + 2*i, vc);
+    }
+
+    // Handle leftovers (the Nyquist bin of a spectrum)
+    for(i; i < len; i++) {
+        float32_t re = indf[2*i], im = indf[2*i+1];
+        float32_t pow = re*re + im*im;
+        float32_t scale = (pow > 1e-30f) ? mask->d[i] / sqrtf(pow) : 0;
+        outdf[2*i]   = (pow > 1e-30f) ? re * scale : mask->d[i];
+        outdf[2*i+1] = im * scale;
+    }
+}
+
+void affineTransform_c(matrix32c_t *cin0, matrix32f_t *scale, matrix32c_t *shift, matrix32c_t *out0) {
+#ifdef DEBUG
+    if(cin0->d == NULL || scale->d == NULL) { printf("Error in affineTransform_c: (cin0->d == NULL || scale->d == NULL)\n"); return; }
+    if((scale->w*scale->h != 1 && scale->w*scale->h != cin0->w) || (shift != NULL && shift->w*shift->h != 1 && shift->w*shift->h != cin0->w)) {
+        printf("Error in affineTransform_c: scale and shift should have 1 or cin0->w elements\n");
+        return;
+    }
+    if(out0 != NULL && (out0->w != cin0->w || out0->h != cin0->h)) { printf("Error in affineTransform_c: (out0->w != cin0->w || out0->h != cin0->h)\n"); return; }
+#endif
+    float32_t *indf = (float32_t*)cin0->d;
+    float32_t *outdf = (out0 != NULL) ? (float32_t*)out0->d : indf;
+    size_t rows = cin0->h, cols = cin0->w;
+    uint8_t scale_vec = (scale->w*scale->h != 1);
+    // A NULL shift is a shift by 0
+    float32_t zero[2] = { 0, 0 };
+    float32_t *shdf = (shift != NULL) ? (float32_t*)shift->d : zero;
+    uint8_t shift_vec = (shift != NULL && shift->w*shift->h != 1);
+
+    // vld2 de-interleaves 4 complex numbers; Both parts are scaled by the same (real) factor
+    float32x4_t vscale = vld1q_dup_f32(scale->d);
+    float32x4x2_t vshift, vin;
+    vshift.val[0] = vdupq_n_f32(shdf[0]);
+    vshift.val[1] = vdupq_n_f32(shdf[1]);
+    size_t i, r, idx;
+    for(i = 0; i+4 <= cols; i+=4) {
+        if(scale_vec) { vscale = vld1q_f32(&scale->d[i]); }
+        if(shift_vec) { vshift = vld2q_f32(&shdf[2*i]); }
+        for(r = 0; r < rows; r++) {
+            idx = 2*(r*cols + i);
+            vin = vld2q_f32(&indf[idx]);
+            vin.val[0] = vfmaq_f32(vshift.val[0], vin.val[0], vscale);
+            vin.val[1] = vfmaq_f32(vshift.val[1], vin.val[1], vscale);
+            vst2q_f32(&outdf[idx], vin);
+        }
+    }
+    float32_t s, b_re, b_im;
+    for(i; i < cols; i++) {
+        s = scale->d[scale_vec ? i : 0];
+        b_re = shdf[shift_vec ? 2*i : 0];
+        b_im = shdf[shift_vec ? 2*i+1 : 1];
+        for(r = 0; r < rows; r++) {
+            idx = 2*(r*cols + i);
+            outdf[idx]   = indf[idx]*s + b_re;
+            outdf[idx+1] = indf[idx+1]*s + b_im;
+        }
+    }
+}
+
 // Unused function; Should be replaced by `squaredMagnitude`
 void elementwisePow2_complex(matrix32c_t *in0) {
     #ifdef DEBUG
@@ -2,6 +2,7 @@
 
 #include "matrix_math.h"
 #include <arm_neon.h>
+#include <math.h>   // sqrtf
 
 #ifdef DEBUG
 #include <stdio.h>  // for debug messages
@@ -30,7 +31,7 @@ void matrixDiff(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0) {
 
     size_t len = in0->w * in0->h;
     size_t i = 0;
-    for(i; i<len; i++) { output[i] = in0->d[i] + in1->d[i]; }
+    for(i; i<len; i++) { output[i] = in0->d[i] - in1->d[i]; }
 }
 
 // Vector by Matrix Multiplication; if `in0.h == 0` some loops can be skipped
@@ -56,7 +57,148 @@ void multVecByMat(matrix32f_t *vec0, matrix32f_t *mat1, matrix32f_t *out0) {
     }
 }
 
-// Vector by Matrix Multiplication; (when `vec0.h == 1` the vmaq optimization breaks)
+// Activation of `multVecByMatEx`'s epilogue
+static inline float32_t activationScalar(float32_t in, uint8_t act, lut32f_t *act_lut) {
+    switch(act) {
+        case ACTIVATION_RELU:       return (in < 0) ? 0 : in;
+        case ACTIVATION_TANH:       return (act_lut != NULL) ? clampingLUTScalar(in, act_lut) : tanhApproxScalar(in);
+        case ACTIVATION_SIGMOID:    return (act_lut != NULL) ? clampingLUTScalar(in, act_lut) : sigmoidApproxScalar(in);
+        default:                    return in;
+    }
+}
+
+// Vector by Matrix Multiplication with bias and activation; Each output starts from its bias and
+// is activated once its column is done
+void multVecByMatEx(matrix32f_t *vec0, matrix32f_t *mat1, matrix32f_t *bias, uint8_t act, lut32f_t *act_lut, matrix32f_t *out0) {
+#ifdef DEBUG
+    if(out0 == NULL) { printf("Error in multVecByMatEx: out0==NULL\n"); return; }
+    if((vec0->w!=1) && (vec0->h!=1)) { printf("Error in multVecByMatEx: (vec0->w!=1) && (vec0->h!=1)\n"); return; }
+    size_t vec_dim = (vec0->w > vec0->h) ? vec0->w : vec0->h;
+    if((out0->h != 1) || (mat1->w != out0->w)) { printf("Error in multVecByMatEx: (out0->h != 1) || (mat1->w != out0->w)\n"); return; }
+    if(vec_dim != mat1->h) { printf("Error in multVecByMatEx: vec_dim != mat1->h\n"); return; }
+    if(bias != NULL && bias->h*bias->w != mat1->w) { printf("Error in multVecByMatEx: The bias should have mat1->w elements\n"); return; }
+    if(act > ACTIVATION_SIGMOID) { printf("Error in multVecByMatEx: Unknown activation %d\n", act); return; }
+#endif
+    float32_t acc;
+    for(size_t mat_col = 0; mat_col < mat1->w; mat_col++) {
+        acc = (bias != NULL) ? bias->d[mat_col] : 0;
+        for(size_t vec_idx = 0; vec_idx < mat1->h; vec_idx++) {
+            acc += vec0->d[vec_idx] * mat1->d[mat_col + mat1->w*vec_idx];
+        }
+        out0->d[mat_col] = activationScalar(acc, act, act_lut);
+    }
+}
+
+int foldBatchNorm(matrix32f_t *fc_w, matrix32f_t *mean, matrix32f_t *gammavar, matrix32f_t *beta, matrix32f_t *fused_w, matrix32f_t *fused_bias) {
+#ifdef DEBUG
+    if(fc_w->d == NULL || mean->d == NULL || gammavar->d == NULL || beta->d == NULL) { printf("Error in foldBatchNorm: Input matrices are not initialized.\n"); return 1; }
+    if(mean->h*mean->w != fc_w->w || gammavar->h*gammavar->w != fc_w->w || beta->h*beta->w != fc_w->w) {
+        printf("Error in foldBatchNorm: mean, gammavar and beta should have fc_w->w elements\n");
+        return 1;
+    }
+#endif
+    size_t rows = fc_w->h, cols = fc_w->w;
+    if(fused_w != fc_w && newMatrix32f(rows, cols, fused_w)) { return 1; }
+    if(newMatrix32f(1, cols, fused_bias)) {
+        if(fused_w != fc_w) { deleteMatrix(fused_w); }
+        return 1;
+    }
+
+    for(size_t i = 0; i < cols; i++) { fused_bias->d[i] = beta->d[i] - mean->d[i]*gammavar->d[i]; }
+    for(size_t k = 0; k < rows; k++) {
+        for(size_t i = 0; i < cols; i++) { fused_w->d[k*cols + i] = fc_w->d[k*cols + i]*gammavar->d[i]; }
+    }
+    return 0;
+}
+
+// Quantizes `len` floats to int8 with a single (symmetric) scale; Returns the scale, or 0 if all inputs are 0
+static float32_t quantizeVector8(const float32_t *in, size_t len, int8_t *out) {
+    float32_t max = 0;
+    for(size_t i = 0; i < len; i++) { max = (fabsf(in[i]) > max) ? fabsf(in[i]) : max; }
+    if(max == 0) { return 0; }
+
+    float32_t ftemp;
+    for(size_t i = 0; i < len; i++) {
+        ftemp = in[i] * (127.0 / max);
+        out[i] = (int8_t)(ftemp + ((ftemp < 0) ? -0.5 : 0.5));
+    }
+    return max / 127.0;
+}
+
+// Quantized Vector by Matrix Multiplication; int32 accumulation, dequantized once per output
+void multVecByMat_q8(matrix32f_t *vec0, matrix8q_t *mat1, matrix32f_t *out0) {
+#ifdef DEBUG
+    if(out0 == NULL) { printf("Error in multVecByMat_q8: out0==NULL\n"); return; }
+    if((vec0->w!=1) && (vec0->h!=1)) { printf("Error in multVecByMat_q8: (vec0->w!=1) && (vec0->h!=1)\n"); return; }
+    size_t vec_dim = (vec0->w > vec0->h) ? vec0->w : vec0->h;
+    if((out0->h != 1) || (mat1->w != out0->w)) { printf("Error in multVecByMat_q8: (out0->h != 1) || (mat1->w != out0->w)\n"); return; }
+    if(vec_dim != mat1->h) { printf("Error in multVecByMat_q8: vec_dim != mat1->h\n"); return; }
+#endif
+    size_t rows = mat1->h, cols = mat1->w;
+
+    int8_t vec_q[rows];
+    float32_t vec_scale = quantizeVector8(vec0->d, rows, vec_q);
+
+    int32_t acc;
+    for(size_t mat_col = 0; mat_col < cols; mat_col++) {
+        acc = 0;
+        for(size_t vec_idx = 0; vec_idx < rows; vec_idx++) {
+            acc += (int32_t)vec_q[vec_idx] * mat1->d[mat_col + cols*vec_idx];
+        }
+        out0->d[mat_col] = (float32_t)acc * mat1->scale[mat_col] * vec_scale;
+    }
+}
+
+// Saturating scalar helpers for the fixed point routines; they match the NEON instructions
+static inline int32_t q16Saturate32(int64_t x) { return (x > INT32_MAX) ? INT32_MAX : ((x < INT32_MIN) ? INT32_MIN : (int32_t)x); }
+static inline int16_t q16Saturate16(int64_t x) { return (x > INT16_MAX) ? INT16_MAX : ((x < INT16_MIN) ? INT16_MIN : (int16_t)x); }
+// Rounding shift right by `shift` (left if negative)
+static inline int64_t q16RoundingShift(int64_t x, int32_t shift) { return (shift > 0) ? ((x + ((int64_t)1 << (shift-1))) >> shift) : (x << -shift); }
+
+// Fixed point Vector by Matrix Multiplication; saturating int32 accumulation of doubled products
+void multVecByMat_q16(matrix16q_t *vec0, matrix16q_t *mat1, matrix16q_t *out0) {
+#ifdef DEBUG
+    if(out0 == NULL) { printf("Error in multVecByMat_q16: out0==NULL\n"); return; }
+    if((vec0->w!=1) && (vec0->h!=1)) { printf("Error in multVecByMat_q16: (vec0->w!=1) && (vec0->h!=1)\n"); return; }
+    size_t vec_dim = (vec0->w > vec0->h) ? vec0->w : vec0->h;
+    if((out0->h != 1) || (mat1->w != out0->w)) { printf("Error in multVecByMat_q16: (out0->h != 1) || (mat1->w != out0->w)\n"); return; }
+    if(vec_dim != mat1->h) { printf("Error in multVecByMat_q16: vec_dim != mat1->h\n"); return; }
+#endif
+    size_t rows = mat1->h, cols = mat1->w;
+    int32_t shift = (15 - vec0->int_bits) + (15 - mat1->int_bits) + 1 - (15 - out0->int_bits);
+
+    int32_t acc;
+    for(size_t mat_col = 0; mat_col < cols; mat_col++) {
+        acc = 0;
+        for(size_t vec_idx = 0; vec_idx < rows; vec_idx++) {
+            acc = q16Saturate32((int64_t)acc + 2*(int32_t)vec0->d[vec_idx]*mat1->d[mat_col + cols*vec_idx]);
+        }
+        out0->d[mat_col] = q16Saturate16(q16RoundingShift(acc, shift));
+    }
+}
+
+// Vector by Matrix Multiplication with half precision weights; float accumulation
+void multVecByMat_f16w(matrix32f_t *vec0, matrix16f_t *mat1, matrix32f_t *out0) {
+#ifdef DEBUG
+    if(out0 == NULL) { printf("Error in multVecByMat_f16w: out0==NULL\n"); return; }
+    if((vec0->w!=1) && (vec0->h!=1)) { printf("Error in multVecByMat_f16w: (vec0->w!=1) && (vec0->h!=1)\n"); return; }
+    size_t vec_dim = (vec0->w > vec0->h) ? vec0->w : vec0->h;
+    if((out0->h != 1) || (mat1->w != out0->w)) { printf("Error in multVecByMat_f16w: (out0->h != 1) || (mat1->w != out0->w)\n"); return; }
+    if(vec_dim != mat1->h) { printf("Error in multVecByMat_f16w: vec_dim != mat1->h\n"); return; }
+#endif
+    size_t rows = mat1->h, cols = mat1->w;
+
+    float32_t acc;
+    for(size_t mat_col = 0; mat_col < cols; mat_col++) {
+        acc = 0;
+        for(size_t vec_idx = 0; vec_idx < rows; vec_idx++) {
+            acc += vec0->d[vec_idx] * (float32_t)mat1->d[mat_col + cols*vec_idx];
+        }
+        out0->d[mat_col] = acc;
+    }
+}
+
+// Matrix by Vector Multiplication
 void multMatByVec(matrix32f_t *mat0, matrix32f_t *vec1, matrix32f_t *out0) {
 #ifdef DEBUG
     // In-place multiplication isn't defined, unlike other functions
@@ -67,8 +209,6 @@ void multMatByVec(matrix32f_t *mat0, matrix32f_t *vec1, matrix32f_t *out0) {
     size_t vec_dim = (vec1->w > vec1->h) ? vec1->w : vec1->h;
     if((out0->w != 1) || (mat0->h != out0->h)) { printf("Error in multMatByVec: (vec_dim != out0->w) || (mat0->h != out0->h)\n"); return; }
     if(vec_dim != mat0->w) { printf("Error in multMatByVec: mat0->w != vec_dim\n"); return; }
-    // This function should be used only on multiple-of-4 vectors/matrices; Check this as well
-    if((vec_dim % 4 != 0) || (mat0->w % 4 != 0)) { printf("Error in multMatByVec: (vec_dim % 4 != 0) || (mat0->w % 4 != 0)\n"); return; }
 #endif
     size_t vec_idx;
 
@@ -81,12 +221,39 @@ void multMatByVec(matrix32f_t *mat0, matrix32f_t *vec1, matrix32f_t *out0) {
     }
 }
 
-// NOTE: Not used in algorithm
 // Matrix multiplication; out0.h=in0.h, out10.w=in1.w
+// Uses the same GEMM_KC depth blocking as the NEON version so a block of `in1` rows stays in cache
 void matrixMultiply(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0) {
-    return;
+#ifdef DEBUG
+    if(out0 == NULL) { printf("Error in matrixMultiply: out0==NULL\n"); return; }
+    if(in0->w != in1->h) { printf("Error in matrixMultiply: in0->w != in1->h\n"); return; }
+    if((out0->h != in0->h) || (out0->w != in1->w)) { printf("Error in matrixMultiply: (out0->h != in0->h) || (out0->w != in1->w)\n"); return; }
+#endif
+    size_t m = in0->h;
+    size_t n = in1->w;
+    size_t k = in0->w;
+
+    for(size_t i = 0; i < m*n; i++) { out0->d[i] = 0.00; }
+
+    for(size_t pc = 0; pc < k; pc += GEMM_KC) {
+        size_t kend = (k - pc < GEMM_KC) ? k : pc + GEMM_KC;
+
+        for(size_t row = 0; row < m; row++) {
+            float32_t *out_row = &(out0->d[row*n]);
+            for(size_t kk = pc; kk < kend; kk++) {
+                float32_t a = in0->d[row*k + kk];
+                float32_t *in_row = &(in1->d[kk*n]);
+                for(size_t col = 0; col < n; col++) { out_row[col] += a * in_row[col]; }
+            }
+        }
+    }
 }
 
+// There's no packing; No workspace is needed
+size_t matrixMultiplyWsFloats(size_t m, size_t n, size_t k) { return 0; }
+
+void matrixMultiplyWs(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0, float32_t *work) { matrixMultiply(in0, in1, out0); }
+
 // Hadamard product (Elementwise multiplication)
 void hadamardProduct(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0) {
 #ifdef DEBUG
@@ -102,6 +269,53 @@ void hadamardProduct(matrix32f_t *in0, matrix32f_t *in1, matrix32f_t *out0) {
     for(i; i < len; i++) { output[i] = in0->d[i]*in1->d[i]; }
 }
 
+void affineTransform(matrix32f_t *in0, matrix32f_t *scale, matrix32f_t *shift, matrix32f_t *out0) {
+#ifdef DEBUG
+    if(in0->d == NULL || scale->d == NULL || shift->d == NULL) { printf("Error in affineTransform: (in0->d == NULL || scale->d == NULL || shift->d == NULL)\n"); return; }
+    if((scale->w*scale->h != 1 && scale->w*scale->h != in0->w) || (shift->w*shift->h != 1 && shift->w*shift->h != in0->w)) {
+        printf("Error in affineTransform: scale and shift should have 1 or in0->w elements\n");
+        return;
+    }
+    if(out0 != NULL && (out0->w != in0->w || out0->h != in0->h)) { printf("Error in affineTransform: (out0->w != in0->w || out0->h != in0->h)\n"); return; }
+#endif
+    // If `out0` is NULL store result in `in0`
+    float32_t *output = (out0 == NULL) ? in0->d : out0->d;
+    size_t rows = in0->h, cols = in0->w;
+    // Vectors are indexed per column; Single values are broadcast
+    uint8_t scale_vec = (scale->w*scale->h != 1), shift_vec = (shift->w*shift->h != 1);
+
+    float32_t s, b;
+    for(size_t i = 0; i < cols; i++) {
+        s = scale->d[scale_vec ? i : 0];
+        b = shift->d[shift_vec ? i : 0];
+        for(size_t r = 0; r < rows; r++) { output[r*cols + i] = in0->d[r*cols + i]*s + b; }
+    }
+}
+
+// Fixed point Hadamard product; the result is stored in `out0`'s format (`in0`'s if `out0` is NULL)
+void hadamardProduct_q16(matrix16q_t *in0, matrix16q_t *in1, matrix16q_t *out0) {
+#ifdef DEBUG
+    if((in0->w != in1->w) || (in0->h != in1->h)) { printf("Error in hadamardProduct_q16: (in0->w != in1->w) || (in0->h != in1->h)\n"); return; }
+#endif
+    matrix16q_t *out = (out0 == NULL) ? in0 : out0;
+    size_t len = in0->w * in0->h;
+    int32_t shift = (15 - in0->int_bits) + (15 - in1->int_bits) - (15 - out->int_bits);
+
+    for(size_t i = 0; i < len; i++) { out->d[i] = q16Saturate16(q16RoundingShift((int32_t)in0->d[i] * in1->d[i], shift)); }
+}
+
+// Fixed point saturating sum; all matrices should have the same format
+void matrixSum_q16(matrix16q_t *in0, matrix16q_t *in1, matrix16q_t *out0) {
+#ifdef DEBUG
+    if((in0->w != in1->w) || (in0->h != in1->h)) { printf("Error in matrixSum_q16: (in0->w != in1->w) || (in0->h != in1->h)\n"); return; }
+    if((in0->int_bits != in1->int_bits) || (out0 != NULL && out0->int_bits != in0->int_bits)) { printf("Error in matrixSum_q16: Formats of arguments don't match.\n"); return; }
+#endif
+    int16_t *output = (out0 == NULL) ? in0->d : out0->d;
+    size_t len = in0->w * in0->h;
+
+    for(size_t i = 0; i < len; i++) { output[i] = q16Saturate16((int32_t)in0->d[i] + in1->d[i]); }
+}
+
 // Elemetwise power of 2
 void elementwisePow2(matrix32f_t *in0, matrix32f_t *out0) {
     // If `out0` is NULL store result in `in0`
@@ -128,6 +342,63 @@ void squaredMagnitude(matrix32c_t *in0, matrix32f_t *out0) {
     }
 }
 
+// Scales every complex number of `cin0` to the magnitude in `mask`, keeping its phase: out = X * mask/|X|
+void applyMagnitudeMask_c(matrix32c_t *cin0, matrix32f_t *mask, matrix32c_t *out0) {
+    size_t len = cin0->w * cin0->h;
+#ifdef DEBUG
+    if(cin0->d == NULL || mask->d == NULL) { printf("Error in applyMagnitudeMask_c: (cin0->d == NULL || mask->d == NULL)\n"); return; }
+    if(mask->w * mask->h != len) { printf("Error in applyMagnitudeMask_c: Mismatched input lengths\n"); return; }
+    // Note: In-place operation is allowed
+    if(out0 != NULL) {
+        if(out0->d == NULL) { printf("Error in applyMagnitudeMask_c: out0->d == NULL\n"); return; }
+        if(out0->w != cin0->w || out0->h != cin0->h) { printf("Error in applyMagnitudeMask_c: (out0->w != cin0->w || out0->h != cin0->h)\n"); return; }
+    }
+#endif
+    float32_t *indf  = (float32_t*)cin0->d;
+    float32_t *outdf = (out0 != NULL) ? (float32_t*)out0->d : indf;
+
+    // Bins with |X| = 0 have no phase; they are given the phase 0 (out = mask), like angle(0) = 0
+    for(size_t i = 0; i < len; i++) {
+        float32_t re = indf[2*i], im = indf[2*i+1];
+        float32_t pow = re*re + im*im;
+        float32_t scale = (pow > 1e-30f) ? mask->d[i] / sqrtf(pow) : 0;
+        outdf[2*i]   = (pow > 1e-30f) ? re * scale : mask->d[i];
+        outdf[2*i+1] = im * scale;
+    }
+}
+
+void affineTransform_c(matrix32c_t *cin0, matrix32f_t *scale, matrix32c_t *shift, matrix32c_t *out0) {
+#ifdef DEBUG
+    if(cin0->d == NULL || scale->d == NULL) { printf("Error in affineTransform_c: (cin0->d == NULL || scale->d == NULL)\n"); return; }
+    if((scale->w*scale->h != 1 && scale->w*scale->h != cin0->w) || (shift != NULL && shift->w*shift->h != 1 && shift->w*shift->h != cin0->w)) {
+        printf("Error in affineTransform_c: scale and shift should have 1 or cin0->w elements\n");
+        return;
+    }
+    if(out0 != NULL && (out0->w != cin0->w || out0->h != cin0->h)) { printf("Error in affineTransform_c: (out0->w != cin0->w || out0->h != cin0->h)\n"); return; }
+#endif
+    float32_t *indf = (float32_t*)cin0->d;
+    float32_t *outdf = (out0 != NULL) ? (float32_t*)out0->d : indf;
+    size_t rows = cin0->h, cols = cin0->w;
+    uint8_t scale_vec = (scale->w*scale->h != 1);
+    // A NULL shift is a shift by 0
+    float32_t zero[2] = { 0, 0 };
+    float32_t *shdf = (shift != NULL) ? (float32_t*)shift->d : zero;
+    uint8_t shift_vec = (shift != NULL && shift->w*shift->h != 1);
+
+    float32_t s, b_re, b_im;
+    size_t idx;
+    for(size_t i = 0; i < cols; i++) {
+        s = scale->d[scale_vec ? i : 0];
+        b_re = shdf[shift_vec ? 2*i : 0];
+        b_im = shdf[shift_vec ? 2*i+1 : 1];
+        for(size_t r = 0; r < rows; r++) {
+            idx = 2*(r*cols + i);
+            outdf[idx]   = indf[idx]*s + b_re;
+            outdf[idx+1] = indf[idx+1]*s + b_im;
+        }
+    }
+}
+
 // Unused function; Should be replaced by `squaredMagnitude`
 void elementwisePow2_complex(matrix32c_t *in0) {
     float32_t *indf = (float32_t*)in0->d;
@@ -148,8 +419,18 @@ void relu(matrix32f_t *in0, matrix32f_t *out0) {
     float32_t *output = (out0 == NULL) ? in0->d : out0->d;
 
     size_t len = in0->w * in0->h;
-    size_t i;
-    for(i; i < len; i++) { in0->d[i] = (in0->d[i] < 0)? 0.0 : in0->d[i]; }
+    for(size_t i = 0; i < len; i++) { output[i] = (in0->d[i] < 0)? 0.0 : in0->d[i]; }
+}
+
+void relu_q16(matrix16q_t *in0, matrix16q_t *out0) {
+#ifdef DEBUG
+    if(out0 != NULL && ((in0->w != out0->w) || (in0->h != out0->h))) { printf("Error in relu_q16: (in0->w != out0->w) || (in0->h != out0->h)\n"); return; }
+#endif
+    matrix16q_t *out = (out0 == NULL) ? in0 : out0;
+    size_t len = in0->w * in0->h;
+
+    for(size_t i = 0; i < len; i++) { out->d[i] = (in0->d[i] < 0) ? 0 : in0->d[i]; }
+    out->int_bits = in0->int_bits;
 }
 
 
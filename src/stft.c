@@ -1,3 +1,4 @@
+#include <stdio.h>
 #include <math.h>
 #include <string.h> // memcpy
 
@@ -33,7 +34,8 @@ void extendInput(matrix32f_t *in0, matrix32f_t *out0, uint8_t rank) {
 	float32x4_t vreg;
 	// `r` is used to index the buffer for writing; start from the last element of the 2nd quadr.
 	size_t r = in_len + in_len - 4;
-	for(size_t i = 0; i < in_len; i+=4) {
+	size_t i;
+	for(i = 0; i+4 <= in_len; i+=4) {
 		vreg = vld1q_f32(&(in0->d[i]));
 		// Flip vector's contents
 		vreg = vrev64q_f32(vreg); // [a b c d] => [b a d c]; that's what vrev does
@@ -41,6 +43,8 @@ void extendInput(matrix32f_t *in0, matrix32f_t *out0, uint8_t rank) {
 		vst1q_f32(&(out0->d[r]), vreg);
 		r -= 4;
 	}
+	// Handle left-overs (in_len isn't always a multiple of 4)
+	for(; i < in_len; i++) { out0->d[in_len*2 - 1 - i] = in0->d[i]; }
 
 	// Nothing more to do for doubling
 	if(rank == 2) { return; }
@@ -62,6 +66,53 @@ void fftToSpectogram(matrix32c_t *fftin, matrix32f_t *out0, lut32f_t *sqrt_lut)
 	sqrtLUT(out0, sqrt_lut, NULL);
 }
 
+// Windows `in` (in_len samples) into `frame` while extending it like `extendInput`; First pass of `spectrogramFrame`
+static void stftWindowExtend(const float32_t *in, size_t in_len, uint8_t rank, const float32_t *window, float32_t *frame) {
+	float32x4_t vin;
+	size_t i;
+	if(rank == 1) {
+		for(i = 0; i+4 <= in_len; i+=4) { vst1q_f32(&frame[i], vmulq_f32(vld1q_f32(&in[i]), vld1q_f32(&window[i]))); }
+		// Handle left-overs
+		for(; i < in_len; i++) { frame[i] = in[i] * window[i]; }
+		return;
+	}
+	// Every 2*in_len block is the input followed by the input flipped
+	for(size_t b = 0; b < rank*in_len; b += 2*in_len) {
+		size_t r = b + 2*in_len - 4;
+		for(i = 0; i+4 <= in_len; i+=4) {
+			vin = vld1q_f32(&in[i]);
+			vst1q_f32(&frame[b + i], vmulq_f32(vin, vld1q_f32(&window[b + i])));
+			vin = vrev64q_f32(vin);
+			vin = vcombine_f32(vget_high_f32(vin), vget_low_f32(vin));
+			vst1q_f32(&frame[r - i], vmulq_f32(vin, vld1q_f32(&window[r - i])));
+		}
+		// Handle left-overs; `last` is the end of the flipped copy
+		size_t last = b + 2*in_len - 1;
+		for(; i < in_len; i++) {
+			frame[b + i] = in[i] * window[b + i];
+			frame[last - i] = in[i] * window[last - i];
+		}
+	}
+}
+
+// |X| of `bins` bins, with the square root from `sqrt_lut` or, if NULL, calculated; Last pass of `spectrogramFrame`
+static void stftMagnitude(const complex_t *spectrum, size_t bins, lut32f_t *sqrt_lut, float32_t *out) {
+	float32x4x2_t vbins;
+	float32x4_t vpow;
+	size_t i;
+	for(i = 0; i+4 <= bins; i+=4) {
+		vbins = vld2q_f32((const float32_t*)&spectrum[i]);
+		vpow = vmulq_f32(vbins.val[0], vbins.val[0]);
+		vpow = vmlaq_f32(vpow, vbins.val[1], vbins.val[1]);
+		vst1q_f32(&out[i], (sqrt_lut != NULL) ? vclampingLUTq_f32(vpow, sqrt_lut) : vsqrtq_f32(vpow));
+	}
+	// Handle left-overs (the Nyquist bin)
+	for(; i < bins; i++) {
+		float32_t pow = crealf(spectrum[i])*crealf(spectrum[i]) + cimagf(spectrum[i])*cimagf(spectrum[i]);
+		out[i] = (sqrt_lut != NULL) ? clampingLUTScalar(pow, sqrt_lut) : sqrtf(pow);
+	}
+}
+
 #else
 // Serial Code (Non NEON) * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
@@ -116,6 +167,729 @@ void fftToSpectogram(matrix32c_t *fftin, matrix32f_t *out0, lut32f_t *sqrt_lut)
 	// Get square root
 	sqrtLUT(out0, sqrt_lut, NULL);
 }
+
+// Windows `in` (in_len samples) into `frame` while extending it like `extendInput`; First pass of `spectrogramFrame`
+static void stftWindowExtend(const float32_t *in, size_t in_len, uint8_t rank, const float32_t *window, float32_t *frame) {
+	if(rank == 1) {
+		for(size_t i = 0; i < in_len; i++) { frame[i] = in[i] * window[i]; }
+		return;
+	}
+	// Every 2*in_len block is the input followed by the input flipped
+	for(size_t b = 0; b < rank*in_len; b += 2*in_len) {
+		size_t r = b + 2*in_len - 1;
+		for(size_t i = 0; i < in_len; i++) {
+			frame[b + i] = in[i] * window[b + i];
+			frame[r - i] = in[i] * window[r - i];
+		}
+	}
+}
+
+// |X| of `bins` bins, with the square root from `sqrt_lut` or, if NULL, calculated; Last pass of `spectrogramFrame`
+static void stftMagnitude(const complex_t *spectrum, size_t bins, lut32f_t *sqrt_lut, float32_t *out) {
+	for(size_t i = 0; i < bins; i++) {
+		float32_t pow = crealf(spectrum[i])*crealf(spectrum[i]) + cimagf(spectrum[i])*cimagf(spectrum[i]);
+		out[i] = (sqrt_lut != NULL) ? clampingLUTScalar(pow, sqrt_lut) : sqrtf(pow);
+	}
+}
+#endif
+
+
+
+// Built-in FFT * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+// A real frame of N samples is transformed as M = N/2 complex samples z[i] = x[2i] + j*x[2i+1] by Stockham
+// (self-sorting, no bit reversal) stages that ping-pong between two buffers, followed by a split step that
+// separates the spectra of the even and odd samples. The inverse runs the same stages on swap(Z) (re <-> im),
+// since swap(FFT(swap(Z))) is the unnormalized inverse FFT.
+#ifdef BUILTIN_FFT
+
+struct FFT_PLAN_ST {
+	uint32_t n, howmany, real_dist, complex_dist;
+	uint8_t  direction;
+	matrix32c_t twiddles;			// 1 x M, exp(-2πjk/M)
+	matrix32f_t first_twiddles;		// 6 x M/4, re/im of exp(-2πjkp/M) for k = 1, 2, 3; The first stage loads 4 p at once
+	matrix32c_t split_twiddles;		// 1 x M/2+1, exp(-2πjk/N)
+};
+
+#ifndef SERIAL
+// NEON Code * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// (re, im) *= (wr, wi)
+#define FFT_CMUL(re, im, wr, wi) { float32x4_t t = vmulq_f32(re, wr); t = vmlsq_f32(t, im, wi); \
+                                   im = vmulq_f32(im, wr); im = vmlaq_f32(im, re, wi); re = t; }
+
+// Radix-4 butterflies of 4 lanes; a, b, c, d become outputs 0..3 (before twiddles)
+#define FFT_RADIX4(ar, ai, br, bi, cr, ci, dr, di) { \
+	float32x4_t apcr = vaddq_f32(ar, cr), apci = vaddq_f32(ai, ci), amcr = vsubq_f32(ar, cr), amci = vsubq_f32(ai, ci); \
+	float32x4_t bpdr = vaddq_f32(br, dr), bpdi = vaddq_f32(bi, di), bmdr = vsubq_f32(br, dr), bmdi = vsubq_f32(bi, di); \
+	ar = vaddq_f32(apcr, bpdr); ai = vaddq_f32(apci, bpdi); \
+	cr = vsubq_f32(apcr, bpdr); ci = vsubq_f32(apci, bpdi); \
+	br = vaddq_f32(amcr, bmdi); bi = vsubq_f32(amci, bmdr); \
+	dr = vsubq_f32(amcr, bmdi); di = vaddq_f32(amci, bmdr); }
+
+// First stage (stride 1); Vectorized over p, so each lane has its own twiddles and the 4 outputs of a lane are adjacent
+static void fftFirstStage(const fft_plan_t plan, const complex_t *x, complex_t *y, size_t n) {
+	size_t m = n/4;
+	const float32_t *tw = plan->first_twiddles.d;
+	for(size_t p = 0; p < m; p+=4) {
+		float32x4x2_t a = vld2q_f32((const float32_t*)&x[p]);
+		float32x4x2_t b = vld2q_f32((const float32_t*)&x[p + m]);
+		float32x4x2_t c = vld2q_f32((const float32_t*)&x[p + 2*m]);
+		float32x4x2_t d = vld2q_f32((const float32_t*)&x[p + 3*m]);
+		FFT_RADIX4(a.val[0], a.val[1], b.val[0], b.val[1], c.val[0], c.val[1], d.val[0], d.val[1]);
+		FFT_CMUL(b.val[0], b.val[1], vld1q_f32(&tw[p]),       vld1q_f32(&tw[m + p]));
+		FFT_CMUL(c.val[0], c.val[1], vld1q_f32(&tw[2*m + p]), vld1q_f32(&tw[3*m + p]));
+		FFT_CMUL(d.val[0], d.val[1], vld1q_f32(&tw[4*m + p]), vld1q_f32(&tw[5*m + p]));
+
+		// Interleave to complex pairs of lanes 0,1 (lo) and 2,3 (hi) and write y[4p + k] for k = 0..3
+		float32x4_t a_lo = vzip1q_f32(a.val[0], a.val[1]), a_hi = vzip2q_f32(a.val[0], a.val[1]);
+		float32x4_t b_lo = vzip1q_f32(b.val[0], b.val[1]), b_hi = vzip2q_f32(b.val[0], b.val[1]);
+		float32x4_t c_lo = vzip1q_f32(c.val[0], c.val[1]), c_hi = vzip2q_f32(c.val[0], c.val[1]);
+		float32x4_t d_lo = vzip1q_f32(d.val[0], d.val[1]), d_hi = vzip2q_f32(d.val[0], d.val[1]);
+		float32_t *out = (float32_t*)&y[4*p];
+		vst1q_f32(&out[0],  vcombine_f32(vget_low_f32(a_lo),  vget_low_f32(b_lo)));
+		vst1q_f32(&out[4],  vcombine_f32(vget_low_f32(c_lo),  vget_low_f32(d_lo)));
+		vst1q_f32(&out[8],  vcombine_f32(vget_high_f32(a_lo), vget_high_f32(b_lo)));
+		vst1q_f32(&out[12], vcombine_f32(vget_high_f32(c_lo), vget_high_f32(d_lo)));
+		vst1q_f32(&out[16], vcombine_f32(vget_low_f32(a_hi),  vget_low_f32(b_hi)));
+		vst1q_f32(&out[20], vcombine_f32(vget_low_f32(c_hi),  vget_low_f32(d_hi)));
+		vst1q_f32(&out[24], vcombine_f32(vget_high_f32(a_hi), vget_high_f32(b_hi)));
+		vst1q_f32(&out[28], vcombine_f32(vget_high_f32(c_hi), vget_high_f32(d_hi)));
+	}
+}
+
+// Radix-4 stage of length n and stride s (>= 4); Vectorized over q with one twiddle per p
+static void fftRadix4Stage(const fft_plan_t plan, const complex_t *x, complex_t *y, size_t n, size_t s) {
+	size_t m = n/4;
+	const complex_t *tw = plan->twiddles.d;
+	for(size_t p = 0; p < m; p++) {
+		float32x4_t w1r = vdupq_n_f32(crealf(tw[p*s])),   w1i = vdupq_n_f32(cimagf(tw[p*s]));
+		float32x4_t w2r = vdupq_n_f32(crealf(tw[2*p*s])), w2i = vdupq_n_f32(cimagf(tw[2*p*s]));
+		float32x4_t w3r = vdupq_n_f32(crealf(tw[3*p*s])), w3i = vdupq_n_f32(cimagf(tw[3*p*s]));
+		for(size_t q = 0; q < s; q+=4) {
+			float32x4x2_t a = vld2q_f32((const float32_t*)&x[q + s*p]);
+			float32x4x2_t b = vld2q_f32((const float32_t*)&x[q + s*(p + m)]);
+			float32x4x2_t c = vld2q_f32((const float32_t*)&x[q + s*(p + 2*m)]);
+			float32x4x2_t d = vld2q_f32((const float32_t*)&x[q + s*(p + 3*m)]);
+			FFT_RADIX4(a.val[0], a.val[1], b.val[0], b.val[1], c.val[0], c.val[1], d.val[0], d.val[1]);
+			FFT_CMUL(b.val[0], b.val[1], w1r, w1i);
+			FFT_CMUL(c.val[0], c.val[1], w2r, w2i);
+			FFT_CMUL(d.val[0], d.val[1], w3r, w3i);
+			vst2q_f32((float32_t*)&y[q + s*(4*p)],     a);
+			vst2q_f32((float32_t*)&y[q + s*(4*p + 1)], b);
+			vst2q_f32((float32_t*)&y[q + s*(4*p + 2)], c);
+			vst2q_f32((float32_t*)&y[q + s*(4*p + 3)], d);
+		}
+	}
+}
+
+// Last stage of odd powers of 2 (n = 2, stride s); No twiddles, so re and im are handled alike
+static void fftRadix2Stage(const complex_t *x, complex_t *y, size_t s) {
+	const float32_t *a = (const float32_t*)x, *b = (const float32_t*)&x[s];
+	float32_t *y0 = (float32_t*)y, *y1 = (float32_t*)&y[s];
+	for(size_t i = 0; i < 2*s; i+=4) {
+		float32x4_t va = vld1q_f32(&a[i]), vb = vld1q_f32(&b[i]);
+		vst1q_f32(&y0[i], vaddq_f32(va, vb));
+		vst1q_f32(&y1[i], vsubq_f32(va, vb));
+	}
+}
+
+// Reverses the 4 lanes
+static inline float32x4_t fftReverse(float32x4_t v) {
+	v = vrev64q_f32(v);
+	return vcombine_f32(vget_high_f32(v), vget_low_f32(v));
+}
+
+// Split step of the forward transform; Bins k and M-k of the spectrum (X) come from bins k and M-k of Z
+static void fftSplit(const fft_plan_t plan, const complex_t *Z, complex_t *X) {
+	size_t M = plan->n/2;
+	const complex_t *tw = plan->split_twiddles.d;
+	float32_t z0r = crealf(Z[0]), z0i = cimagf(Z[0]);
+	X[0] = z0r + z0i;
+	X[M] = z0r - z0i;
+
+	float32x4_t half = vdupq_n_f32(0.5f);
+	size_t k = 1;
+	for(; k + 4 <= M/2; k+=4) {
+		float32x4x2_t zk  = vld2q_f32((const float32_t*)&Z[k]);
+		float32x4x2_t zmk = vld2q_f32((const float32_t*)&Z[M - k - 3]);
+		float32x4x2_t w   = vld2q_f32((const float32_t*)&tw[k]);
+		float32x4_t cr = fftReverse(zmk.val[0]), ci = fftReverse(zmk.val[1]);
+		// E = (Z[k] + conj(Z[M-k]))/2, O = (Z[k] - conj(Z[M-k]))/2j, t = W^k * O
+		float32x4_t er = vmulq_f32(vaddq_f32(zk.val[0], cr), half), ei = vmulq_f32(vsubq_f32(zk.val[1], ci), half);
+		float32x4_t tr = vmulq_f32(vaddq_f32(zk.val[1], ci), half), ti = vmulq_f32(vsubq_f32(cr, zk.val[0]), half);
+		FFT_CMUL(tr, ti, w.val[0], w.val[1]);
+
+		// X[k] = E + t, X[M-k] = conj(E - t)
+		float32x4x2_t xk, xmk;
+		xk.val[0] = vaddq_f32(er, tr); xk.val[1] = vaddq_f32(ei, ti);
+		xmk.val[0] = fftReverse(vsubq_f32(er, tr)); xmk.val[1] = fftReverse(vsubq_f32(ti, ei));
+		vst2q_f32((float32_t*)&X[k], xk);
+		vst2q_f32((float32_t*)&X[M - k - 3], xmk);
+	}
+	for(; k <= M/2; k++) {
+		complex_t e = (Z[k] + conjf(Z[M - k])) * 0.5f;
+		complex_t t = tw[k] * (Z[k] - conjf(Z[M - k])) * (-0.5f*I);
+		X[k] = e + t;
+		X[M - k] = conjf(e - t);
+	}
+}
+
+// Inverse of the split step; Writes swap(Z) for the forward stages, where Z[k] = 2(E + jO)
+static void fftMerge(const fft_plan_t plan, const complex_t *X, complex_t *Z) {
+	size_t M = plan->n/2;
+	const complex_t *tw = plan->split_twiddles.d;
+	// Imaginary parts of DC and Nyquist are ignored
+	float32_t x0 = crealf(X[0]), xm = crealf(X[M]);
+	Z[0] = (x0 - xm) + (x0 + xm)*I;
+
+	size_t k = 1;
+	for(; k + 4 <= M/2; k+=4) {
+		float32x4x2_t xk  = vld2q_f32((const float32_t*)&X[k]);
+		float32x4x2_t xmk = vld2q_f32((const float32_t*)&X[M - k - 3]);
+		float32x4x2_t w   = vld2q_f32((const float32_t*)&tw[k]);
+		float32x4_t cr = fftReverse(xmk.val[0]), ci = fftReverse(xmk.val[1]);
+		// e = X[k] + conj(X[M-k]), o = (X[k] - conj(X[M-k])) * conj(W^k)
+		float32x4_t er = vaddq_f32(xk.val[0], cr), ei = vsubq_f32(xk.val[1], ci);
+		float32x4_t or = vsubq_f32(xk.val[0], cr), oi = vaddq_f32(xk.val[1], ci);
+		FFT_CMUL(or, oi, w.val[0], vnegq_f32(w.val[1]));
+
+		// Z[k] = e + jo, Z[M-k] = conj(e) + j*conj(o); Stored swapped
+		float32x4x2_t zk, zmk;
+		zk.val[1] = vsubq_f32(er, oi); zk.val[0] = vaddq_f32(ei, or);
+		zmk.val[1] = fftReverse(vaddq_f32(er, oi)); zmk.val[0] = fftReverse(vsubq_f32(or, ei));
+		vst2q_f32((float32_t*)&Z[k], zk);
+		vst2q_f32((float32_t*)&Z[M - k - 3], zmk);
+	}
+	for(; k <= M/2; k++) {
+		complex_t e = X[k] + conjf(X[M - k]);
+		complex_t o = (X[k] - conjf(X[M - k])) * conjf(tw[k]);
+		complex_t zk = e + I*o, zmk = conjf(e) + I*conjf(o);
+		Z[k]     = cimagf(zk)  + crealf(zk)*I;
+		Z[M - k] = cimagf(zmk) + crealf(zmk)*I;
+	}
+}
+
+// Swaps re and im of n complex numbers
+static void fftSwap(complex_t *x, size_t n) {
+	float32_t *f = (float32_t*)x;
+	for(size_t i = 0; i < 2*n; i+=4) { vst1q_f32(&f[i], vrev64q_f32(vld1q_f32(&f[i]))); }
+}
+
+#else
+// Serial Code (Non NEON) * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Radix-4 stage of length n and stride s
+static void fftRadix4Stage(const fft_plan_t plan, const complex_t *x, complex_t *y, size_t n, size_t s) {
+	size_t m = n/4;
+	const complex_t *tw = plan->twiddles.d;
+	for(size_t p = 0; p < m; p++) {
+		complex_t w1 = tw[p*s], w2 = tw[2*p*s], w3 = tw[3*p*s];
+		for(size_t q = 0; q < s; q++) {
+			complex_t a = x[q + s*p], b = x[q + s*(p + m)], c = x[q + s*(p + 2*m)], d = x[q + s*(p + 3*m)];
+			complex_t apc = a + c, amc = a - c, bpd = b + d, jbmd = (b - d)*I;
+			y[q + s*(4*p)]     = apc + bpd;
+			y[q + s*(4*p + 1)] = (amc - jbmd) * w1;
+			y[q + s*(4*p + 2)] = (apc - bpd)  * w2;
+			y[q + s*(4*p + 3)] = (amc + jbmd) * w3;
+		}
+	}
+}
+
+// The first stage is a radix-4 stage of stride 1
+static void fftFirstStage(const fft_plan_t plan, const complex_t *x, complex_t *y, size_t n) {
+	fftRadix4Stage(plan, x, y, n, 1);
+}
+
+// Last stage of odd powers of 2 (n = 2, stride s)
+static void fftRadix2Stage(const complex_t *x, complex_t *y, size_t s) {
+	for(size_t q = 0; q < s; q++) {
+		complex_t a = x[q], b = x[q + s];
+		y[q]     = a + b;
+		y[q + s] = a - b;
+	}
+}
+
+// Split step of the forward transform; Bins k and M-k of the spectrum (X) come from bins k and M-k of Z
+static void fftSplit(const fft_plan_t plan, const complex_t *Z, complex_t *X) {
+	size_t M = plan->n/2;
+	const complex_t *tw = plan->split_twiddles.d;
+	float32_t z0r = crealf(Z[0]), z0i = cimagf(Z[0]);
+	X[0] = z0r + z0i;
+	X[M] = z0r - z0i;
+	// E = (Z[k] + conj(Z[M-k]))/2, O = (Z[k] - conj(Z[M-k]))/2j, X[k] = E + W^k*O, X[M-k] = conj(E - W^k*O)
+	for(size_t k = 1; k <= M/2; k++) {
+		complex_t e = (Z[k] + conjf(Z[M - k])) * 0.5f;
+		complex_t t = tw[k] * (Z[k] - conjf(Z[M - k])) * (-0.5f*I);
+		X[k] = e + t;
+		X[M - k] = conjf(e - t);
+	}
+}
+
+// Inverse of the split step; Writes swap(Z) for the forward stages, where Z[k] = 2(E + jO)
+static void fftMerge(const fft_plan_t plan, const complex_t *X, complex_t *Z) {
+	size_t M = plan->n/2;
+	const complex_t *tw = plan->split_twiddles.d;
+	// Imaginary parts of DC and Nyquist are ignored
+	float32_t x0 = crealf(X[0]), xm = crealf(X[M]);
+	Z[0] = (x0 - xm) + (x0 + xm)*I;
+	for(size_t k = 1; k <= M/2; k++) {
+		complex_t e = X[k] + conjf(X[M - k]);
+		complex_t o = (X[k] - conjf(X[M - k])) * conjf(tw[k]);
+		complex_t zk = e + I*o, zmk = conjf(e) + I*conjf(o);
+		Z[k]     = cimagf(zk)  + crealf(zk)*I;
+		Z[M - k] = cimagf(zmk) + crealf(zmk)*I;
+	}
+}
+
+// Swaps re and im of n complex numbers
+static void fftSwap(complex_t *x, size_t n) {
+	for(size_t i = 0; i < n; i++) { x[i] = cimagf(x[i]) + crealf(x[i])*I; }
+}
+#endif
+
+// Number of stages of a complex FFT of M points
+static size_t fftStages(size_t M) {
+	size_t stages = 0;
+	for(size_t len = M; len > 1; len = (len >= 4) ? len/4 : len/2) { stages++; }
+	return stages;
+}
+
+// Complex FFT of M = n/2 points from `x` to `out`; Stages ping-pong between `out` and `work` so that the last one
+// writes to `out`. `x` is only read by the first stage, so it may be whichever of the two that stage doesn't write.
+static void fftComplex(const fft_plan_t plan, const complex_t *x, complex_t *out, complex_t *work) {
+	size_t M = plan->n/2;
+	complex_t *dst   = (fftStages(M) % 2) ? out : work;
+	complex_t *other = (fftStages(M) % 2) ? work : out;
+
+	fftFirstStage(plan, x, dst, M);
+	size_t len = M/4, s = 4;
+	for(; len >= 4; len /= 4, s *= 4) {
+		fftRadix4Stage(plan, dst, other, len, s);
+		complex_t *temp = dst; dst = other; other = temp;
+	}
+	if(len == 2) { fftRadix2Stage(dst, other, s); }
+}
+
+void fftExecute(fft_plan_t plan, float32_t *real, complex_t *cplx, complex_t *work) {
+	size_t M = plan->n/2;
+	for(size_t t = 0; t < plan->howmany; t++) {
+		float32_t *x = &real[t*plan->real_dist];
+		complex_t *X = &cplx[t*plan->complex_dist];
+		if(plan->direction == STFT_FORWARD) {
+			// X is the second buffer of the stages; Z ends in `work`
+			fftComplex(plan, (const complex_t*)x, work, X);
+			fftSplit(plan, work, X);
+		}
+		else {
+			// swap(Z) goes to the buffer the first stage doesn't write
+			complex_t *z = (fftStages(M) % 2) ? work : (complex_t*)x;
+			fftMerge(plan, X, z);
+			fftComplex(plan, z, (complex_t*)x, work);
+			fftSwap((complex_t*)x, M);
+		}
+	}
+}
+
+// Creates the twiddle tables of a plan
+static fft_plan_t fftPlanCreate(uint32_t n, uint8_t direction, uint32_t howmany, uint32_t real_dist, uint32_t complex_dist) {
+	if(n < 32 || (n & (n - 1))) {
+#ifdef DEBUG
+		printf("Error in fftPlanCreate: The built-in FFT needs a power of 2 size >= 32.\n");
+#endif
+		return NULL;
+	}
+	fft_plan_t plan = (fft_plan_t)malloc(sizeof(struct FFT_PLAN_ST));
+	if(plan == NULL) { return NULL; }
+	size_t M = n/2, m = M/4;
+	plan->twiddles.d = NULL; plan->first_twiddles.d = NULL; plan->split_twiddles.d = NULL;
+	if(newMatrix32c(1, M, &plan->twiddles) || newMatrix32f(6, m, &plan->first_twiddles) || newMatrix32c(1, M/2 + 1, &plan->split_twiddles)) {
+		deleteMatrix((matrix32f_t*)&plan->twiddles);
+		deleteMatrix(&plan->first_twiddles);
+		deleteMatrix((matrix32f_t*)&plan->split_twiddles);
+		free(plan);
+		return NULL;
+	}
+	plan->n = n;
+	plan->direction = direction;
+	plan->howmany = howmany;
+	plan->real_dist = real_dist;
+	plan->complex_dist = complex_dist;
+
+	// Angles in double, so large sizes keep single precision twiddles
+	const double pi = acos(-1);
+	for(size_t k = 0; k < M; k++) {
+		plan->twiddles.d[k] = (float32_t)cos(-2*pi*k/M) + (float32_t)sin(-2*pi*k/M)*I;
+	}
+	for(size_t k = 1; k <= 3; k++) {
+		for(size_t p = 0; p < m; p++) {
+			plan->first_twiddles.d[(2*k - 2)*m + p] = crealf(plan->twiddles.d[k*p]);
+			plan->first_twiddles.d[(2*k - 1)*m + p] = cimagf(plan->twiddles.d[k*p]);
+		}
+	}
+	for(size_t k = 0; k <= M/2; k++) {
+		plan->split_twiddles.d[k] = (float32_t)cos(-2*pi*k/n) + (float32_t)sin(-2*pi*k/n)*I;
+	}
+	return plan;
+}
+
+static void fftPlanDelete(fft_plan_t plan) {
+	deleteMatrix((matrix32f_t*)&plan->twiddles);
+	deleteMatrix(&plan->first_twiddles);
+	deleteMatrix((matrix32f_t*)&plan->split_twiddles);
+	free(plan);
+}
+#endif
+
+
+// FFTW plans * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+// Every plan made through `stftPlan` is cached for the lifetime of the program (or until `cleanupFFT`)
+
+typedef struct STFT_PLAN_ST {
+	uint32_t n, howmany, real_dist, complex_dist;
+	uint8_t  direction, in_place;
+	int      real_alignment, complex_alignment;
+	unsigned flags;
+	fft_plan_t plan;
+} stft_plan_t;
+
+#define stftForwardFFT(stft, plan, real, cplx)	fftForward(plan, real, cplx, (stft)->fft_work.d)
+#define stftInverseFFT(stft, plan, cplx, real)	fftInverse(plan, cplx, real, (stft)->fft_work.d)
+
+static stft_plan_t stft_plan_cache[STFT_PLAN_CACHE_SIZE];
+static size_t      stft_plan_count = 0;
+static unsigned    stft_fftw_flags = STFT_DEFAULT_FFTW_FLAGS;
+
+int initFFT(const char *wisdom_path, unsigned flags) {
+	stft_fftw_flags = flags;
+#ifndef BUILTIN_FFT
+	if(wisdom_path == NULL || !fftwf_import_wisdom_from_filename(wisdom_path)) { return 30; }
+	return 0;
+#else
+	return 30;
+#endif
+}
+
+int saveFFTWisdom(const char *wisdom_path) {
+#ifndef BUILTIN_FFT
+	return fftwf_export_wisdom_to_filename(wisdom_path) ? 0 : 30;
+#else
+	return 0;
+#endif
+}
+
+void cleanupFFT() {
+	for(size_t i = 0; i < stft_plan_count; i++) {
+#ifndef BUILTIN_FFT
+		fftwf_destroy_plan(stft_plan_cache[i].plan);
+#else
+		fftPlanDelete(stft_plan_cache[i].plan);
+#endif
+	}
+	stft_plan_count = 0;
+}
+
+fft_plan_t stftPlan(uint32_t n, uint8_t direction, uint32_t howmany, uint32_t real_dist, uint32_t complex_dist, float32_t *real, complex_t *cplx) {
+	stft_plan_t key = {
+		n, howmany, real_dist, complex_dist,
+		direction, ((void*)real == (void*)cplx),
+#ifndef BUILTIN_FFT
+		fftwf_alignment_of(real), fftwf_alignment_of((float32_t*)cplx),
+#else
+		0, 0,	// any alignment of complex_t
+#endif
+		stft_fftw_flags, NULL
+	};
+	for(size_t i = 0; i < stft_plan_count; i++) {
+		stft_plan_t *entry = &stft_plan_cache[i];
+		if(entry->n == key.n && entry->howmany == key.howmany && entry->real_dist == key.real_dist && entry->complex_dist == key.complex_dist &&
+		   entry->direction == key.direction && entry->in_place == key.in_place && entry->real_alignment == key.real_alignment &&
+		   entry->complex_alignment == key.complex_alignment && entry->flags == key.flags) {
+			return entry->plan;
+		}
+	}
+	if(stft_plan_count == STFT_PLAN_CACHE_SIZE) {
+#ifdef DEBUG
+		printf("Error in stftPlan: The plan cache is full (STFT_PLAN_CACHE_SIZE).\n");
+#endif
+		return NULL;
+	}
+
+#ifndef BUILTIN_FFT
+	int size = n;
+	if(direction == STFT_FORWARD) {
+		key.plan = fftwf_plan_many_dft_r2c(1, &size, howmany, real, NULL, 1, real_dist, cplx, NULL, 1, complex_dist, stft_fftw_flags);
+	}
+	else {
+		key.plan = fftwf_plan_many_dft_c2r(1, &size, howmany, cplx, NULL, 1, complex_dist, real, NULL, 1, real_dist, stft_fftw_flags);
+	}
+#else
+	key.plan = fftPlanCreate(n, direction, howmany, real_dist, complex_dist);
+#endif
+	if(key.plan == NULL) { return NULL; }
+
+	stft_plan_cache[stft_plan_count++] = key;
+	return key.plan;
+}
+
+
+// Streaming engine * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+// Buffers are plain matrices, so windowing and overlap-adding use the (NEON) element-wise kernels on views of
+// the two contiguous parts of a ring buffer.
+
+int stftCreate(uint32_t fft_size, uint32_t hop_size, stft_t *stft) {
+	stft->window_mat.d = NULL; stft->synthesis_mat.d = NULL;
+	stft->in_ring.d = NULL; stft->frame.d = NULL; stft->spectrum.d = NULL;
+	stft->ispectrum.d = NULL; stft->iframe.d = NULL; stft->ola_ring.d = NULL;
+	stft->plan = NULL; stft->iplan = NULL;
+	stft->batch_size = 0;
+	stft->batch_frames.d = NULL; stft->batch_spectra.d = NULL; stft->batch_ispectra.d = NULL; stft->batch_iframes.d = NULL;
+	stft->batch_plan = NULL; stft->batch_iplan = NULL;
+#ifdef BUILTIN_FFT
+	stft->fft_work.d = NULL;
+#endif
+#ifdef DEBUG
+	if(fft_size == 0 || fft_size % 2) { printf("Error in stftCreate: fft_size should be even.\n"); return 1; }
+	if(hop_size == 0 || hop_size > fft_size) { printf("Error in stftCreate: hop_size should be within [1, fft_size].\n"); return 1; }
+#endif
+	stft->fft_size  = fft_size;
+	stft->hop_size  = hop_size;
+	stft->bin_count = fft_size/2 + 1;
+
+	if(newMatrix32f(1, fft_size, &stft->window_mat) || newMatrix32f(1, fft_size, &stft->synthesis_mat) ||
+	   newMatrix32f(1, fft_size, &stft->in_ring)    || newMatrix32f(1, fft_size, &stft->frame) ||
+	   newMatrix32c(1, stft->bin_count, &stft->spectrum) || newMatrix32c(1, stft->bin_count, &stft->ispectrum) ||
+	   newMatrix32f(1, fft_size, &stft->iframe)     || newMatrix32f(1, fft_size, &stft->ola_ring)
+#ifdef BUILTIN_FFT
+	   || newMatrix32c(1, fft_size/2, &stft->fft_work)
+#endif
+	   ) {
+#ifdef DEBUG
+		printf("Error in stftCreate: Failed to allocate memory.\n");
+#endif
+		stftDelete(stft);
+		return 2;
+	}
+
+	// Plans are made before any buffer is filled; planning may overwrite them
+	stft->plan  = stftPlan(fft_size, STFT_FORWARD, 1, fft_size, stft->bin_count, stft->frame.d, stft->spectrum.d);
+	stft->iplan = stftPlan(fft_size, STFT_INVERSE, 1, fft_size, stft->bin_count, stft->iframe.d, stft->ispectrum.d);
+	if(stft->plan == NULL || stft->iplan == NULL) {
+#ifdef DEBUG
+		printf("Error in stftCreate: Failed to create the FFTW plans.\n");
+#endif
+		stftDelete(stft);
+		return 3;
+	}
+
+	// Synthesis window; Every output sample is the sum of the frames covering it, weighted by window^2, so each
+	// position is divided by that sum (it depends on position % hop_size) and by fft_size for FFTW's inverse
+	hannWindow(fft_size, &stft->window_mat);
+	const float32_t *w = stft->window_mat.d;
+	for(size_t i = 0; i < fft_size; i++) {
+		float32_t norm = 0;
+		for(size_t j = i % hop_size; j < fft_size; j += hop_size) { norm += w[j]*w[j]; }
+		stft->synthesis_mat.d[i] = (norm > 0) ? w[i] / (norm * fft_size) : 0;
+	}
+
+	stftReset(stft);
+	return 0;
+}
+
+void stftDelete(stft_t *stft) {
+	// Plans belong to the cache
+	stft->plan = NULL;
+	stft->iplan = NULL;
+	stft->batch_plan = NULL;
+	stft->batch_iplan = NULL;
+	stft->batch_size = 0;
+
+	deleteMatrix(&stft->window_mat);
+	deleteMatrix(&stft->synthesis_mat);
+	deleteMatrix(&stft->in_ring);
+	deleteMatrix(&stft->frame);
+	deleteMatrix((matrix32f_t*)&stft->spectrum);
+	deleteMatrix((matrix32f_t*)&stft->ispectrum);
+	deleteMatrix(&stft->iframe);
+	deleteMatrix(&stft->ola_ring);
+	deleteMatrix(&stft->batch_frames);
+	deleteMatrix((matrix32f_t*)&stft->batch_spectra);
+	deleteMatrix((matrix32f_t*)&stft->batch_ispectra);
+	deleteMatrix(&stft->batch_iframes);
+#ifdef BUILTIN_FFT
+	deleteMatrix((matrix32f_t*)&stft->fft_work);
+#endif
+}
+
+void stftReset(stft_t *stft) {
+	clearMatrix(&stft->in_ring);
+	clearMatrix(&stft->ola_ring);
+	stft->in_pos = 0;
+	stft->hop_fill = 0;
+	stft->ola_pos = 0;
+}
+
+size_t stftPush(stft_t *stft, const float32_t *samples, size_t count, uint8_t *frame_ready) {
+	size_t n = stft->hop_size - stft->hop_fill;
+	if(n > count) { n = count; }
+
+	// Copy to the ring; wraps at most once since n <= fft_size
+	size_t first = stft->fft_size - stft->in_pos;
+	if(first > n) { first = n; }
+	memcpy(&stft->in_ring.d[stft->in_pos], samples, first*sizeof(float32_t));
+	memcpy(stft->in_ring.d, &samples[first], (n - first)*sizeof(float32_t));
+	stft->in_pos = (stft->in_pos + n) % stft->fft_size;
+	stft->hop_fill += n;
+
+	*frame_ready = 0;
+	if(stft->hop_fill == stft->hop_size) {
+		stft->hop_fill = 0;
+		fft(stft);
+		*frame_ready = 1;
+	}
+	return n;
+}
+
+// Weights an inverse transformed frame with the synthesis window and adds it to the ring; Frame sample 0 lines up with `ola_pos`
+static void stftOverlapAdd(stft_t *stft, float32_t *frame) {
+	matrix32f_t frame_mat = { 1, stft->fft_size, frame };
+	hadamardProduct(&frame_mat, &stft->synthesis_mat, NULL);
+
+	size_t first = stft->fft_size - stft->ola_pos;
+	matrix32f_t ola_part0   = { 1, first, &stft->ola_ring.d[stft->ola_pos] };
+	matrix32f_t ola_part1   = { 1, stft->ola_pos, stft->ola_ring.d };
+	matrix32f_t frame_part0 = { 1, first, frame };
+	matrix32f_t frame_part1 = { 1, stft->ola_pos, &frame[first] };
+	matrixSum(&ola_part0, &frame_part0, &ola_part0);
+	if(stft->ola_pos) { matrixSum(&ola_part1, &frame_part1, &ola_part1); }
+}
+
+// Writes the hop at `ola_pos`, which has received all of its frames, to `out` and clears it
+static void stftOutputHop(stft_t *stft, float32_t *out) {
+	size_t first = stft->fft_size - stft->ola_pos;
+	if(first > stft->hop_size) { first = stft->hop_size; }
+	size_t second = stft->hop_size - first;
+	memcpy(out, &stft->ola_ring.d[stft->ola_pos], first*sizeof(float32_t));
+	memcpy(&out[first], stft->ola_ring.d, second*sizeof(float32_t));
+	memset(&stft->ola_ring.d[stft->ola_pos], 0, first*sizeof(float32_t));
+	memset(stft->ola_ring.d, 0, second*sizeof(float32_t));
+	stft->ola_pos = (stft->ola_pos + stft->hop_size) % stft->fft_size;
+}
+
+void stftInverse(stft_t *stft, matrix32c_t *spectrum, float32_t *out) {
+#ifdef DEBUG
+	if(spectrum->w * spectrum->h != stft->bin_count) { printf("Error in stftInverse: The frame should have %d bins.\n", stft->bin_count); return; }
+#endif
+	memcpy(stft->ispectrum.d, spectrum->d, stft->bin_count*sizeof(complex_t));
+	ifft(stft);
+	stftOutputHop(stft, out);
+}
+
+void spectrogramFrame(stft_t *stft, matrix32f_t *in0, uint8_t rank, lut32f_t *sqrt_lut, matrix32f_t *out0) {
+#ifdef DEBUG
+	if(rank != 1 && rank != 2 && rank != 4 && rank != 8) { printf("Error in spectrogramFrame: Unsupported rank\n"); return; }
+	if(in0->w * in0->h * rank != stft->fft_size) { printf("Error in spectrogramFrame: (in_len*rank != fft_size)\n"); return; }
+	if(out0->w * out0->h != stft->bin_count) { printf("Error in spectrogramFrame: The output should have %d bins.\n", stft->bin_count); return; }
 #endif
+	stftWindowExtend(in0->d, in0->w * in0->h, rank, stft->window_mat.d, stft->frame.d);
+	stftForwardFFT(stft, stft->plan, stft->frame.d, stft->spectrum.d);
+	stftMagnitude(stft->spectrum.d, stft->bin_count, sqrt_lut, out0->d);
+}
+
+void fft(stft_t *settings) {
+	// The oldest sample is at `in_pos`
+	size_t first = settings->fft_size - settings->in_pos;
+	matrix32f_t ring_part0   = { 1, first, &settings->in_ring.d[settings->in_pos] };
+	matrix32f_t ring_part1   = { 1, settings->in_pos, settings->in_ring.d };
+	matrix32f_t window_part0 = { 1, first, settings->window_mat.d };
+	matrix32f_t window_part1 = { 1, settings->in_pos, &settings->window_mat.d[first] };
+	matrix32f_t frame_part0  = { 1, first, settings->frame.d };
+	matrix32f_t frame_part1  = { 1, settings->in_pos, &settings->frame.d[first] };
+	hadamardProduct(&ring_part0, &window_part0, &frame_part0);
+	if(settings->in_pos) { hadamardProduct(&ring_part1, &window_part1, &frame_part1); }
+
+	stftForwardFFT(settings, settings->plan, settings->frame.d, settings->spectrum.d);
+}
+
+void ifft(stft_t *settings) {
+	stftInverseFFT(settings, settings->iplan, settings->ispectrum.d, settings->iframe.d);
+	stftOverlapAdd(settings, settings->iframe.d);
+}
 
 
+int stftEnableBatch(stft_t *stft, uint32_t frames) {
+#ifdef DEBUG
+	if(stft->plan == NULL) { printf("Error in stftEnableBatch: The engine is not created.\n"); return 1; }
+	if(frames == 0) { printf("Error in stftEnableBatch: frames == 0\n"); return 1; }
+#endif
+	// Re-enabling replaces the previous batch buffers
+	stft->batch_plan = NULL;
+	stft->batch_iplan = NULL;
+	stft->batch_size = 0;
+	deleteMatrix(&stft->batch_frames);
+	deleteMatrix((matrix32f_t*)&stft->batch_spectra);
+	deleteMatrix((matrix32f_t*)&stft->batch_ispectra);
+	deleteMatrix(&stft->batch_iframes);
+
+	// Rows start at MATRIX_ALIGNMENT boundaries
+	stft->frame_stride = (stft->fft_size  + MATRIX_ALIGNMENT/sizeof(float32_t) - 1) & ~(MATRIX_ALIGNMENT/sizeof(float32_t) - 1);
+	stft->bin_stride   = (stft->bin_count + MATRIX_ALIGNMENT/sizeof(complex_t) - 1) & ~(MATRIX_ALIGNMENT/sizeof(complex_t) - 1);
+	if(newMatrix32f(frames, stft->frame_stride, &stft->batch_frames)       || newMatrix32f(frames, stft->frame_stride, &stft->batch_iframes) ||
+	   newMatrix32c(frames, stft->bin_stride,   &stft->batch_spectra)      || newMatrix32c(frames, stft->bin_stride,   &stft->batch_ispectra)) {
+#ifdef DEBUG
+		printf("Error in stftEnableBatch: Failed to allocate memory.\n");
+#endif
+		return 2;
+	}
+	stft->batch_plan  = stftPlan(stft->fft_size, STFT_FORWARD, frames, stft->frame_stride, stft->bin_stride, stft->batch_frames.d, stft->batch_spectra.d);
+	stft->batch_iplan = stftPlan(stft->fft_size, STFT_INVERSE, frames, stft->frame_stride, stft->bin_stride, stft->batch_iframes.d, stft->batch_ispectra.d);
+	// Padding is never written by the transforms
+	clearMatrix(&stft->batch_frames);
+	clearMatrix((matrix32f_t*)&stft->batch_spectra);
+	if(stft->batch_plan == NULL || stft->batch_iplan == NULL) {
+#ifdef DEBUG
+		printf("Error in stftEnableBatch: Failed to create the FFTW plans.\n");
+#endif
+		return 3;
+	}
+	stft->batch_size = frames;
+	return 0;
+}
+
+void stftForwardBatch(stft_t *stft, const float32_t *audio, size_t frames) {
+#ifdef DEBUG
+	if(frames > stft->batch_size) { printf("Error in stftForwardBatch: frames > batch_size (%d)\n", stft->batch_size); return; }
+#endif
+	// Gather and window every frame in one pass
+	for(size_t t = 0; t < frames; t++) {
+		matrix32f_t in_frame  = { 1, stft->fft_size, (float32_t*)&audio[t*stft->hop_size] };
+		matrix32f_t out_frame = { 1, stft->fft_size, &stft->batch_frames.d[t*stft->frame_stride] };
+		hadamardProduct(&in_frame, &stft->window_mat, &out_frame);
+	}
+
+	// A partial batch runs the single frame plan on each row; rows are aligned like the single frame buffers
+	if(frames == stft->batch_size) { stftForwardFFT(stft, stft->batch_plan, stft->batch_frames.d, stft->batch_spectra.d); }
+	else {
+		for(size_t t = 0; t < frames; t++) {
+			stftForwardFFT(stft, stft->plan, &stft->batch_frames.d[t*stft->frame_stride], &stft->batch_spectra.d[t*stft->bin_stride]);
+		}
+	}
+}
+
+void stftInverseBatch(stft_t *stft, matrix32c_t *spectra, size_t frames, float32_t *out) {
+#ifdef DEBUG
+	if(frames > stft->batch_size) { printf("Error in stftInverseBatch: frames > batch_size (%d)\n", stft->batch_size); return; }
+	if(spectra->w != stft->bin_stride) { printf("Error in stftInverseBatch: Rows should have %d bins.\n", stft->bin_stride); return; }
+#endif
+	memcpy(stft->batch_ispectra.d, spectra->d, frames*stft->bin_stride*sizeof(complex_t));
+	if(frames == stft->batch_size) { stftInverseFFT(stft, stft->batch_iplan, stft->batch_ispectra.d, stft->batch_iframes.d); }
+	else {
+		for(size_t t = 0; t < frames; t++) {
+			stftInverseFFT(stft, stft->iplan, &stft->batch_ispectra.d[t*stft->bin_stride], &stft->batch_iframes.d[t*stft->frame_stride]);
+		}
+	}
+
+	for(size_t t = 0; t < frames; t++) {
+		stftOverlapAdd(stft, &stft->batch_iframes.d[t*stft->frame_stride]);
+		stftOutputHop(stft, &out[t*stft->hop_size]);
+	}
+}
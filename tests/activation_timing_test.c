@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "clock.h"
+#include "lut.h"
+#include "approx.h"
+
+// Gate widths of the LSTM and FC layers
+static const size_t widths[] = { 256, 512, 4096 };
+#define WIDTHS	3
+
+// Same tables as lut/sigmoid65537.lut and lut/tanh65537.lut, generated at startup
+#define LUT_LENGTH	65537
+#define LUT_RANGE	8
+
+// Maximum absolute difference between `mat` and `fn` applied to `in`
+static float32_t maxError(matrix32f_t *in, matrix32f_t *mat, double (*fn)(double)) {
+	float32_t max_error = 0;
+	for(size_t i = 0; i < in->w; i++) {
+		float32_t error = fabs(mat->d[i] - fn(in->d[i]));
+		max_error = (error > max_error) ? error : max_error;
+	}
+	return max_error;
+}
+static double sigmoid(double x) { return 1.0/(1.0 + exp(-x)); }
+
+int main(int argc, char **argv) {
+	uint8_t ret = 0;
+	printf("Aias Karioris, 2025\n");
+	printf("Activation (LUT/Approximation) Timing Test");
+#ifndef SERIAL
+	printf(" (NEON)");
+#endif
+#ifdef DEBUG
+	printf(" [Debug Build]");
+#endif
+	printf("\n\n");
+
+	if(argc > 2) {
+		printf("Usage: %s [iterations]\n\n", argv[0]);
+		return 1;
+	}
+	uint32_t iterations = (argc==2) ? atoi(argv[1]) : 4096;
+
+	lut32f_t sigmoid_lut, tanh_lut;
+	sigmoid_lut.data = NULL; tanh_lut.data = NULL;
+	matrix32f_t input, output;
+	input.d = NULL; output.d = NULL;
+
+	if(lutGenerate(&sigmoid_lut, lutSigmoid, -LUT_RANGE, LUT_RANGE, LUT_LENGTH, LUT_NEAREST) || lutGenerate(&tanh_lut, tanhf, -LUT_RANGE, LUT_RANGE, LUT_LENGTH, LUT_NEAREST)) {
+		printf("Error: Could not generate the sigmoid/tanh LUTs.\n\n");
+		ret = 10; goto exit;
+	}
+
+	for(uint8_t w = 0; w < WIDTHS; w++) {
+		if(newMatrix32f(1, widths[w], &input) || newMatrix32f(1, widths[w], &output)) {
+			printf("Error: Could not allocate the %lu-wide matrices.\n", (unsigned long)widths[w]);
+			ret = 40; goto exit;
+		}
+		// Gate pre-activations; mostly within [-8, 8]
+		srand(w);
+		for(size_t i = 0; i < widths[w]; i++) { input.d[i] = 20.0f*((float32_t)rand()/RAND_MAX - 0.5f); }
+
+		clock_t tanh_lut_time, tanh_approx_time, sigmoid_lut_time, sigmoid_approx_time;
+		float32_t tanh_lut_error, tanh_approx_error, sigmoid_lut_error, sigmoid_approx_error;
+
+		startClock();
+		for(uint32_t it = 0; it < iterations; it++) { clampingLUT(&input, &tanh_lut, &output); }
+		tanh_lut_time = readClock();
+		tanh_lut_error = maxError(&input, &output, tanh);
+
+		startClock();
+		for(uint32_t it = 0; it < iterations; it++) { tanhApprox(&input, &output); }
+		tanh_approx_time = readClock();
+		tanh_approx_error = maxError(&input, &output, tanh);
+
+		startClock();
+		for(uint32_t it = 0; it < iterations; it++) { clampingLUT(&input, &sigmoid_lut, &output); }
+		sigmoid_lut_time = readClock();
+		sigmoid_lut_error = maxError(&input, &output, sigmoid);
+
+		startClock();
+		for(uint32_t it = 0; it < iterations; it++) { sigmoidApprox(&input, &output); }
+		sigmoid_approx_time = readClock();
+		sigmoid_approx_error = maxError(&input, &output, sigmoid);
+
+		printf("Results (1 x %lu, %u iterations)\n", (unsigned long)widths[w], iterations);
+		printf("\t=====================================\n");
+		printf("\t tanh LUT:              %4.3f us (max error %.2e)\n", clockToMS(tanh_lut_time)*1000.0/iterations, tanh_lut_error);
+		printf("\t tanh Approximation:    %4.3f us (max error %.2e)\n", clockToMS(tanh_approx_time)*1000.0/iterations, tanh_approx_error);
+		printf("\t sigmoid LUT:           %4.3f us (max error %.2e)\n", clockToMS(sigmoid_lut_time)*1000.0/iterations, sigmoid_lut_error);
+		printf("\t sigmoid Approximation: %4.3f us (max error %.2e)\n", clockToMS(sigmoid_approx_time)*1000.0/iterations, sigmoid_approx_error);
+		printf("\t=====================================\n\n");
+
+		deleteMatrix(&input);
+		deleteMatrix(&output);
+	}
+
+	// Accuracy of the other approximations; Inputs cover the ranges the LUTs are used for
+	if(newMatrix32f(1, 4096, &input) || newMatrix32f(1, 4096, &output)) {
+		printf("Error: Could not allocate the matrices.\n");
+		ret = 40; goto exit;
+	}
+	for(size_t i = 0; i < 4096; i++) { input.d[i] = 400.0f*i/4095; }
+	sqrtApprox(&input, &output);
+	float32_t sqrt_error = maxError(&input, &output, sqrt);
+	for(size_t i = 0; i < 4096; i++) { input.d[i] = 200.0f*((float32_t)i/4095 - 0.5f); }
+	atanApprox(&input, &output);
+	float32_t atan_error = maxError(&input, &output, atan);
+
+	matrix32c_t expi;
+	if(newMatrix32c(1, 4096, &expi)) {
+		printf("Error: Could not allocate the complex matrix.\n");
+		ret = 40; goto exit;
+	}
+	expiApprox(&input, &expi);
+	float32_t expi_error = 0, error;
+	for(size_t i = 0; i < 4096; i++) {
+		error = cabsf(expi.d[i] - (cosf(input.d[i]) + I*sinf(input.d[i])));
+		expi_error = (error > expi_error) ? error : expi_error;
+	}
+	deleteMatrix((matrix32f_t*)&expi);
+
+	printf("Max errors: sqrt([0, 400]) %.2e, atan([-100, 100]) %.2e, e^xi([-100, 100]) %.2e\n\n", sqrt_error, atan_error, expi_error);
+
+exit:
+	deleteLUT32f(&sigmoid_lut);
+	deleteLUT32f(&tanh_lut);
+	deleteMatrix(&input);
+	deleteMatrix(&output);
+	return ret;
+}
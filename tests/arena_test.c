@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdint.h>
+
+#include "matrix.h"
+#include "lstm.h"
+
+#define ALIGNED(p) ((((uintptr_t)(p)) % MATRIX_ALIGNMENT) == 0)
+#define IN_ARENA(p, arena) (((uint8_t*)(p) >= (arena).mem) && ((uint8_t*)(p) < (arena).mem + (arena).size))
+
+// Matrices of awkward sizes; Every one must start on a cache line and fit the arena exactly
+static int arenaTest(void) {
+	matrix_arena_t arena;
+	matrix32f_t m0, m1, m2, extra;
+	matrix32c_t c0;
+	size_t sizes[3][2] = { {1, 1}, {3, 17}, {1, 33} };
+	matrix32f_t *mats[3] = { &m0, &m1, &m2 };
+
+	size_t bytes = matrixArenaBytes(1, 2*5); // complex 1x5
+	for(uint8_t i = 0; i < 3; i++) { bytes += matrixArenaBytes(sizes[i][0], sizes[i][1]); }
+	if(matrixArenaCreate(bytes, &arena)) { printf("Error: failed to create arena (%lu bytes).\n", bytes); return 1; }
+	if(!ALIGNED(arena.mem)) { printf("Error: arena memory is not aligned.\n"); matrixArenaDelete(&arena); return 2; }
+
+	for(uint8_t i = 0; i < 3; i++) {
+		if(newMatrix32fIn(&arena, sizes[i][0], sizes[i][1], mats[i])) {
+			printf("Error: failed to allocate matrix %d in arena.\n", i); matrixArenaDelete(&arena); return 3;
+		}
+		if(!ALIGNED(mats[i]->d) || mats[i]->h != sizes[i][0] || mats[i]->w != sizes[i][1]) {
+			printf("Error: matrix %d is misaligned or has the wrong size.\n", i); matrixArenaDelete(&arena); return 4;
+		}
+		// Matrices must not overlap
+		for(size_t j = 0; j < mats[i]->h*mats[i]->w; j++) { mats[i]->d[j] = (float32_t)i; }
+	}
+	size_t mark = matrixArenaMark(&arena);
+	if(newMatrix32cIn(&arena, 1, 5, &c0) || !ALIGNED(c0.d)) {
+		printf("Error: failed to allocate aligned complex matrix in arena.\n"); matrixArenaDelete(&arena); return 3;
+	}
+	for(uint8_t i = 0; i < 3; i++) {
+		for(size_t j = 0; j < mats[i]->h*mats[i]->w; j++) {
+			if(mats[i]->d[j] != (float32_t)i) { printf("Error: matrix %d was overwritten.\n", i); matrixArenaDelete(&arena); return 5; }
+		}
+	}
+
+	// The arena is now full
+	if(arena.used != arena.size) { printf("Error: arena has %lu of %lu bytes used.\n", arena.used, arena.size); matrixArenaDelete(&arena); return 6; }
+	extra.d = NULL;
+	if(!newMatrix32fIn(&arena, 1, 1, &extra) || extra.d != NULL) {
+		printf("Error: allocation in a full arena succeeded.\n"); matrixArenaDelete(&arena); return 7;
+	}
+
+	// Resetting to the mark hands out the same memory again
+	float complex *c0_mem = c0.d;
+	matrixArenaReset(&arena, mark);
+	if(newMatrix32cIn(&arena, 1, 5, &c0) || c0.d != c0_mem) {
+		printf("Error: reset to mark did not release the complex matrix.\n"); matrixArenaDelete(&arena); return 8;
+	}
+	matrixArenaReset(&arena, 0);
+	if(arena.used != 0 || newMatrix32fIn(&arena, 1, 1, &extra) || (uint8_t*)extra.d != arena.mem) {
+		printf("Error: reset to 0 did not release the arena.\n"); matrixArenaDelete(&arena); return 8;
+	}
+
+	// A deleted arena hands out nothing
+	matrixArenaDelete(&arena);
+	if(arena.mem != NULL || arena.size != 0 || arena.used != 0 || !newMatrix32fIn(&arena, 1, 1, &extra)) {
+		printf("Error: deleted arena is still usable.\n"); return 9;
+	}
+	return 0;
+}
+
+// An LSTM cell's state and scratchpads are carved out of its arena
+static int lstmArenaTest(size_t input_size, size_t hidden_size) {
+	lstm_t lstm;
+	if(lstmCreate(input_size, hidden_size, 0, 0, &lstm)) { printf("Error: failed to create LSTM (%lu, %lu).\n", input_size, hidden_size); return 10; }
+
+	matrix32f_t *mats[] = {
+		&lstm.c, &lstm.h, &lstm.f_scratchpad, &lstm.c_scratchpad, &lstm.i_scratchpad, &lstm.o_scratchpad, &lstm.gp_scratchpad
+	};
+	for(uint8_t i = 0; i < 7; i++) {
+		if(!ALIGNED(mats[i]->d) || !IN_ARENA(mats[i]->d, lstm.arena) || mats[i]->w != hidden_size) {
+			printf("Error: LSTM (%lu, %lu) matrix %d is misaligned or outside the arena.\n", input_size, hidden_size, i);
+			lstmDelete(&lstm); return 11;
+		}
+	}
+	// `gp_scratchpad` is the last one and holds `input_size` floats
+	if((uint8_t*)(lstm.gp_scratchpad.d + input_size) > lstm.arena.mem + lstm.arena.size) {
+		printf("Error: LSTM (%lu, %lu) gp_scratchpad overflows the arena.\n", input_size, hidden_size);
+		lstmDelete(&lstm); return 12;
+	}
+	for(uint8_t i = 0; i < 2; i++) {
+		for(size_t j = 0; j < hidden_size; j++) {
+			if(mats[i]->d[j] != 0.0f) { printf("Error: LSTM state is not cleared.\n"); lstmDelete(&lstm); return 13; }
+		}
+	}
+
+	lstmDelete(&lstm);
+	if(lstm.arena.mem != NULL || lstm.h.d != NULL || lstm.gp_scratchpad.d != NULL) {
+		printf("Error: LSTM arena was not released.\n"); return 14;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	int ret = 0;
+	printf("Aias Karioris, 2025\n");
+	printf("Matrix Arena Test");
+#ifndef SERIAL
+	printf(" (NEON)");
+#endif
+#ifdef DEBUG
+	printf(" [Debug Build]");
+#endif
+	printf("\n\n");
+
+	printf("Arena allocation, full arena, reset and delete...");
+	if(ret = arenaTest()) { goto exit; }
+	printf("OK!\n");
+
+	printf("LSTM allocation from arena...");
+	if(ret = lstmArenaTest(512, 256)) { goto exit; }
+	if(ret = lstmArenaTest(13, 7)) { goto exit; }
+	printf("OK!\n\n");
+
+exit:
+	return ret;
+}
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "lstm.h"
+#include "bundle.h"
+#include "csv.h"
+#include "clock.h"
+
+// The bundle is expected to hold the same parameters, e.g. created with:
+// bundle_tool lstm.bundle lstm_drums_wf=parameters/csv/lstm_drums_wl0/lstm_drums_wf.csv:512x256 ... lstm_drums_obias=...:1x256
+const char *frame_in_path = "csv/frame1.csv";
+const char *param_path[] = {
+	"parameters/csv/lstm_drums_wl0/lstm_drums_wf.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_wc.csv",
+	"parameters/csv/lstm_drums_wl0/lstm_drums_wi.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_wo.csv",
+
+	"parameters/csv/lstm_drums_wl0/lstm_drums_uf.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_uc.csv",
+	"parameters/csv/lstm_drums_wl0/lstm_drums_ui.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_uo.csv",
+
+	"parameters/csv/lstm_drums_wl0/lstm_drums_fbias.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_cbias.csv",
+	"parameters/csv/lstm_drums_wl0/lstm_drums_ibias.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_obias.csv",
+};
+const char *bundle_prefix = "lstm_drums_";
+
+// Loads a bundle with a missing (`bad_obias`) and one with a wrongly shaped (`bad_wf`) matrix into `lstm`; Both should
+// fail with every parameter detached, so `lstmDelete` doesn't free the mapped bundle or the previous parameters
+static int badBundleTest(const char *path, lstm_t *lstm) {
+	static const char * const names[] = {
+		"bad_wf", "bad_wc", "bad_wi", "bad_wo", "bad_uf", "bad_uc", "bad_ui", "bad_uo", "bad_fbias", "bad_cbias", "bad_ibias", "bad_obias"
+	};
+	matrix32f_t * const param_mat[] = {
+		&lstm->f_w, &lstm->c_w, &lstm->i_w, &lstm->o_w,
+		&lstm->f_u, &lstm->c_u, &lstm->i_u, &lstm->o_u,
+		&lstm->f_bias, &lstm->c_bias, &lstm->i_bias, &lstm->o_bias
+	};
+	matrix32f_t mats[12];
+	bundle_item_t items[12];
+	bundle_t bundle;
+	int ret = 0, test;
+
+	for(uint8_t i = 0; i < 12; i++) { mats[i].d = NULL; }
+	for(uint8_t i = 0; i < 12; i++) {
+		size_t h = (i < 4) ? lstm->input_size : ((i < 8) ? lstm->hidden_size : 1);
+		if(newMatrix32f(h, lstm->hidden_size, &mats[i])) { ret = 1; goto exit; }
+		clearMatrix(&mats[i]);
+		items[i].name = names[i]; items[i].mat = &mats[i]; items[i].lut = NULL;
+	}
+
+	for(uint8_t t = 0; t < 2; t++) {
+		// t = 0: missing bias, t = 1: 1 x 1 `bad_wf`
+		size_t wf_w = mats[0].w;
+		if(t == 1) { mats[0].h = 1; mats[0].w = 1; }
+		test = bundleWrite(path, items, (t == 0) ? 11 : 12);
+		mats[0].h = lstm->input_size; mats[0].w = wf_w;
+		if(test || bundleOpen(path, 0, &bundle)) { ret = 1; goto exit; }
+
+		test = lstmLoadParametersBundle(&bundle, "bad_", lstm);
+		bundleClose(&bundle);
+		if(test != ((t == 0) ? 40 : 41)) { ret = 1; goto exit; }
+		for(uint8_t i = 0; i < 12; i++) {
+			if(param_mat[i]->d != NULL) { ret = 1; goto exit; }
+		}
+	}
+
+exit:
+	for(uint8_t i = 0; i < 12; i++) { deleteMatrix(&mats[i]); }
+	remove(path);
+	return ret;
+}
+
+int main(int argc, char **argv) {
+	uint8_t ret = 0;
+	printf("Aias Karioris, 2025\n");
+	printf("Bundle Loading Timing Test");
+#ifndef SERIAL
+	printf(" (NEON)");
+#endif
+#ifdef DEBUG
+	printf(" [Debug Build]");
+#endif
+	printf("\n\n");
+
+	if(argc != 2) {
+		printf("Usage: %s [bundle]\n\n", argv[0]);
+		return 1;
+	}
+
+	lstm_t lstm_csv, lstm_bundle;
+	lut32f_t sigmoid_lut, tanh_lut;
+	sigmoid_lut.data = NULL; tanh_lut.data = NULL;
+	bundle_t bundle;
+	bundle.mem = NULL;
+	matrix32f_t input;
+	input.d = NULL;
+	int test;
+
+	lstmCreate(512, 256, 0, 0, &lstm_csv);
+	lstmCreate(512, 256, 0, 0, &lstm_bundle);
+
+	if(load32fLUT(&sigmoid_lut, "lut/sigmoid.lut") || load32fLUT(&tanh_lut, "lut/tanh.lut")) {
+		printf("Error: Could not load the LUTs.\n");
+		ret = 3; goto exit;
+	}
+	lstmSetLUTs(&sigmoid_lut, &tanh_lut, &lstm_csv);
+	lstmSetLUTs(&sigmoid_lut, &tanh_lut, &lstm_bundle);
+
+	// CSV parsing
+	startClock();
+	if(test = lstmLoadParameters(param_path, &lstm_csv)) {
+		printf("Error (%d): Could not load the CSV parameters.\n", test);
+		ret = 4; goto exit;
+	}
+	float csv_time = clockToMS(readClock());
+
+	// Bundle; Mapping and checking the checksum are timed separately
+	startClock();
+	if(test = bundleOpen(argv[1], 0, &bundle)) {
+		printf("Error (%d): Could not open %s.\n", test, argv[1]);
+		ret = 5; goto exit;
+	}
+	if(test = lstmLoadParametersBundle(&bundle, bundle_prefix, &lstm_bundle)) {
+		printf("Error (%d): Could not load the parameters from %s.\n", test, argv[1]);
+		ret = 5; goto exit;
+	}
+	float bundle_time = clockToMS(readClock());
+
+	bundle_t verified;
+	startClock();
+	if(test = bundleOpen(argv[1], 1, &verified)) {
+		printf("Error (%d): Checksum verification of %s failed.\n", test, argv[1]);
+		ret = 6; goto exit;
+	}
+	float verify_time = clockToMS(readClock());
+	bundleClose(&verified);
+
+	// Both cells should calculate the same H
+	if(matrixFromCSV(frame_in_path, 1, 512, &input)) {
+		printf("Error: Could not load input frame (%s).\n", frame_in_path);
+		ret = 7; goto exit;
+	}
+	float32_t err = 0;
+	for(uint8_t i = 0; i < 4; i++) {
+		lstm_in(&input, &lstm_csv);
+		lstm_in(&input, &lstm_bundle);
+	}
+	for(size_t i = 0; i < 256; i++) { err += (lstm_csv.h.d[i] > lstm_bundle.h.d[i]) ? lstm_csv.h.d[i] - lstm_bundle.h.d[i] : lstm_bundle.h.d[i] - lstm_csv.h.d[i]; }
+
+	printf("Parameter Loading Results (1 LSTM cell)\n");
+	printf("\t=====================================\n");
+	printf("\t CSV Time:              %4.3f ms\n", csv_time);
+	printf("\t Bundle Time (mmap):    %4.3f ms\n", bundle_time);
+	printf("\t Bundle Time (checked): %4.3f ms\n", verify_time);
+	printf("\t Mean Error of H:       %2.6f\n", err / 256.0);
+	printf("\t=====================================\n\n");
+
+	// Failed loads into cells with owned (CSV) and borrowed (bundle) parameters; `lstmDelete` runs at exit
+	char bad_path[512];
+	snprintf(bad_path, sizeof(bad_path), "%s.bad", argv[1]);
+	printf("Loading bundles with missing/wrongly shaped matrices...");
+	if(badBundleTest(bad_path, &lstm_csv) || badBundleTest(bad_path, &lstm_bundle)) {
+		printf("Failed!\n\n");
+		ret = 8; goto exit;
+	}
+	printf("OK!\n\n");
+
+exit:
+	lstmDelete(&lstm_csv);
+	lstmDelete(&lstm_bundle);
+	bundleClose(&bundle);
+	deleteMatrix(&input);
+	deleteLUT32f(&sigmoid_lut);
+	deleteLUT32f(&tanh_lut);
+	return ret;
+}
@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "csv.h"
+
+#define TEST_PATH	"csv_parse_test.csv"
+#define TEST_W		16
+#define TEST_ROWS	2048
+#define FIELD_LEN	192
+
+// Values that are known to be hard to round, or to take special paths of the parser
+const char *fixed_values[] = {
+	"0", "-0", "+0", "-0.0", "0.000", "-0e10", "0e-400", "-.0", "0.",
+	"1", "-1", "+1.5", ".5", "5.", "1e0", "1E+2", "1e-2", "-2.5e-3",
+	// Halfway between two floats (1 + 2^-24 and 1 + 3*2^-24): round to even
+	"1.000000059604644775390625", "1.000000178813934326171875",
+	"1.0000000596046447753906250000000001", "1.0000000596046447753906249999999999",
+	// More than 19 significant digits
+	"3.14159265358979323846264338327950288", "123456789012345678901234567890", "0.000000000000000000000000000012345678901234567890123",
+	"99999999999999999999999999", "1.00000000000000000000000000000000000000001",
+	// Largest float, halfway to the next power of 2, overflow
+	"3.4028234663852886e38", "3.4028235e38", "3.40282356779733661637539395458142568448e38", "3.4028236e38", "1e39", "-1e39", "1e400",
+	// Smallest normal and subnormals, halfway to 0 and underflow
+	"1.17549435e-38", "1.1754942e-38", "1e-40", "-1e-40", "1.40129846e-45", "1e-45", "7.006492321624085e-46",
+	"7.0064923216240862e-46", "7e-46", "1e-50", "-1e-400",
+	// Long exponents and exponents that cancel out long mantissas
+	"1e000000000000000000000000001", "12345678901234567890e-19", "0.0000000000000000000000000000001e31",
+	"1e22", "1e23", "1e-22", "1e-23", "123456789e-45", "9.87654321e37",
+};
+#define FIXED_VALUES	(sizeof(fixed_values) / sizeof(fixed_values[0]))
+
+// xorshift64; Deterministic so failures can be reproduced
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+static uint64_t nextRandom() {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 7;
+	rng_state ^= rng_state << 17;
+	return rng_state;
+}
+
+// A random finite float (any exponent, including subnormals)
+static float32_t randomFloat() {
+	uint32_t bits;
+	do { bits = (uint32_t)nextRandom(); } while(((bits >> 23) & 0xFF) == 0xFF);
+	float32_t f;
+	memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+// Writes the `i`th test value to `s`
+static void makeValue(size_t i, char *s) {
+	if(i < FIXED_VALUES) { strcpy(s, fixed_values[i]); return; }
+
+	float32_t f = randomFloat();
+	switch(i % 5) {
+		// Shortest round trip
+		case 0: snprintf(s, FIELD_LEN, "%.9g", f); break;
+		// Exact halfway point between `f` and the next float (a double holds it exactly)
+		case 1: snprintf(s, FIELD_LEN, "%.120e", ((double)f + (double)nextafterf(f, INFINITY)) / 2.0); break;
+		// Near halfway; 25 significant digits
+		case 2: snprintf(s, FIELD_LEN, "%.24e", ((double)f + (double)nextafterf(f, INFINITY)) / 2.0); break;
+		// Random mantissa of 10 to 40 digits, with a random point and exponent
+		case 3: {
+			size_t digits = 10 + nextRandom() % 31;
+			size_t point = nextRandom() % (digits + 1);
+			char *p = s;
+			if(nextRandom() % 2) { *p++ = '-'; }
+			for(size_t d = 0; d < digits; d++) {
+				if(d == point) { *p++ = '.'; }
+				*p++ = '0' + nextRandom() % 10;
+			}
+			snprintf(p, FIELD_LEN - (p - s), "e%d", (int)(nextRandom() % 121) - 80);
+			break;
+		}
+		// Plain decimal notation
+		default: snprintf(s, FIELD_LEN, "%.*f", (int)(nextRandom() % 12), (double)(f * 1e-30f)); break;
+	}
+}
+
+// Loads the test file with `threads` threads and compares every value bit by bit against `strtof`
+static int compareLoader(size_t threads) {
+	matrix32f_t mat;
+	mat.d = NULL;
+	int err = matrixFromCSVParallel(TEST_PATH, TEST_ROWS, TEST_W, threads, &mat);
+	if(err) { printf("\nError (%d): failed to load %s with %lu thread(s).\n", err, TEST_PATH, threads); return 1; }
+
+	char s[FIELD_LEN];
+	rng_state = 0x9E3779B97F4A7C15ULL;
+	for(size_t i = 0; i < TEST_ROWS*TEST_W; i++) {
+		makeValue(i, s);
+		float32_t expected = strtof(s, NULL);
+		if(memcmp(&expected, &mat.d[i], sizeof(float32_t))) {
+			printf("\nError: value %lu (%s) was loaded as %.9g, not %.9g (%lu thread(s)).\n", i, s, mat.d[i], expected, threads);
+			deleteMatrix(&mat);
+			return 1;
+		}
+	}
+	deleteMatrix(&mat);
+	return 0;
+}
+
+// `contents` must fail to load as a `h` x `w` matrix with `expected_err`
+static int expectError(const char *contents, size_t h, size_t w, int expected_err) {
+	FILE *f = fopen(TEST_PATH, "wb");
+	if(f == NULL) { return 1; }
+	fputs(contents, f);
+	fclose(f);
+
+	matrix32f_t mat;
+	mat.d = NULL;
+	int err0 = matrixFromCSV(TEST_PATH, h, w, &mat);
+	int err1 = matrixFromCSVParallel(TEST_PATH, h, w, 2, &mat);
+	if(err0 != expected_err || err1 != expected_err) {
+		printf("\nError: loading \"%s\" returned %d/%d, not %d.\n", contents, err0, err1, expected_err);
+		if(!err0 || !err1) { deleteMatrix(&mat); }
+		return 1;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	int ret = 0;
+	printf("Aias Karioris, 2025\n");
+	printf("CSV Parser Test");
+#ifndef SERIAL
+	printf(" (NEON)");
+#endif
+#ifdef DEBUG
+	printf(" [Debug Build]");
+#endif
+	printf("\n\n");
+
+	// Some lines end with "\r\n"; The file is larger than a buffer so values straddle refills
+	printf("Writing %d values to %s...", TEST_ROWS*TEST_W, TEST_PATH);
+	FILE *f = fopen(TEST_PATH, "wb");
+	if(f == NULL) { printf("\nError: can't create %s.\n", TEST_PATH); return 1; }
+	char s[FIELD_LEN];
+	for(size_t i = 0; i < TEST_ROWS*TEST_W; i++) {
+		makeValue(i, s);
+		fputs(s, f);
+		if(i % TEST_W != TEST_W - 1) { fputc(',', f); }
+		else { fputs((i / TEST_W) % 7 ? "\n" : "\r\n", f); }
+	}
+	fclose(f);
+	printf("OK!\n");
+
+	printf("Comparing against strtof (matrixFromCSV)...");
+	if(compareLoader(1)) { ret = 2; goto exit; }
+	printf("OK!\n");
+	printf("Comparing against strtof (matrixFromCSVParallel)...");
+	if(compareLoader(4)) { ret = 3; goto exit; }
+	printf("OK!\n");
+
+	// A trailing ',' is a missing value, not the end of the row
+	printf("Rejecting invalid rows...");
+	if(expectError("1,2,3,\n4,5,6\n", 2, 3, 2) || expectError("1,2,3\n4,5,6,", 2, 3, 2) ||
+	   expectError("1,2,3,\r\n4,5,6\r\n", 2, 3, 2) || expectError("1,,2\n", 1, 3, 2) ||
+	   expectError("1,2,3\n4,5,6e\n", 2, 3, 2) || expectError("1,2,3\n4,5,6,7\n", 2, 3, 80)) {
+		ret = 4; goto exit;
+	}
+	printf("OK!\n\n");
+
+exit:
+	remove(TEST_PATH);
+	return ret;
+}
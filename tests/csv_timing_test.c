@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "csv.h"
+#include "clock.h"
+
+#ifndef BAREMETAL
+#include <time.h>
+#endif
+
+const char *param_path[] = {
+	"parameters/csv/lstm_drums_wl0/lstm_drums_wf.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_wc.csv",
+	"parameters/csv/lstm_drums_wl0/lstm_drums_wi.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_wo.csv",
+
+	"parameters/csv/lstm_drums_wl0/lstm_drums_uf.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_uc.csv",
+	"parameters/csv/lstm_drums_wl0/lstm_drums_ui.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_uo.csv",
+
+	"parameters/csv/lstm_drums_wl0/lstm_drums_fbias.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_cbias.csv",
+	"parameters/csv/lstm_drums_wl0/lstm_drums_ibias.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_obias.csv",
+};
+const size_t param_h[] = { 512, 512, 512, 512, 256, 256, 256, 256, 1, 1, 1, 1 };
+#define PARAM_W		256
+#define PARAMS		12
+
+// Wall clock in ms; `clock()` counts the CPU time of all threads
+static double wallTimeMS() {
+#ifndef BAREMETAL
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+#else
+	return clockToMS(clock());
+#endif
+}
+
+static void deleteAll(matrix32f_t *mats) {
+	for(size_t i = 0; i < PARAMS; i++) { deleteMatrix(&mats[i]); }
+}
+
+// An empty file holds fewer values than expected; Both loaders should return 127
+static int emptyFileTest(size_t threads) {
+	const char *path = "csv_empty_test.csv";
+	FILE *f = fopen(path, "wb");
+	if(f == NULL) { return 1; }
+	fclose(f);
+
+	matrix32f_t mat;
+	mat.d = NULL;
+	int ret = (matrixFromCSV(path, 4, 4, &mat) != 127) || (matrixFromCSVParallel(path, 4, 4, threads, &mat) != 127);
+	deleteMatrix(&mat);
+	remove(path);
+	return ret;
+}
+
+int main(int argc, char **argv) {
+	uint8_t ret = 0;
+	printf("Aias Karioris, 2025\n");
+	printf("CSV Loading Timing Test");
+#ifndef SERIAL
+	printf(" (NEON)");
+#endif
+#ifdef DEBUG
+	printf(" [Debug Build]");
+#endif
+	printf("\n\n");
+
+	if(argc != 2) {
+		printf("Usage: %s [threads]\n\n", argv[0]);
+		return 1;
+	}
+	size_t threads = atoi(argv[1]);
+
+	matrix32f_t reference[PARAMS], loaded[PARAMS];
+	csv_job_t jobs[PARAMS];
+	for(size_t i = 0; i < PARAMS; i++) { reference[i].d = NULL; loaded[i].d = NULL; }
+	int test;
+
+	// One file at a time
+	double start = wallTimeMS();
+	for(size_t i = 0; i < PARAMS; i++) {
+		if(test = matrixFromCSV(param_path[i], param_h[i], PARAM_W, &reference[i])) {
+			printf("Error (%d): Could not load %s.\n", test, param_path[i]);
+			ret = 2; goto exit;
+		}
+	}
+	double sequential_time = wallTimeMS() - start;
+
+	// Batch; One file per thread
+	for(size_t i = 0; i < PARAMS; i++) {
+		jobs[i].path = param_path[i];
+		jobs[i].h = param_h[i];
+		jobs[i].w = PARAM_W;
+		jobs[i].mat = &loaded[i];
+	}
+	start = wallTimeMS();
+	if(test = matrixFromCSVBatch(jobs, PARAMS, threads)) {
+		printf("Error (%d): Batch loading failed.\n", test);
+		ret = 3; goto exit;
+	}
+	double batch_time = wallTimeMS() - start;
+	for(size_t i = 0; i < PARAMS; i++) {
+		if(memcmp(reference[i].d, loaded[i].d, param_h[i]*PARAM_W*sizeof(float32_t))) {
+			printf("Error: Batch loading of %s gave different values.\n", param_path[i]);
+			ret = 4; goto exit;
+		}
+	}
+	deleteAll(loaded);
+
+	// Every file split across all threads
+	start = wallTimeMS();
+	for(size_t i = 0; i < PARAMS; i++) {
+		if(test = matrixFromCSVParallel(param_path[i], param_h[i], PARAM_W, threads, &loaded[i])) {
+			printf("Error (%d): Could not load %s in parallel.\n", test, param_path[i]);
+			ret = 5; goto exit;
+		}
+	}
+	double parallel_time = wallTimeMS() - start;
+	for(size_t i = 0; i < PARAMS; i++) {
+		if(memcmp(reference[i].d, loaded[i].d, param_h[i]*PARAM_W*sizeof(float32_t))) {
+			printf("Error: Parallel loading of %s gave different values.\n", param_path[i]);
+			ret = 6; goto exit;
+		}
+	}
+
+	if(emptyFileTest(threads)) {
+		printf("Error: Loading an empty file didn't fail with 127.\n");
+		ret = 7; goto exit;
+	}
+
+	printf("Parameter Loading Results (1 LSTM cell, %lu threads)\n", (unsigned long)threads);
+	printf("\t=====================================\n");
+	printf("\t Sequential Time:       %4.3f ms\n", sequential_time);
+	printf("\t Batch Time:            %4.3f ms (x%2.2f)\n", batch_time, sequential_time / batch_time);
+	printf("\t Parallel Time:         %4.3f ms (x%2.2f)\n", parallel_time, sequential_time / parallel_time);
+	printf("\t=====================================\n\n");
+
+exit:
+	deleteAll(reference);
+	deleteAll(loaded);
+	return ret;
+}
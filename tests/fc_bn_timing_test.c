@@ -35,8 +35,8 @@ int main(int argc, char **argv) {
 #endif
 	printf("\n");
 
-	if(argc > 2) {
-		printf("Usage: %s [iterations]\n\n", argv[0]);
+	if(argc > 5) {
+		printf("Usage: %s [iterations] [half precision weights (0/1)] [fold batch norm. (0/1)] [fixed point (0/1)]\n\n", argv[0]);
 		return 1;
 	}
 
@@ -44,7 +44,20 @@ int main(int argc, char **argv) {
 	setvbuf (stdout, NULL, _IONBF, BUFSIZ);
 
 	// Get number of iterations or default to 16
-	uint32_t iterations = (argc==2) ? atoi(argv[1]) : 16;
+	uint32_t iterations = (argc>=2) ? atoi(argv[1]) : 16;
+	// Optionally store the FC weights in half precision
+	uint8_t half_weights = (argc>=3) ? atoi(argv[2]) : 0;
+	if(half_weights) { printf("Using half precision FC weights\n"); }
+	// Optionally fold the batch normalization into the FC weights and bias (`foldBatchNorm`)
+	uint8_t fold_bn = (argc>=4) ? atoi(argv[3]) : 0;
+	// Optionally run the layers in 16-bit fixed point; The batch normalization is folded into the weights and
+	// a Q-format bias, so a layer is multVecByMat_q16 -> matrixSum_q16 -> clampingLUT_q16/relu_q16
+	uint8_t fixed_point = (argc==5) ? atoi(argv[4]) : 0;
+	if(fixed_point) {
+		printf("Using 16-bit fixed point\n");
+		fold_bn = 1; half_weights = 0;
+	}
+	if(fold_bn) { printf("Folding batch normalization into the FC layer\n"); }
 
 	// Load tanh LUT
 	lut32f_t tanhlut;
@@ -63,6 +76,14 @@ int main(int argc, char **argv) {
 	matrix32f_t bn_mean_mat, bn_gammavar_mat, bn_beta_mat;
 
 	fc_w_mat.d = NULL;
+	matrix32f_t fused_w_mat, fused_bias_mat, reference;
+	fused_w_mat.d = NULL; fused_bias_mat.d = NULL; reference.d = NULL;
+	matrix16f_t fc_wh_mat;
+	fc_wh_mat.d = NULL;
+	matrix16q_t input_q, fc_wq_mat, bias_q, output_q;
+	input_q.d = NULL; fc_wq_mat.d = NULL; bias_q.d = NULL; output_q.d = NULL;
+	lut16q_t tanhlut_q;
+	tanhlut_q.data = NULL;
 	bn_mean_mat.d = NULL; bn_gammavar_mat.d = NULL; bn_beta_mat.d = NULL;
 
 	// Use a pointer array for quickly determining where to load what
@@ -93,12 +114,57 @@ int main(int argc, char **argv) {
 		}
 		printf("OK! (%.2f ms)\n", clockToMS(readClock()));
 
+		// Fold the batch normalization; the original weights are kept to check the output
+		if(fold_bn && foldBatchNorm(&fc_w_mat, &bn_mean_mat, &bn_gammavar_mat, &bn_beta_mat, &fused_w_mat, &fused_bias_mat)) {
+			printf("Error: failed to fold the batch normalization.\n\n");
+			ret = -3; goto exit;
+		}
+
+		// Convert the FC weights if required
+		if(half_weights) {
+			if(newMatrix16f(fc_w_mat.h, fc_w_mat.w, &fc_wh_mat)) {
+				printf("Error: failed to create the half precision weight matrix.\n\n");
+				ret = -3; goto exit;
+			}
+			matrixTo16f(fold_bn ? &fused_w_mat : &fc_w_mat, &fc_wh_mat);
+		}
+
 		// Create matrix for the final output
-		if(newMatrix32f(1, matrix_dims[layer*8+1], &output1)) {
+		if(newMatrix32f(1, matrix_dims[layer*8+1], &output1) || newMatrix32f(1, matrix_dims[layer*8+1], &reference)) {
 			printf("Error: failed to create the final output matrix.\n\n");
 			ret = -3; goto exit;
 		}
 
+		// Activation function (tanh on l1, relu on l2 and none on l3)
+		uint8_t activation = (layer == 0) ? ACTIVATION_TANH : ((layer == 1) ? ACTIVATION_RELU : ACTIVATION_NONE);
+
+		// Fixed point parameters; The output's format fits the (float) pre-activations of this input and the bias.
+		// `multVecByMat_q16` saturates sums beyond the input's + the weights' integer bits, so the weights get
+		// enough integer bits for the output's range
+		if(fixed_point) {
+			multVecByMatEx(&input1, &fused_w_mat, &fused_bias_mat, ACTIVATION_NONE, NULL, &reference);
+			uint8_t out_int_bits = matrixIntBits16q(&reference);
+			uint8_t bias_int_bits = matrixIntBits16q(&fused_bias_mat);
+			out_int_bits = (bias_int_bits > out_int_bits) ? bias_int_bits : out_int_bits;
+			uint8_t in_int_bits = matrixIntBits16q(&input1);
+			uint8_t w_int_bits = matrixIntBits16q(&fused_w_mat);
+			if(in_int_bits + w_int_bits < out_int_bits) { w_int_bits = out_int_bits - in_int_bits; }
+
+			if(newMatrix16q(1, input_dim[layer], in_int_bits, &input_q) || newMatrix16q(fused_w_mat.h, fused_w_mat.w, w_int_bits, &fc_wq_mat) ||
+			   newMatrix16q(1, fused_bias_mat.w, out_int_bits, &bias_q) || newMatrix16q(1, fused_bias_mat.w, out_int_bits, &output_q)) {
+				printf("Error: failed to create the fixed point matrices.\n\n");
+				ret = -3; goto exit;
+			}
+			matrixTo16q(&input1, &input_q);
+			matrixTo16q(&fused_w_mat, &fc_wq_mat);
+			matrixTo16q(&fused_bias_mat, &bias_q);
+			if(activation == ACTIVATION_TANH && lutTo16q(&tanhlut, out_int_bits, 0, 12, &tanhlut_q)) {
+				printf("Error: failed to create the fixed point tanh LUT.\n\n");
+				ret = -3; goto exit;
+			}
+			printf("Fixed point formats: input Q%d, weights Q%d, output Q%d\n", input_q.int_bits, fc_wq_mat.int_bits, out_int_bits);
+		}
+
 		// Perform tests and time them
 		clock_t fc_time = 0;
 		clock_t best_time  = (clock_t)9e18;
@@ -107,23 +173,40 @@ int main(int argc, char **argv) {
 		for(size_t iter = 0; iter < iterations; iter++) {
 			startClock();
 
-			// Fully Connected Layer; after this operation all operations create 1x512 matrices
-			multVecByMat(&input1, &fc_w_mat, &output1);
-			fc_time += readClock();
-
-			// Batch Normalization is just a series of elementwise, linear operations
-			matrixDiff(&output1, &bn_mean_mat, &output1);
-			hadamardProduct(&output1, &bn_gammavar_mat, NULL);
-			matrixSum(&output1, &bn_beta_mat, NULL);
-
-			// Activation function (tanh on l1, relu on l2 and none on l3)
-			switch(layer) {
-				case 0: // layer 1 => tanh
-					clampingLUT(&output1, &tanhlut, NULL); break;
-				case 1: // layer 2 => relu
-					relu(&output1, NULL); break;
-				default: // layer 3 => none
-					break;
+			if(fixed_point) {
+				// The output's format is reset, since the LUT changes it
+				output_q.int_bits = bias_q.int_bits;
+				multVecByMat_q16(&input_q, &fc_wq_mat, &output_q);
+				fc_time += readClock();
+				matrixSum_q16(&output_q, &bias_q, NULL);
+				if(activation == ACTIVATION_TANH) { clampingLUT_q16(&output_q, &tanhlut_q, NULL); }
+				else if(activation == ACTIVATION_RELU) { relu_q16(&output_q, NULL); }
+			} else if(fold_bn && !half_weights) {
+				// Folded layers are a single multiplication with the bias and activation as its epilogue
+				multVecByMatEx(&input1, &fused_w_mat, &fused_bias_mat, activation, &tanhlut, &output1);
+				fc_time += readClock();
+			} else {
+				// Fully Connected Layer; after this operation all operations create 1x512 matrices
+				if(half_weights)	{ multVecByMat_f16w(&input1, &fc_wh_mat, &output1); }
+				else				{ multVecByMat(&input1, &fc_w_mat, &output1); }
+				fc_time += readClock();
+
+				// Batch Normalization is just a series of elementwise, linear operations (or the folded bias)
+				if(fold_bn) { matrixSum(&output1, &fused_bias_mat, NULL); }
+				else {
+					matrixDiff(&output1, &bn_mean_mat, &output1);
+					hadamardProduct(&output1, &bn_gammavar_mat, NULL);
+					matrixSum(&output1, &bn_beta_mat, NULL);
+				}
+
+				switch(activation) {
+					case ACTIVATION_TANH:
+						clampingLUT(&output1, &tanhlut, NULL); break;
+					case ACTIVATION_RELU:
+						relu(&output1, NULL); break;
+					default:
+						break;
+				}
 			}
 			// Check timer
 			float last_time = readClock();
@@ -145,14 +228,45 @@ int main(int argc, char **argv) {
 		printf("\t Mean FC Time/iter.:   %2.3f ms\n", mean_fc_time_ms);
 		printf("\t=====================================\n\n");
 
+		// Compare the folded (or fixed point) layer with the original FC and BN layers
+		if(fixed_point) { matrixFrom16q(&output_q, &output1); }
+		if(fold_bn) {
+			multVecByMat(&input1, &fc_w_mat, &reference);
+			matrixDiff(&reference, &bn_mean_mat, NULL);
+			hadamardProduct(&reference, &bn_gammavar_mat, NULL);
+			matrixSum(&reference, &bn_beta_mat, NULL);
+			if(activation == ACTIVATION_TANH) { clampingLUT(&reference, &tanhlut, NULL); }
+			else if(activation == ACTIVATION_RELU) { relu(&reference, NULL); }
+
+			float32_t max_diff = 0;
+			for(size_t i = 0; i < reference.w; i++) {
+				float32_t diff = fabsf(reference.d[i] - output1.d[i]);
+				max_diff = (diff > max_diff) ? diff : max_diff;
+			}
+			printf("\t Max. difference to the unfolded layers: %.2e\n\n", max_diff);
+		}
+
 		for(uint8_t m = 0; m < 4; m++) { deleteMatrix(matrix_ptr[m]); }
+		deleteMatrix(&fused_w_mat);
+		deleteMatrix(&fused_bias_mat);
+		deleteMatrix16f(&fc_wh_mat);
+		deleteMatrix16q(&input_q); deleteMatrix16q(&fc_wq_mat); deleteMatrix16q(&bias_q); deleteMatrix16q(&output_q);
+		deleteLUT16q(&tanhlut_q);
 		deleteMatrix(&input1);
 		deleteMatrix(&output1);
+		deleteMatrix(&reference);
 	}
 
 exit:
 	for(uint8_t m = 0; m < 4; m++) { deleteMatrix(matrix_ptr[m]); }
+	deleteMatrix(&fused_w_mat);
+	deleteMatrix(&fused_bias_mat);
+	deleteMatrix16f(&fc_wh_mat);
+	deleteMatrix16q(&input_q); deleteMatrix16q(&fc_wq_mat); deleteMatrix16q(&bias_q); deleteMatrix16q(&output_q);
+	deleteLUT16q(&tanhlut_q);
+	deleteLUT32f(&tanhlut);
 	deleteMatrix(&input1);
 	deleteMatrix(&output1);
+	deleteMatrix(&reference);
 	return ret;
 }
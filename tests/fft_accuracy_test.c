@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+
+#include "matrix.h"
+#include "stft.h"
+
+// Sizes 32 to 8192; log2(n/2) alternates between even (radix-4 stages only) and odd (one radix-2 stage)
+#define MIN_SIZE		32
+#define MAX_SIZE		8192
+// Relative RMS error against the double precision DFT
+#define FFT_TOLERANCE	1e-6
+// Batch of BATCH_FRAMES transforms with padded rows, like `stftEnableBatch`
+#define BATCH_SIZE		256
+#define BATCH_FRAMES	3
+
+// xorshift64; Deterministic so failures can be reproduced
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+static float32_t randomSample() {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 7;
+	rng_state ^= rng_state << 17;
+	return (float32_t)((rng_state >> 40) / (double)(1 << 24)) * 2.0f - 1.0f;
+}
+
+// exp(-2πjm/n) for m in [0, n)
+static double *cos_table = NULL, *sin_table = NULL;
+static void makeTables(size_t n) {
+	const double pi = acos(-1);
+	for(size_t m = 0; m < n; m++) {
+		cos_table[m] = cos(2*pi*m/n);
+		sin_table[m] = -sin(2*pi*m/n);
+	}
+}
+
+// Relative RMS error of the forward transform of `x` (n samples) against the DFT
+static double forwardError(size_t n, const float32_t *x, const complex_t *X) {
+	double err = 0, norm = 0;
+	for(size_t k = 0; k <= n/2; k++) {
+		double re = 0, im = 0;
+		for(size_t i = 0, m = 0; i < n; i++, m = (m + k) % n) {
+			re += x[i] * cos_table[m];
+			im += x[i] * sin_table[m];
+		}
+		double dre = crealf(X[k]) - re, dim = cimagf(X[k]) - im;
+		err  += dre*dre + dim*dim;
+		norm += re*re + im*im;
+	}
+	return sqrt(err / norm);
+}
+
+// Relative RMS error of the (unnormalized) inverse transform of the n/2+1 bins of `X` against the DFT of the full
+// Hermitian spectrum; The imaginary parts of bins 0 and n/2 are ignored
+static double inverseError(size_t n, const complex_t *X, const float32_t *x) {
+	double err = 0, norm = 0;
+	for(size_t i = 0; i < n; i++) {
+		double s = crealf(X[0]) + ((i % 2) ? -crealf(X[n/2]) : crealf(X[n/2]));
+		for(size_t k = 1, m = i; k < n/2; k++, m = (m + i) % n) {
+			s += 2*(crealf(X[k]) * cos_table[m] + cimagf(X[k]) * sin_table[m]);
+		}
+		err  += (x[i] - s)*(x[i] - s);
+		norm += s*s;
+	}
+	return sqrt(err / norm);
+}
+
+static void randomSpectrum(size_t n, complex_t *X) {
+	for(size_t k = 0; k <= n/2; k++) { X[k] = randomSample() + randomSample()*I; }
+	X[0] = crealf(X[0]);
+	X[n/2] = crealf(X[n/2]);
+}
+
+// One forward and one inverse transform of size n
+static int sizeTest(size_t n) {
+	int ret = 0;
+	matrix32f_t real, ireal;
+	matrix32c_t cplx, icplx, spectrum, work;
+	real.d = NULL; ireal.d = NULL; cplx.d = NULL; icplx.d = NULL; spectrum.d = NULL; work.d = NULL;
+	if(newMatrix32f(1, n, &real) || newMatrix32f(1, n, &ireal) || newMatrix32c(1, n/2+1, &cplx) ||
+	   newMatrix32c(1, n/2+1, &icplx) || newMatrix32c(1, n/2+1, &spectrum) || newMatrix32c(1, n/2, &work)) {
+		printf("\nError: failed to create matrices for n = %lu.\n", n);
+		ret = 2; goto exit;
+	}
+
+	fft_plan_t plan  = stftPlan(n, STFT_FORWARD, 1, n, n/2+1, real.d, cplx.d);
+	fft_plan_t iplan = stftPlan(n, STFT_INVERSE, 1, n, n/2+1, ireal.d, icplx.d);
+	if(plan == NULL || iplan == NULL) {
+		printf("\nError: failed to create the plans for n = %lu.\n", n);
+		ret = 3; goto exit;
+	}
+	makeTables(n);
+
+	for(size_t i = 0; i < n; i++) { real.d[i] = randomSample(); }
+	fftForward(plan, real.d, cplx.d, work.d);
+	double error = forwardError(n, real.d, cplx.d);
+	printf("\t%5lu: forward %.2e", n, error);
+	if(!(error <= FFT_TOLERANCE)) { printf("\nError: forward FFT of size %lu is off by %.2e.\n", n, error); ret = 4; goto exit; }
+
+	// FFTW's inverse overwrites its input
+	randomSpectrum(n, spectrum.d);
+	memcpy(icplx.d, spectrum.d, (n/2+1)*sizeof(complex_t));
+	fftInverse(iplan, icplx.d, ireal.d, work.d);
+	error = inverseError(n, spectrum.d, ireal.d);
+	printf(", inverse %.2e\n", error);
+	if(!(error <= FFT_TOLERANCE)) { printf("Error: inverse FFT of size %lu is off by %.2e.\n", n, error); ret = 5; goto exit; }
+
+exit:
+	deleteMatrix(&real);
+	deleteMatrix(&ireal);
+	deleteMatrix((matrix32f_t*)&cplx);
+	deleteMatrix((matrix32f_t*)&icplx);
+	deleteMatrix((matrix32f_t*)&spectrum);
+	deleteMatrix((matrix32f_t*)&work);
+	return ret;
+}
+
+// A plan of several transforms with padded rows; Every row must match the DFT of its own input
+static int batchTest() {
+	int ret = 0;
+	const size_t n = BATCH_SIZE, real_dist = n + 16, complex_dist = n/2 + 8;
+	matrix32f_t real;
+	matrix32c_t cplx, spectra, work;
+	real.d = NULL; cplx.d = NULL; spectra.d = NULL; work.d = NULL;
+	if(newMatrix32f(BATCH_FRAMES, real_dist, &real) || newMatrix32c(BATCH_FRAMES, complex_dist, &cplx) ||
+	   newMatrix32c(BATCH_FRAMES, complex_dist, &spectra) || newMatrix32c(1, n/2, &work)) {
+		printf("\nError: failed to create matrices for the batch.\n");
+		ret = 6; goto exit;
+	}
+
+	fft_plan_t plan  = stftPlan(n, STFT_FORWARD, BATCH_FRAMES, real_dist, complex_dist, real.d, cplx.d);
+	fft_plan_t iplan = stftPlan(n, STFT_INVERSE, BATCH_FRAMES, real_dist, complex_dist, real.d, cplx.d);
+	if(plan == NULL || iplan == NULL) {
+		printf("\nError: failed to create the batch plans.\n");
+		ret = 7; goto exit;
+	}
+	makeTables(n);
+
+	for(size_t i = 0; i < BATCH_FRAMES*real_dist; i++) { real.d[i] = randomSample(); }
+	fftForward(plan, real.d, cplx.d, work.d);
+	for(size_t t = 0; t < BATCH_FRAMES; t++) {
+		double error = forwardError(n, &real.d[t*real_dist], &cplx.d[t*complex_dist]);
+		if(!(error <= FFT_TOLERANCE)) { printf("\nError: forward FFT of batch row %lu is off by %.2e.\n", t, error); ret = 8; goto exit; }
+	}
+
+	for(size_t t = 0; t < BATCH_FRAMES; t++) { randomSpectrum(n, &spectra.d[t*complex_dist]); }
+	memcpy(cplx.d, spectra.d, BATCH_FRAMES*complex_dist*sizeof(complex_t));
+	fftInverse(iplan, cplx.d, real.d, work.d);
+	for(size_t t = 0; t < BATCH_FRAMES; t++) {
+		double error = inverseError(n, &spectra.d[t*complex_dist], &real.d[t*real_dist]);
+		if(!(error <= FFT_TOLERANCE)) { printf("\nError: inverse FFT of batch row %lu is off by %.2e.\n", t, error); ret = 9; goto exit; }
+	}
+
+exit:
+	deleteMatrix(&real);
+	deleteMatrix((matrix32f_t*)&cplx);
+	deleteMatrix((matrix32f_t*)&spectra);
+	deleteMatrix((matrix32f_t*)&work);
+	return ret;
+}
+
+int main(int argc, char **argv) {
+	int ret = 0;
+	printf("Aias Karioris, 2025\n");
+	printf("FFT Accuracy Test");
+#ifndef SERIAL
+	printf(" (NEON)");
+#endif
+#ifdef BUILTIN_FFT
+	printf(" [Built-in FFT]");
+#endif
+#ifdef DEBUG
+	printf(" [Debug Build]");
+#endif
+	printf("\n\n");
+
+	cos_table = (double*)malloc(MAX_SIZE*sizeof(double));
+	sin_table = (double*)malloc(MAX_SIZE*sizeof(double));
+	if(cos_table == NULL || sin_table == NULL) { printf("Error: failed to create the DFT tables.\n"); ret = 1; goto exit; }
+
+	printf("Comparing against a double precision DFT (relative RMS error)...\n");
+	for(size_t n = MIN_SIZE; n <= MAX_SIZE; n *= 2) {
+		if(ret = sizeTest(n)) { goto exit; }
+		// The plan cache holds STFT_PLAN_CACHE_SIZE plans
+		cleanupFFT();
+	}
+	printf("Batch of %d transforms with padded rows...", BATCH_FRAMES);
+	if(ret = batchTest()) { goto exit; }
+	printf("OK!\n");
+
+#ifdef BUILTIN_FFT
+	// There's no algorithm for other sizes; The planner must refuse them
+	printf("Rejecting sizes that aren't powers of 2 >= 32...");
+	float32_t real[64];
+	complex_t cplx[33];
+	if(stftPlan(48, STFT_FORWARD, 1, 48, 25, real, cplx) || stftPlan(16, STFT_FORWARD, 1, 16, 9, real, cplx) ||
+	   stftPlan(0, STFT_INVERSE, 1, 64, 33, real, cplx)) {
+		printf("\nError: the built-in FFT accepted an unsupported size.\n");
+		ret = 10; goto exit;
+	}
+	printf("OK!\n");
+#endif
+	printf("\n");
+
+exit:
+	cleanupFFT();
+	free(cos_table);
+	free(sin_table);
+	return ret;
+}
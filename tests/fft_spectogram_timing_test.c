@@ -1,7 +1,7 @@
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include <complex.h>
-#include <fftw3.h>
 
 #include "clock.h"
 #include "csv.h"
@@ -43,8 +43,14 @@ int main(int argc, char **argv) {
 	matrix32c_t fft_matrix;
 	matrix32f_t spec_output;
 	matrix32f_t hann_window;
+	matrix32f_t fused_output;
+	matrix32c_t fft_work;
+	stft_t stft;
 
 	audio_input.d = NULL;
+	fused_output.d = NULL;
+	fft_work.d = NULL;
+	stft.window_mat.d = NULL;
 	audio_input_extended.d = NULL;
 	fft_matrix.d  = NULL;
 	spec_output.d = NULL;
@@ -81,18 +87,21 @@ int main(int argc, char **argv) {
 		ret = 40; goto exit;
 	}
 
-	// Initialize FFTW
-	printf("Generating FFTW plan...");
+	// Initialize FFT
+	printf("Generating FFT plan...");
 	startClock();
-#ifdef USE_THREADS
+#if defined(USE_THREADS) && !defined(BUILTIN_FFT)
 	int threads = 1;
 	printf("(using %d threads) ", threads);
 	fftwf_init_threads();
 	fftwf_plan_with_nthreads(threads);
 #endif
-	fftwf_plan const plan = fftwf_plan_dft_r2c_1d(4096, audio_input_extended.d, fft_matrix.d, FFTW_ESTIMATE);
+	fft_plan_t const plan = stftPlan(4096, STFT_FORWARD, 1, 4096, 4096/2+1, audio_input_extended.d, fft_matrix.d);
+	if(plan == NULL || newMatrix32c(1, 4096/2, &fft_work)) {
+		printf("Error: failed to create the FFT plan.\n");
+		ret = 40; goto exit;
+	}
 	printf("OK!\t(%.2f ms)\n", clockToMS(readClock()));
-	//fftwf_print_plan(plan);
 
 
 	// Load square root LUT
@@ -126,7 +135,7 @@ int main(int argc, char **argv) {
 
 		// FFT
 		temp_time = clock();
-		fftwf_execute(plan);
+		fftForward(plan, audio_input_extended.d, fft_matrix.d, fft_work.d);
 		fft_time += clock() - temp_time;
 
 		// FFT to spectogram
@@ -146,6 +155,22 @@ int main(int argc, char **argv) {
 	clock_t end_time = clock();
 	float mean_iter_time_us = clockToMS(end_time - start_time) * 1000.0 / (float)iterations;
 
+	// The same steps fused by `spectrogramFrame`
+	if(stftCreate(4096, 2048, &stft) || newMatrix32f(1, 4096/2+1, &fused_output)) {
+		printf("Error: failed to create the STFT engine.\n");
+		ret = 41; goto exit;
+	}
+	temp_time = clock();
+	for(size_t iter = 0; iter < iterations; iter++) {
+		spectrogramFrame(&stft, &audio_input, 2, &sqrt_lut, &fused_output);
+	}
+	clock_t fused_time = clock() - temp_time;
+	float32_t max_fused_diff = 0;
+	for(size_t i = 0; i < 4096/2+1; i++) {
+		float32_t diff = fabsf(fused_output.d[i] - spec_output.d[i]);
+		max_fused_diff = (diff > max_fused_diff) ? diff : max_fused_diff;
+	}
+
 	printf("\n\tResults\n");
 	printf("\t=====================================\n");
 	printf("\t Time for %4d iterations: %4.3f ms\n", iterations, clockToMS(end_time - start_time));
@@ -154,19 +179,23 @@ int main(int argc, char **argv) {
 	printf("\t Worst Time: %4.1f us (%+4.1f us, iter. #%d)\n", clockToMS(worst_time)*1000.0, clockToMS(worst_time)*1000.0-mean_iter_time_us, worst_time_idx);
 	printf("\t Extension Mean Time: %4.1f us\n", clockToMS(extension_time/(float)iterations)*1000.0);
 	printf("\t Hann Window Mean Time: %4.1f us\n", clockToMS(hann_time/(float)iterations)*1000.0);
-	printf("\t FFTW Mean Time: %4.1f us\n", clockToMS(fft_time/(float)iterations)*1000.0);
+	printf("\t FFT Mean Time: %4.1f us\n", clockToMS(fft_time/(float)iterations)*1000.0);
 	printf("\t Spec. Mean Time: %4.1f us\n", clockToMS(spectogram_time/(float)iterations)*1000.0);
+	printf("\t Fused Mean Time/iter.: %4.1f us\n", clockToMS(fused_time/(float)iterations)*1000.0);
+	printf("\t Max Fused Difference: %2.6f\n", max_fused_diff);
 	printf("\t=====================================\n\n");
 
 exit:
-	if(ret < 10)
-		fftwf_destroy_plan(plan);
+	cleanupFFT();
+	deleteMatrix((matrix32f_t*)&fft_work);
 
 	deleteLUT32f(&sqrt_lut);
 	deleteMatrix(&audio_input);
 	deleteMatrix(&spec_output);
 	deleteMatrix(&hann_window);
 	deleteMatrix((matrix32f_t*)&fft_matrix);
+	deleteMatrix(&fused_output);
+	if(stft.window_mat.d != NULL) { stftDelete(&stft); }
 	return ret;
 }
 
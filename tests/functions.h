@@ -2,25 +2,25 @@
 
 
 typedef enum valid_functions_enum {
-	/* Matrix Math (2 inputs)*/	matrixSumEnum, matrixDiffEnum, multVecByMatEnum, multMatByVecEnum,  hadamardProductEnum,
+	/* Matrix Math (2 inputs)*/	matrixSumEnum, matrixDiffEnum, multVecByMatEnum, multMatByVecEnum, matrixMultiplyEnum, multVecByMat_q8Enum, multVecByMat_q16Enum, multVecByMat_f16wEnum, multVecByMatExEnum, affineTransformEnum, hadamardProductEnum,
 	/* Matrix Math (1 input)*/	elementwisePow2Enum, reluEnum,
-	/* LUT Operations*/			sqrtLutEnum, tanhLutEnum, sigmoidLutEnum,
-	/* Matrix Manipulation*/	flipEnum, extend2Enum, extend4Enum, extend8Enum,
+	/* LUT Operations*/			sqrtLutEnum, tanhLutEnum, sigmoidLutEnum, tanhLutLinearEnum, sigmoidLutLinearEnum,
+	/* Matrix Manipulation*/	flipEnum, extend2Enum, extend4Enum, extend8Enum, transposeEnum,
 	/* Complex In & Out */		hadamardProduct_complexEnum,
 	/* Complex In, Real Out */	squaredMagnitudeEnum, angleLutEnum,
 	/* Real In, Complex out*/	expiLutEnum,
-	/* Complex & Real In, Complex out*/ hadamardProduct_cbrEnum,
+	/* Complex & Real In, Complex out*/ hadamardProduct_cbrEnum, affineTransform_cEnum,
 	None
 } function_t;
 
 static const char* valid_functions_str[] = {
-	/* Matrix Math (2 inputs)*/	"matrixSum", "matrixDiff", "multVecByMat", "multMatByVec", "hadamardProduct",
+	/* Matrix Math (2 inputs)*/	"matrixSum", "matrixDiff", "multVecByMat", "multMatByVec", "matrixMultiply", "multVecByMat_q8", "multVecByMat_q16", "multVecByMat_f16w", "multVecByMatEx", "affineTransform", "hadamardProduct",
 	/* Matrix Math (1 input)*/ 	"elementwisePow2", "relu",
-	/* LUT Operations*/			"sqrtLut", "tanhLut", "sigmoidLut",
-	/* Matrix Manipulation*/	"flip", "extend2", "extend4", "extend8",
+	/* LUT Operations*/			"sqrtLut", "tanhLut", "sigmoidLut", "tanhLutLinear", "sigmoidLutLinear",
+	/* Matrix Manipulation*/	"flip", "extend2", "extend4", "extend8", "transpose",
 	/* Complex In & Out */		"hadamardProduct_complex",
 	/* Complex Inputs */		"squaredMagnitude", "angleLut",
 	/* Complex Outputs*/		"expiLut",
-	/* Compl. & Real In, Complex Out*/ "hadamardProduct_cbr"
+	/* Compl. & Real In, Complex Out*/ "hadamardProduct_cbr", "affineTransform_c"
 };
-static const uint32_t valid_function_count = 19;
+static const uint32_t valid_function_count = 29;
@@ -3,7 +3,6 @@
 #include <complex.h>
 
 #include <pthreads.h>
-#include <fftw3.h>
 
 #include "clock.h"
 #include "csv.h"
@@ -45,12 +44,14 @@ int main(int argc, char **argv) {
 	matrix32c_t fft_matrix;
 	matrix32f_t spec_output;
 	matrix32f_t hann_window;
+	matrix32c_t fft_work;
 
 	audio_input.d = NULL;
 	audio_input_extended.d = NULL;
 	fft_matrix.d  = NULL;
 	spec_output.d = NULL;
 	hann_window.d = NULL;
+	fft_work.d = NULL;
 
 	// Load input
 	int8_t test;
@@ -83,18 +84,21 @@ int main(int argc, char **argv) {
 		ret = 40; goto exit;
 	}
 
-	// Initialize FFTW
-	printf("Generating FFTW plan...");
+	// Initialize FFT
+	printf("Generating FFT plan...");
 	startClock();
-#ifdef USE_THREADS
+#if defined(USE_THREADS) && !defined(BUILTIN_FFT)
 	int threads = 1;
 	printf("(using %d threads) ", threads);
 	fftwf_init_threads();
 	fftwf_plan_with_nthreads(threads);
 #endif
-	fftwf_plan const plan = fftwf_plan_dft_r2c_1d(4096, audio_input_extended.d, fft_matrix.d, FFTW_ESTIMATE);
+	fft_plan_t const plan = stftPlan(4096, STFT_FORWARD, 1, 4096, 4096/2+1, audio_input_extended.d, fft_matrix.d);
+	if(plan == NULL || newMatrix32c(1, 4096/2, &fft_work)) {
+		printf("Error: failed to create the FFT plan.\n");
+		ret = 40; goto exit;
+	}
 	printf("OK!\t(%.2f ms)\n", clockToMS(readClock()));
-	//fftwf_print_plan(plan);
 
 
 	// Load square root LUT
@@ -128,7 +132,7 @@ int main(int argc, char **argv) {
 
 		// FFT
 		temp_time = clock();
-		fftwf_execute(plan);
+		fftForward(plan, audio_input_extended.d, fft_matrix.d, fft_work.d);
 		fft_time += clock() - temp_time;
 
 		// FFT to spectogram
@@ -156,13 +160,13 @@ int main(int argc, char **argv) {
 	printf("\t Worst Time: %4.1f us (%+4.1f us, iter. #%d)\n", clockToMS(worst_time)*1000.0, clockToMS(worst_time)*1000.0-mean_iter_time_us, worst_time_idx);
 	printf("\t Extension Mean Time: %4.1f us\n", clockToMS(extension_time/(float)iterations)*1000.0);
 	printf("\t Hann Window Mean Time: %4.1f us\n", clockToMS(hann_time/(float)iterations)*1000.0);
-	printf("\t FFTW Mean Time: %4.1f us\n", clockToMS(fft_time/(float)iterations)*1000.0);
+	printf("\t FFT Mean Time: %4.1f us\n", clockToMS(fft_time/(float)iterations)*1000.0);
 	printf("\t Spec. Mean Time: %4.1f us\n", clockToMS(spectogram_time/(float)iterations)*1000.0);
 	printf("\t=====================================\n\n");
 
 exit:
-	if(ret < 10)
-		fftwf_destroy_plan(plan);
+	cleanupFFT();
+	deleteMatrix((matrix32f_t*)&fft_work);
 
 	deleteLUT32f(&sqrt_lut);
 	deleteMatrix(&audio_input);
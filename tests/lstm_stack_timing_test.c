@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "lstm_stack.h"
+#include "csv.h"
+#include "clock.h"
+
+const char *frame_in_path[] = { "csv/frame1.csv", "csv/frame2.csv", "csv/frame3.csv" };
+const char *param_path[] = {
+	"parameters/csv/lstm_drums_wl0/lstm_drums_wf.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_wc.csv",
+	"parameters/csv/lstm_drums_wl0/lstm_drums_wi.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_wo.csv",
+
+	"parameters/csv/lstm_drums_wl0/lstm_drums_uf.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_uc.csv",
+	"parameters/csv/lstm_drums_wl0/lstm_drums_ui.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_uo.csv",
+
+	"parameters/csv/lstm_drums_wl0/lstm_drums_fbias.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_cbias.csv",
+	"parameters/csv/lstm_drums_wl0/lstm_drums_ibias.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_obias.csv",
+};
+
+int main(int argc, char **argv) {
+	uint8_t ret = 0;
+	printf("Aias Karioris, 2025\n");
+	printf("LSTM Stack Timing Test");
+#ifndef SERIAL
+	printf(" (NEON)");
+#endif
+#ifdef DEBUG
+	printf(" [Debug Build]");
+#endif
+	printf("\n\n");
+
+	if(argc == 1 || argc > 5) {
+		printf("Usage: %s [contex-size] [iterations] [threads] [packed (0/1)]\n\n", argv[0]);
+		return 1;
+	}
+
+	// For loading messages
+	setvbuf (stdout, NULL, _IONBF, BUFSIZ);
+
+	uint32_t ctx_size   = atoi(argv[1]);
+	uint32_t iterations = (argc >= 3) ? atoi(argv[2]) : 1024;
+	uint32_t threads    = (argc >= 4) ? atoi(argv[3]) : 4;
+	uint8_t lstm_options = (argc == 5 && atoi(argv[4])) ? LSTM_PACKED_WEIGHTS : 0;
+	if(lstm_options & LSTM_PACKED_WEIGHTS) { printf("Using packed weights (fused kernel)\n"); }
+
+	// Load input and make output
+	matrix32f_t *finput;
+	matrix32f_t *foutput;
+
+	finput  = (matrix32f_t*)malloc(ctx_size * sizeof(matrix32f_t));
+	foutput = (matrix32f_t*)malloc(ctx_size * sizeof(matrix32f_t));
+	for(uint32_t i = 0; i < ctx_size; i++) {
+		// We'll fill input buffers later
+		finput[i].d = NULL;
+
+		// Allocate output buffers
+		newMatrix32f(1, 512, &foutput[i]);
+	}
+
+	lstm_t lstm_f[3];
+	lstm_t lstm_b[3];
+	lstm_stack_t stack;
+	stack.cells = NULL;
+
+	lut32f_t sigmoid_lut, tanh_lut;
+	sigmoid_lut.data = NULL; tanh_lut.data = NULL;
+
+	// Create lstms
+	for(int i = 0; i < 3; i++){
+		printf("\r[%d/6] Created fLSTM Cell %d", i*2, i);
+		lstmCreate(512, 256, 0, lstm_options, &lstm_f[i]);
+		printf("\r[%d/6] Created bLSTM Cell %d", i*2+1, i);
+		lstmCreate(512, 256, 1, lstm_options, &lstm_b[i]);
+	}
+	printf("\r[6/6] Created all LSTM Cells.\n");
+
+	// Load LUTs
+	printf("Loading sigmoid LUT...");
+	if(load32fLUT(&sigmoid_lut, "lut/sigmoid.lut")){
+		printf("Error: Could not load LUT for sigmoid function.\n");
+		ret = 3; goto exit;
+	}
+	printf("OK\n");
+
+	printf("Loading tanh LUT...");
+	if(load32fLUT(&tanh_lut, "lut/tanh.lut")){
+		printf("Error: Could not load LUT for tanh function.\n");
+		ret = 3; goto exit;
+	}
+	printf("OK\n");
+
+	// LUTs are ready; configure lstms
+	for(int i = 0; i < 3; i++) {
+		lstmSetLUTs(&sigmoid_lut, &tanh_lut, &lstm_f[i]);
+		lstmSetLUTs(&sigmoid_lut, &tanh_lut, &lstm_b[i]);
+	}
+
+	// Set up parameters; We'll use the same numbers for all cells
+	for(int i = 0; i < 3; i++) {
+		lstmLoadParameters(param_path, &lstm_f[i]);
+		printf("\r[%d/6] Loading parameters...", i*2);
+		lstmLoadParameters(param_path, &lstm_b[i]);
+		printf("\r[%d/6] Loading parameters...", i*2+1);
+	}
+	printf("\r[6/6] All LSTM parameters have been loaded.\n");
+
+	// Fill input buffers
+	int i;
+	for(i = 0; i < 3; i++) {
+		printf("\r[%d/%d] Populating input buffers (importing)...", i, ctx_size);
+		if(matrixFromCSV(frame_in_path[i], 1, 512, &finput[i])) {
+			printf("Error: Could not load input frame (i: %d, path: %s).\n", i, frame_in_path[i]);
+			ret = 5; goto exit;
+		}
+	}
+	for(i; i < ctx_size; i++) {
+		printf("\r[%d/%d] Populating input buffers (copying)...  ", i, ctx_size);
+		if(newMatrix32f(1, 512, &finput[i])) {
+			printf("Error: Could not allocate memory for input buffer.\n");
+			ret = 6; goto exit;
+		}
+		// Copy data from one of the first 3 input buffers
+		memcpy(finput[i].d, finput[i%3].d, sizeof(float32_t) * finput[0].w*finput[0].h);
+	}
+	printf("\r[%d/%d] Input buffers ready: 3 imported, %d copied.\n", ctx_size, ctx_size, ctx_size-3);
+
+	// Cells are connected by the stack
+	if(lstmStackCreate(lstm_f, lstm_b, 3, threads, &stack)) {
+		printf("Error: Could not create the LSTM stack.\n");
+		ret = 7; goto exit;
+	}
+	printf("Running on %d threads\n", stack.threads);
+
+	// Perform tests and time them
+	float run_time_ms = 0;
+	float cell_time_ms[6] = { 0 };
+	float wait_time_ms[LSTM_STACK_MAX_THREADS] = { 0 };
+	for(size_t iter = 0; iter < iterations; iter++) {
+		lstmStackRun(&stack, finput, ctx_size, foutput);
+
+		run_time_ms += stack.run_time_ms;
+		for(uint8_t c = 0; c < 6; c++) { cell_time_ms[c] += stack.cell_time_ms[c]; }
+		for(uint8_t t = 0; t < stack.threads; t++) { wait_time_ms[t] += stack.thread_wait_ms[t]; }
+	}
+
+	printf("\nLSTM Stack Results\n");
+	printf("\t=====================================\n");
+	printf("\t Time for %4d iterations: %4.3f ms\n", iterations, run_time_ms);
+	printf("\t Mean Time/iter.:   %2.2f ms\n", run_time_ms / (float)iterations);
+	printf("\t-------------------------------------\n");
+	for(uint8_t c = 0; c < 6; c++) {
+		printf("\t %cLSTM %d (thread %d): %4.2f ms\n", (c%2) ? 'b' : 'f', c/2, c % stack.threads, cell_time_ms[c] / (float)iterations);
+	}
+	for(uint8_t t = 0; t < stack.threads; t++) {
+		printf("\t Thread %d waiting:   %4.2f ms\n", t, wait_time_ms[t] / (float)iterations);
+	}
+	printf("\t=====================================\n\n");
+
+
+exit:
+	lstmStackDelete(&stack);
+	for(uint8_t m = 0; m < 3; m++) {
+		lstmDelete(&lstm_f[m]);
+		lstmDelete(&lstm_b[m]);
+	}
+	deleteLUT32f(&sigmoid_lut);
+	deleteLUT32f(&tanh_lut);
+
+	for(uint32_t i = 0; i < ctx_size; i++) {
+		deleteMatrix(&finput[i]);
+		deleteMatrix(&foutput[i]);
+	}
+	free(finput);
+	free(foutput);
+
+	return ret;
+}
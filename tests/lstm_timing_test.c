@@ -1,10 +1,27 @@
 #include <stdio.h>
 #include <string.h>
+#include <math.h> // fabsf
 
 #include "lstm.h"
 #include "csv.h"
 #include "clock.h"
 
+// Largest difference allowed between `lstm_in_sequence` and `lstm_in`; The sums are done in a different order.
+// With LUTs that may move a gate pre-activation to the next entry, so SEQUENCE_LUT_STEPS times the largest
+// step between neighbouring entries is allowed instead.
+#define SEQUENCE_TOLERANCE	1e-4
+#define SEQUENCE_LUT_STEPS	2
+
+// Largest difference between neighbouring entries of a nearest-entry LUT
+static float32_t lutMaxStep(lut32f_t *lut) {
+	float32_t step = 0;
+	for(size_t i = 1; i < lut->length; i++) {
+		float32_t diff = fabsf(lut->data[i] - lut->data[i-1]);
+		step = (diff > step) ? diff : step;
+	}
+	return step;
+}
+
 const char *frame_in_path[] = { "csv/frame1.csv", "csv/frame2.csv", "csv/frame3.csv" };
 const char *param_path[] = {
 	"parameters/csv/lstm_drums_wl0/lstm_drums_wf.csv", "parameters/csv/lstm_drums_wl0/lstm_drums_wc.csv",
@@ -29,8 +46,8 @@ int main(int argc, char **argv) {
 #endif
 	printf("\n\n");
 
-	if(argc == 1 || argc > 3) {
-		printf("Usage: %s [contex-size] [iterations]\n\n", argv[0]);
+	if(argc == 1 || argc > 5) {
+		printf("Usage: %s [contex-size] [iterations] [weights (0: float, 1: packed, 2: 8-bit quantized, 3: 16-bit fixed point, 4: half precision)] [approximations (0/1)]\n\n", argv[0]);
 		return 1;
 	}
 
@@ -40,7 +57,18 @@ int main(int argc, char **argv) {
 	// If no argument is passed, both contex-size and iterations are assumed
 	// If one argument is passed, it is interpreted as the context-size and iterations are assumed
 	uint32_t ctx_size   = atoi(argv[1]);
-	uint32_t iterations = (argc == 3) ? atoi(argv[2]) : 1024;
+	uint32_t iterations = (argc >= 3) ? atoi(argv[2]) : 1024;
+	// Optionally use the packed weight layout and the fused LSTM kernel, 8-bit weights, fixed point or half precision weights
+	uint8_t weights = (argc >= 4) ? atoi(argv[3]) : 0;
+	// Optionally calculate sigmoid/tanh instead of using the LUTs
+	uint8_t approx = (argc == 5) ? atoi(argv[4]) : 0;
+	const uint8_t weight_options[] = { 0, LSTM_PACKED_WEIGHTS, LSTM_QUANTIZED_WEIGHTS, LSTM_FIXED_POINT, LSTM_HALF_WEIGHTS };
+	uint8_t lstm_options = (weights < 5) ? weight_options[weights] : 0;
+	if(lstm_options & LSTM_PACKED_WEIGHTS) { printf("Using packed weights (fused kernel)\n"); }
+	if(lstm_options & LSTM_QUANTIZED_WEIGHTS) { printf("Using 8-bit quantized weights\n"); }
+	if(lstm_options & LSTM_FIXED_POINT) { printf("Using 16-bit fixed point\n"); }
+	if(lstm_options & LSTM_HALF_WEIGHTS) { printf("Using half precision weights\n"); }
+	if(approx) { printf("Using approximated activations (no LUTs)\n"); }
 
 	// Load input and make output
 	matrix32f_t *finput;
@@ -62,13 +90,15 @@ int main(int argc, char **argv) {
 
 	lut32f_t sigmoid_lut, tanh_lut;
 	sigmoid_lut.data = NULL; tanh_lut.data = NULL;
+	lut16q_t sigmoid_lut16, tanh_lut16;
+	sigmoid_lut16.data = NULL; tanh_lut16.data = NULL;
 
 	// Create lstms
 	for(int i = 0; i < 3; i++){
 		printf("\r[%d/6] Created fLSTM Cell %d", i*2, i);
-		lstmCreate(512, 256, 0, &lstm_f[i]);
+		lstmCreate(512, 256, 0, lstm_options, &lstm_f[i]);
 		printf("\r[%d/6] Created bLSTM Cell %d", i*2+1, i);
-		lstmCreate(512, 256, 1, &lstm_b[i]);
+		lstmCreate(512, 256, 1, lstm_options, &lstm_b[i]);
 	}
 	printf("\r[6/6] Created all LSTM Cells.\n");
 
@@ -87,10 +117,26 @@ int main(int argc, char **argv) {
 	}
 	printf("OK\n");
 
+	// Fixed point cells sample the float LUTs; Gate pre-activations are the LUTs' inputs
+	if(lstm_options & LSTM_FIXED_POINT) {
+		if(lutTo16q(&sigmoid_lut, LSTM_Q16_GATE_INT_BITS, 0, 12, &sigmoid_lut16) || lutTo16q(&tanh_lut, LSTM_Q16_GATE_INT_BITS, 0, 12, &tanh_lut16)) {
+			printf("Error: Could not create fixed point LUTs.\n");
+			ret = 3; goto exit;
+		}
+	}
+
 	// LUTs are ready; configure lstms
 	for(int i = 0; i < 3; i++) {
 		lstmSetLUTs(&sigmoid_lut, &tanh_lut, &lstm_f[i]);
 		lstmSetLUTs(&sigmoid_lut, &tanh_lut, &lstm_b[i]);
+		if(approx) {
+			lstmSetApproximations(&lstm_f[i]);
+			lstmSetApproximations(&lstm_b[i]);
+		}
+		if(lstm_options & LSTM_FIXED_POINT) {
+			lstmSetLUTs_q16(&sigmoid_lut16, &tanh_lut16, &lstm_f[i]);
+			lstmSetLUTs_q16(&sigmoid_lut16, &tanh_lut16, &lstm_b[i]);
+		}
 	}
 
 	// Set up parameters; We'll use the same numbers for all cells
@@ -179,6 +225,77 @@ int main(int argc, char **argv) {
 	//printf("\t Copy Time: %4.1f ms\n", clockToMS(copy_time));
 	printf("\t=====================================\n\n");
 
+	// Compare the first layer frame-by-frame against the whole-sequence entry point
+	matrix32f_t seq_output, frame_output;
+	seq_output.d = NULL; frame_output.d = NULL;
+	if(newMatrix32f(ctx_size, 256, &seq_output) || newMatrix32f(ctx_size, 256, &frame_output)) {
+		printf("Error: Could not allocate memory for sequence output.\n");
+		deleteMatrix(&seq_output);
+		ret = 7; goto exit;
+	}
+
+	// Both start from a reset state and get the same frames; Only the order of the additions differs.
+	// The whole sequence fits in the buffers reserved last; the first reservation splits it in 3 chunks.
+	float32_t max_diff = 0;
+	lstm_t *first_layer[] = { &lstm_f[0], &lstm_b[0] };
+	size_t capacity[] = { (ctx_size + 2) / 3, ctx_size };
+	for(uint8_t r = 0; r < 2; r++) {
+		for(uint8_t l = 0; l < 2; l++) {
+			if(lstmReserveSequence(capacity[r], first_layer[l])) {
+				printf("Error: Could not reserve the sequence buffers.\n");
+				deleteMatrix(&seq_output); deleteMatrix(&frame_output);
+				ret = 7; goto exit;
+			}
+			lstmReset(first_layer[l]);
+			for(size_t c = 0; c < ctx_size; c++) {
+				size_t t = (first_layer[l]->direction == 0) ? c : ctx_size - c - 1;
+				lstm_in(&finput[t], first_layer[l]);
+				memcpy(&frame_output.d[t*256], first_layer[l]->h.d, 256*sizeof(float32_t));
+			}
+			lstmReset(first_layer[l]);
+			lstm_in_sequence(finput, ctx_size, first_layer[l], &seq_output);
+
+			for(size_t j = 0; j < ctx_size*256; j++) {
+				float32_t diff = fabsf(seq_output.d[j] - frame_output.d[j]);
+				max_diff = (diff > max_diff) ? diff : max_diff;
+			}
+		}
+	}
+	deleteMatrix(&frame_output);
+	printf("First layer, sequence vs. per-frame: Max. Difference %.3e\n\n", max_diff);
+	float32_t tolerance = SEQUENCE_TOLERANCE;
+	if(!approx) {
+		float32_t sigmoid_step = lutMaxStep(&sigmoid_lut), tanh_step = lutMaxStep(&tanh_lut);
+		tolerance = SEQUENCE_LUT_STEPS * ((sigmoid_step > tanh_step) ? sigmoid_step : tanh_step);
+	}
+	if(max_diff > tolerance) {
+		printf("Error: lstm_in_sequence doesn't match lstm_in (tolerance %.1e).\n\n", tolerance);
+		deleteMatrix(&seq_output);
+		ret = 8; goto exit;
+	}
+
+	clock_t frame_time = clock();
+	for(size_t iter = 0; iter < iterations; iter++) {
+		for(size_t c = 0; c < ctx_size; c++) {
+			lstm_in(&finput[c], &lstm_f[0]);
+			lstm_in(&finput[ctx_size - c - 1], &lstm_b[0]);
+		}
+	}
+	frame_time = clock() - frame_time;
+
+	clock_t seq_time = clock();
+	for(size_t iter = 0; iter < iterations; iter++) {
+		lstm_in_sequence(finput, ctx_size, &lstm_f[0], &seq_output);
+		lstm_in_sequence(finput, ctx_size, &lstm_b[0], &seq_output);
+	}
+	seq_time = clock() - seq_time;
+	deleteMatrix(&seq_output);
+
+	printf("First Layer Results (f0 + b0)\n");
+	printf("\t=====================================\n");
+	printf("\t Per-frame Time/iter.: %4.2f ms\n", clockToMS(frame_time) / (float)iterations);
+	printf("\t Sequence Time/iter.:  %4.2f ms\n", clockToMS(seq_time) / (float)iterations);
+	printf("\t=====================================\n\n");
 
 exit:
 	for(uint8_t m = 0; m < 3; m++) {
@@ -187,6 +304,8 @@ exit:
 	}
 	deleteLUT32f(&sigmoid_lut);
 	deleteLUT32f(&tanh_lut);
+	deleteLUT16q(&sigmoid_lut16);
+	deleteLUT16q(&tanh_lut16);
 
 	for(uint32_t i = 0; i < ctx_size; i++) {
 		deleteMatrix(&finput[i]);
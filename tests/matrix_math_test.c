@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 
 #include "csv.h"
 #include "matrix_math.h"
@@ -12,6 +13,237 @@
 
 float32_t f32abs(float32_t f) { return (f>=0)?f:(-1.0*f); }
 
+// Largest (relative) error of `multVecByMatEx` over the first `cols` columns of `mat` against `multVecByMat`, `matrixSum`
+// and the activation; Without a bias, with one and with the bias aliased to the output, for every activation (tanh and
+// sigmoid from the LUTs and calculated). Returns -1 if memory can't be allocated.
+float32_t multVecByMatExError(matrix32f_t *vec, matrix32f_t *mat, size_t cols, lut32f_t *tanh_lut, lut32f_t *sigmoid_lut) {
+	matrix32f_t mat_cols, bias, ref, out;
+	mat_cols.d = NULL; bias.d = NULL; ref.d = NULL; out.d = NULL;
+	float32_t max_err = -1;
+	if(newMatrix32f(mat->h, cols, &mat_cols) || newMatrix32f(1, cols, &bias) || newMatrix32f(1, cols, &ref) || newMatrix32f(1, cols, &out)) { goto exit; }
+	for(size_t k = 0; k < mat->h; k++) { memcpy(&mat_cols.d[k*cols], &mat->d[k*mat->w], cols*sizeof(float32_t)); }
+	for(size_t j = 0; j < cols; j++) { bias.d[j] = 0.5 - (float32_t)(j % 7) / 6.0; }
+
+	max_err = 0;
+	for(uint8_t bias_mode = 0; bias_mode < 3; bias_mode++) {
+		for(uint8_t act = ACTIVATION_NONE; act <= ACTIVATION_SIGMOID; act++) {
+			for(uint8_t use_lut = 0; use_lut <= (act >= ACTIVATION_TANH); use_lut++) {
+				lut32f_t *lut = (!use_lut) ? NULL : (act == ACTIVATION_TANH) ? tanh_lut : sigmoid_lut;
+
+				multVecByMat(vec, &mat_cols, &ref);
+				if(bias_mode) { matrixSum(&ref, &bias, &ref); }
+				if(act == ACTIVATION_RELU) { relu(&ref, &ref); }
+				else if(act == ACTIVATION_TANH) {
+					if(lut) { clampingLUT(&ref, lut, &ref); } else { tanhApprox(&ref, &ref); }
+				}
+				else if(act == ACTIVATION_SIGMOID) {
+					if(lut) { clampingLUT(&ref, lut, &ref); } else { sigmoidApprox(&ref, &ref); }
+				}
+
+				// bias_mode 2 accumulates onto the bias, copied to the output
+				if(bias_mode == 2) { memcpy(out.d, bias.d, cols*sizeof(float32_t)); }
+				multVecByMatEx(vec, &mat_cols, (bias_mode == 0) ? NULL : (bias_mode == 1) ? &bias : &out, act, lut, &out);
+
+				float32_t err;
+				for(size_t j = 0; j < cols; j++) {
+					err = f32abs(out.d[j] - ref.d[j]) / (1.0 + f32abs(ref.d[j]));
+					if(err > 1e-3 && err > max_err) {
+						printf("multVecByMatEx (%lu columns, bias %d, activation %d, LUT %d): column %lu is %f, not %f\n", cols, bias_mode, act, use_lut, j, out.d[j], ref.d[j]);
+					}
+					max_err = (err > max_err) ? err : max_err;
+				}
+			}
+		}
+	}
+
+exit:
+	deleteMatrix(&mat_cols);
+	deleteMatrix(&bias);
+	deleteMatrix(&ref);
+	deleteMatrix(&out);
+	return max_err;
+}
+
+// Largest (relative) error of `affineTransform` over the first `cols` columns of every row of `in` against `hadamardProduct`
+// and `matrixSum` row by row; Per bin and broadcast (1 x 1) scales and shifts, in place and out of place. Returns -1 if
+// memory can't be allocated.
+float32_t affineTransformError(matrix32f_t *in, size_t cols) {
+	size_t rows = in->h;
+	matrix32f_t in_cols, ref, out, scale_bins, shift_bins, scale_one, shift_one, scale_row, shift_row;
+	in_cols.d = NULL; ref.d = NULL; out.d = NULL; scale_bins.d = NULL; shift_bins.d = NULL; scale_one.d = NULL; shift_one.d = NULL;
+	scale_row.d = NULL; shift_row.d = NULL;
+	float32_t max_err = -1;
+	if(newMatrix32f(rows, cols, &in_cols) || newMatrix32f(rows, cols, &ref) || newMatrix32f(rows, cols, &out) ||
+	   newMatrix32f(1, cols, &scale_bins) || newMatrix32f(1, cols, &shift_bins) || newMatrix32f(1, 1, &scale_one) || newMatrix32f(1, 1, &shift_one) ||
+	   newMatrix32f(1, cols, &scale_row) || newMatrix32f(1, cols, &shift_row)) {
+		goto exit;
+	}
+	for(size_t r = 0; r < rows; r++) { memcpy(&in_cols.d[r*cols], &in->d[r*in->w], cols*sizeof(float32_t)); }
+	for(size_t j = 0; j < cols; j++) { scale_bins.d[j] = 0.5 + (float32_t)(j % 5) * 0.25; shift_bins.d[j] = (float32_t)(j % 3) - 1.0; }
+	scale_one.d[0] = 1.5; shift_one.d[0] = -0.25;
+
+	max_err = 0;
+	for(uint8_t mode = 0; mode < 8; mode++) {
+		// bit 0: broadcast scale, bit 1: broadcast shift, bit 2: in place
+		matrix32f_t *scale = (mode & 1) ? &scale_one : &scale_bins;
+		matrix32f_t *shift = (mode & 2) ? &shift_one : &shift_bins;
+
+		// The reference takes full rows of the broadcast values
+		for(size_t j = 0; j < cols; j++) { scale_row.d[j] = scale->d[(mode & 1) ? 0 : j]; shift_row.d[j] = shift->d[(mode & 2) ? 0 : j]; }
+		memcpy(ref.d, in_cols.d, rows*cols*sizeof(float32_t));
+		for(size_t r = 0; r < rows; r++) {
+			matrix32f_t ref_row = { 1, cols, &ref.d[r*cols] };
+			hadamardProduct(&ref_row, &scale_row, NULL);
+			matrixSum(&ref_row, &shift_row, NULL);
+		}
+
+		if(mode & 4) { memcpy(out.d, in_cols.d, rows*cols*sizeof(float32_t)); affineTransform(&out, scale, shift, NULL); }
+		else { affineTransform(&in_cols, scale, shift, &out); }
+
+		float32_t err;
+		for(size_t j = 0; j < rows*cols; j++) {
+			err = f32abs(out.d[j] - ref.d[j]) / (1.0 + f32abs(ref.d[j]));
+			if(err > 1e-5 && err > max_err) { printf("affineTransform (%lu columns, mode %d): element %lu is %f, not %f\n", cols, mode, j, out.d[j], ref.d[j]); }
+			max_err = (err > max_err) ? err : max_err;
+		}
+	}
+
+exit:
+	deleteMatrix(&in_cols); deleteMatrix(&ref); deleteMatrix(&out);
+	deleteMatrix(&scale_bins); deleteMatrix(&shift_bins); deleteMatrix(&scale_one); deleteMatrix(&shift_one);
+	deleteMatrix(&scale_row); deleteMatrix(&shift_row);
+	return max_err;
+}
+
+// Same as `affineTransformError` for `affineTransform_c` against `hadamardProduct_cbr` and `matrixSum` (on the
+// interleaved floats); The complex shift is per bin, broadcast or NULL.
+float32_t affineTransformError_c(matrix32c_t *cin, size_t cols) {
+	size_t rows = cin->h;
+	matrix32c_t in_cols, ref, out, shift_bins, shift_one, shift_row;
+	matrix32f_t scale_bins, scale_one, scale_row;
+	in_cols.d = NULL; ref.d = NULL; out.d = NULL; shift_bins.d = NULL; shift_one.d = NULL; shift_row.d = NULL;
+	scale_bins.d = NULL; scale_one.d = NULL; scale_row.d = NULL;
+	float32_t max_err = -1;
+	if(newMatrix32c(rows, cols, &in_cols) || newMatrix32c(rows, cols, &ref) || newMatrix32c(rows, cols, &out) ||
+	   newMatrix32c(1, cols, &shift_bins) || newMatrix32c(1, 1, &shift_one) || newMatrix32c(1, cols, &shift_row) ||
+	   newMatrix32f(1, cols, &scale_bins) || newMatrix32f(1, 1, &scale_one) || newMatrix32f(1, cols, &scale_row)) {
+		goto exit;
+	}
+	for(size_t r = 0; r < rows; r++) { memcpy(&in_cols.d[r*cols], &cin->d[r*cin->w], cols*sizeof(float complex)); }
+	for(size_t j = 0; j < cols; j++) {
+		scale_bins.d[j] = 0.5 + (float32_t)(j % 5) * 0.25;
+		shift_bins.d[j] = ((float32_t)(j % 3) - 1.0) + ((float32_t)(j % 4) * 0.5) * I;
+	}
+	scale_one.d[0] = 1.5; shift_one.d[0] = -0.25 + 0.75*I;
+
+	max_err = 0;
+	for(uint8_t mode = 0; mode < 12; mode++) {
+		// mode % 2: broadcast scale, (mode / 2) % 3: per bin/broadcast/NULL shift, mode >= 6: in place
+		uint8_t shift_mode = (mode / 2) % 3;
+		matrix32f_t *scale = (mode % 2) ? &scale_one : &scale_bins;
+		matrix32c_t *shift = (shift_mode == 0) ? &shift_bins : (shift_mode == 1) ? &shift_one : NULL;
+
+		for(size_t j = 0; j < cols; j++) {
+			scale_row.d[j] = scale->d[(mode % 2) ? 0 : j];
+			shift_row.d[j] = (shift == NULL) ? 0 : shift->d[(shift_mode == 1) ? 0 : j];
+		}
+		memcpy(ref.d, in_cols.d, rows*cols*sizeof(float complex));
+		matrix32f_t shift_rowf = { 1, 2*cols, (float32_t*)shift_row.d };
+		for(size_t r = 0; r < rows; r++) {
+			matrix32c_t ref_row = { 1, cols, &ref.d[r*cols] };
+			matrix32f_t ref_rowf = { 1, 2*cols, (float32_t*)&ref.d[r*cols] };
+			hadamardProduct_cbr(&ref_row, &scale_row, NULL);
+			matrixSum(&ref_rowf, &shift_rowf, NULL);
+		}
+
+		if(mode >= 6) { memcpy(out.d, in_cols.d, rows*cols*sizeof(float complex)); affineTransform_c(&out, scale, shift, NULL); }
+		else { affineTransform_c(&in_cols, scale, shift, &out); }
+
+		float32_t err;
+		float32_t *outf = (float32_t*)out.d, *reff = (float32_t*)ref.d;
+		for(size_t j = 0; j < 2*rows*cols; j++) {
+			err = f32abs(outf[j] - reff[j]) / (1.0 + f32abs(reff[j]));
+			if(err > 1e-5 && err > max_err) { printf("affineTransform_c (%lu columns, mode %d): float %lu is %f, not %f\n", cols, mode, j, outf[j], reff[j]); }
+			max_err = (err > max_err) ? err : max_err;
+		}
+	}
+
+exit:
+	deleteMatrix((matrix32f_t*)&in_cols); deleteMatrix((matrix32f_t*)&ref); deleteMatrix((matrix32f_t*)&out);
+	deleteMatrix((matrix32f_t*)&shift_bins); deleteMatrix((matrix32f_t*)&shift_one); deleteMatrix((matrix32f_t*)&shift_row);
+	deleteMatrix(&scale_bins); deleteMatrix(&scale_one); deleteMatrix(&scale_row);
+	return max_err;
+}
+
+// Input of a LUT clamped to the range its entries cover
+float32_t lutClampInput(float32_t x, lut32f_t *lut) {
+	float32_t lo = -lut->bias / lut->mult_factor, hi = (lut->length - 1 - lut->bias) / lut->mult_factor;
+	return (x < lo) ? lo : (x > hi) ? hi : x;
+}
+
+// Largest error of `angleLUT_c` with a LUT_LINEAR version of the atan table `lut` against atanf, over all values and
+// without the last one (the scalar tail). Returns -1 on failure.
+float32_t angleLinearError(matrix32c_t *cin, lut32f_t *lut) {
+	size_t len = cin->h * cin->w;
+	lut32f_t linear;
+	matrix32f_t out;
+	linear.data = NULL; out.d = NULL;
+	float32_t max_err = -1;
+	if(lutToLinear(lut, 1e-5, &linear) || newMatrix32f(1, len, &out)) { goto exit; }
+	printf("Linear atan LUT: %u entries (from %u)\n", linear.length, lut->length);
+
+	max_err = 0;
+	for(size_t tail = 0; tail <= (len > 1); tail++) {
+		matrix32c_t in_view  = { 1, len - tail, cin->d };
+		matrix32f_t out_view = { 1, len - tail, out.d };
+		angleLUT_c(&in_view, &linear, &out_view);
+
+		float32_t err, ref;
+		for(size_t i = 0; i < len - tail; i++) {
+			ref = atanf(lutClampInput(cimagf(cin->d[i]) / crealf(cin->d[i]), lut));
+			err = f32abs(out.d[i] - ref);
+			if(err > 1e-4 && err > max_err) { printf("angleLUT_c (linear, %lu values): value %lu is %f, not %f\n", len - tail, i, out.d[i], ref); }
+			max_err = (err > max_err) ? err : max_err;
+		}
+	}
+
+exit:
+	deleteLUT32f(&linear);
+	deleteMatrix(&out);
+	return max_err;
+}
+
+// Same as `angleLinearError` for `expiLUT` with LUT_LINEAR versions of the sine and cosine tables
+float32_t expiLinearError(matrix32f_t *in, lut32f_t *sinlut, lut32f_t *coslut) {
+	size_t len = in->h * in->w;
+	lut32f_t sin_linear, cos_linear;
+	matrix32c_t out;
+	sin_linear.data = NULL; cos_linear.data = NULL; out.d = NULL;
+	float32_t max_err = -1;
+	if(lutToLinear(sinlut, 1e-5, &sin_linear) || lutToLinear(coslut, 1e-5, &cos_linear) || newMatrix32c(1, len, &out)) { goto exit; }
+
+	max_err = 0;
+	for(size_t tail = 0; tail <= (len > 1); tail++) {
+		matrix32f_t in_view  = { 1, len - tail, in->d };
+		matrix32c_t out_view = { 1, len - tail, out.d };
+		expiLUT(&in_view, &sin_linear, &cos_linear, &out_view);
+
+		float32_t err;
+		for(size_t i = 0; i < len - tail; i++) {
+			float32_t x = lutClampInput(in->d[i], sinlut);
+			err = f32abs(crealf(out.d[i]) - cosf(x)) + f32abs(cimagf(out.d[i]) - sinf(x));
+			if(err > 1e-4 && err > max_err) { printf("expiLUT (linear, %lu values): value %lu is %f%+fi, not %f%+fi\n", len - tail, i, crealf(out.d[i]), cimagf(out.d[i]), cosf(x), sinf(x)); }
+			max_err = (err > max_err) ? err : max_err;
+		}
+	}
+
+exit:
+	deleteLUT32f(&sin_linear);
+	deleteLUT32f(&cos_linear);
+	deleteMatrix((matrix32f_t*)&out);
+	return max_err;
+}
+
 int main(int argc, char **argv) {
 	uint8_t ret = 0;
 	printf("Aias Karioris, 2025\n");
@@ -28,6 +260,12 @@ int main(int argc, char **argv) {
 	lut32f_t lut1; lut1.data = NULL;
 	matrix32f_t input1, input2, output1, expected_output;
 	input1.d = NULL, input2.d = NULL, output1.d = NULL, expected_output.d = NULL;
+	matrix8q_t qinput2;
+	qinput2.d = NULL; qinput2.scale = NULL;
+	matrix16q_t q16input1, q16input2, q16output1;
+	q16input1.d = NULL; q16input2.d = NULL; q16output1.d = NULL;
+	matrix16f_t hinput2;
+	hinput2.d = NULL;
 	matrix32c_t cinput1, cinput2, coutput1, cexpected_output;
 	cinput1.d = NULL; cinput2.d = NULL; coutput1.d = NULL; cexpected_output.d = NULL;
 
@@ -55,7 +293,7 @@ int main(int argc, char **argv) {
 	// The following size refer to the number of elements (not floats as in 2 floats per complex element)
 	size_t w1, h1, w2=0, h2=0, wo, ho;
 	h1 = atoi(argv[2]);	w1 = atoi(argv[3]);
-	if(selected_function <= hadamardProductEnum || selected_function == hadamardProduct_complexEnum || selected_function == hadamardProduct_cbrEnum) { // Some functions require 2 inputs
+	if(selected_function <= hadamardProductEnum || selected_function == hadamardProduct_complexEnum || selected_function == hadamardProduct_cbrEnum || selected_function == affineTransform_cEnum) { // Some functions require 2 inputs
 		h2 = atoi(argv[5]); w2 = atoi(argv[6]);
 	}
 
@@ -70,6 +308,22 @@ int main(int argc, char **argv) {
 			ho = 1; wo = w2; break;
 		case multMatByVecEnum:
 			ho = h1; wo = 1; break;
+		case matrixMultiplyEnum:
+			ho = h1; wo = w2; break;
+		case multVecByMat_q8Enum:
+		case multVecByMat_q16Enum:
+		case multVecByMat_f16wEnum:
+			ho = 1; wo = w2; break;
+		case multVecByMatExEnum:
+			// The expected output is the plain product; The LUTs are used by the epilogue cases
+			if(load32fLUT(&lut0, "lut/tanh65537.lut") || load32fLUT(&lut1, "lut/sigmoid65537.lut")) {
+				printf("Error: Could not load Tanh/Sigmoid LUTs.\n\n");
+				ret = 10; goto exit;
+			}
+			ho = 1; wo = w2; break;
+		case affineTransformEnum:
+			// input2 is the scale (per bin or a single value), the shift is 0; The expected output is in0 .* scale
+			wo = w1; ho = h1; break;
 		case hadamardProductEnum:
 			wo = w1; ho = h1; break;
 		case elementwisePow2Enum:
@@ -94,6 +348,15 @@ int main(int argc, char **argv) {
 				ret = 10; goto exit;
 			}
 			wo = w1; ho = h1; break;
+		case tanhLutLinearEnum:
+		case sigmoidLutLinearEnum:
+			// Same functions from a compact linear table, converted from the nearest-entry one
+			if(load32fLUT(&lut1, (selected_function == tanhLutLinearEnum) ? "lut/tanh65537.lut" : "lut/sigmoid65537.lut") || lutToLinear(&lut1, 1e-5, &lut0)) {
+				printf("Error: Could not load/convert Tanh/Sigmoid LUT.\n\n");
+				ret = 10; goto exit;
+			}
+			printf("Linear LUT: %u entries (from %u)\n", lut0.length, lut1.length);
+			wo = w1; ho = h1; break;
 		case flipEnum:
 			wo = w1; ho = h1; break;
 		case extend2Enum:
@@ -102,6 +365,8 @@ int main(int argc, char **argv) {
 			wo = w1*4; ho = h1; break;
 		case extend8Enum:
 			wo = w1*8; ho = h1; break;
+		case transposeEnum:
+			wo = h1; ho = w1; break;
 		case squaredMagnitudeEnum:
 			wo = w1; ho = h1; break;
 		case hadamardProduct_complexEnum:
@@ -120,6 +385,9 @@ int main(int argc, char **argv) {
 			wo = w1; ho = h1; break;
 		case hadamardProduct_cbrEnum:
 			wo = w1; ho = h1; break;
+		case affineTransform_cEnum:
+			// The real input is the scale (per bin or a single value), the shift is NULL; The expected output is cin0 .* scale
+			wo = w1; ho = h1; break;
 		default:
 			ret = -2; goto exit;
 	}
@@ -298,7 +566,7 @@ int main(int argc, char **argv) {
 		coutput1.w /= 2;
 	}
 	// Expect one real and one complex input, config. complex output
-	else if(selected_function == hadamardProduct_cbrEnum) {
+	else if(selected_function == hadamardProduct_cbrEnum || selected_function == affineTransform_cEnum) {
 		// Complex input (first)
 		printf("Loading %s...", argv[4]);
 		if(test = matrixFromCSV(argv[4], h1, w1*2, (matrix32f_t*)&cinput1)) {
@@ -310,7 +578,7 @@ int main(int argc, char **argv) {
 
 		// Real input (second)
 		printf("Loading %s...", argv[7]);
-		if(test = matrixFromCSV(argv[7], h1, w1, &input1)) {
+		if(test = matrixFromCSV(argv[7], h2, w2, &input1)) {
 			printf("\nError (%d): failed to import %s!\n\n", test, argv[4]);
 			ret = 3; goto exit;
 		}
@@ -334,6 +602,34 @@ int main(int argc, char **argv) {
 		coutput1.w /= 2;
 	}
 
+	// The quantized multiplication takes a quantized second input
+	if(selected_function == multVecByMat_q8Enum && quantizeMatrix8q(&input2, &qinput2)) {
+		printf("Error: failed to quantize %s.\n\n", argv[7]);
+		ret = 3; goto exit;
+	}
+	// The fixed point multiplication takes both inputs in fixed point; The output gets the accumulator's format
+	if(selected_function == multVecByMat_q16Enum) {
+		uint8_t int_bits1 = matrixIntBits16q(&input1), int_bits2 = matrixIntBits16q(&input2);
+		if(newMatrix16q(input1.h, input1.w, int_bits1, &q16input1) || newMatrix16q(input2.h, input2.w, int_bits2, &q16input2) ||
+		   newMatrix16q(ho, wo, (int_bits1 + int_bits2 > 15) ? 15 : int_bits1 + int_bits2, &q16output1)) {
+			printf("Error: failed to create the fixed point matrices.\n\n");
+			ret = 3; goto exit;
+		}
+		matrixTo16q(&input1, &q16input1);
+		matrixTo16q(&input2, &q16input2);
+	}
+	// The affine transform is tested with a broadcast shift of 0
+	float32_t zero = 0;
+	matrix32f_t zero_shift = { 1, 1, &zero };
+	// The half precision multiplication takes half precision weights
+	if(selected_function == multVecByMat_f16wEnum) {
+		if(newMatrix16f(input2.h, input2.w, &hinput2)) {
+			printf("Error: failed to create the half precision matrix.\n\n");
+			ret = 3; goto exit;
+		}
+		matrixTo16f(&input2, &hinput2);
+	}
+
 	// Perform test
 	switch(selected_function) {
 		case matrixSumEnum:
@@ -344,6 +640,18 @@ int main(int argc, char **argv) {
 			startClock(); multVecByMat(&input1, &input2, &output1);	break;
 		case multMatByVecEnum:
 			startClock(); multMatByVec(&input1, &input2, &output1); break;
+		case matrixMultiplyEnum:
+			startClock(); matrixMultiply(&input1, &input2, &output1); break;
+		case multVecByMat_q8Enum:
+			startClock(); multVecByMat_q8(&input1, &qinput2, &output1); break;
+		case multVecByMat_q16Enum:
+			startClock(); multVecByMat_q16(&q16input1, &q16input2, &q16output1); break;
+		case multVecByMat_f16wEnum:
+			startClock(); multVecByMat_f16w(&input1, &hinput2, &output1); break;
+		case multVecByMatExEnum:
+			startClock(); multVecByMatEx(&input1, &input2, NULL, ACTIVATION_NONE, NULL, &output1); break;
+		case affineTransformEnum:
+			startClock(); affineTransform(&input1, &input2, &zero_shift, &output1); break;
 		case hadamardProductEnum:
 			startClock(); hadamardProduct(&input1, &input2, &output1); break;
 		case elementwisePow2Enum:
@@ -356,6 +664,9 @@ int main(int argc, char **argv) {
 			startClock(); clampingLUT(&input1, &lut0, &output1); break;
 		case sigmoidLutEnum:
 			startClock(); clampingLUT(&input1, &lut0, &output1); break;
+		case tanhLutLinearEnum:
+		case sigmoidLutLinearEnum:
+			startClock(); clampingLUT(&input1, &lut0, &output1); break;
 		case flipEnum:
 			startClock(); flipVector(&input1, &output1); break;
 		case extend2Enum:
@@ -364,6 +675,8 @@ int main(int argc, char **argv) {
 			startClock(); extendInput(&input1, &output1, 4); break;
 		case extend8Enum:
 			startClock(); extendInput(&input1, &output1, 8); break;
+		case transposeEnum:
+			startClock(); matrixTranspose(&input1, &output1); break;
 		case squaredMagnitudeEnum:
 			startClock(); squaredMagnitude(&cinput1, &output1); break;
 			// note: Complex matrix math functions are hard-coded to have no output arg.
@@ -375,10 +688,13 @@ int main(int argc, char **argv) {
 			startClock(); expiLUT(&input1, &lut0, &lut1, &coutput1); break;
 		case hadamardProduct_cbrEnum:
 			startClock(); hadamardProduct_cbr(&cinput1, &input1, &coutput1); break;
+		case affineTransform_cEnum:
+			startClock(); affineTransform_c(&cinput1, &input1, NULL, &coutput1); break;
 		default:
 			ret = -2; goto exit;
 	}
 	printf("Test completed: %.3fms\n", clockToMS(readClock()));
+	if(q16output1.d) { matrixFrom16q(&q16output1, &output1); }
 
 	// Display results if they aren't too many
 	if(cinput1.d) {
@@ -451,7 +767,49 @@ int main(int argc, char **argv) {
 
 	printf("Done testing! Mean Error between results: %3.4f\n", err);
 	printf("\n");
+
+	// Epilogues; Also without the last column if the width is a multiple of 4, for the column tail
+	if(selected_function == multVecByMatExEnum) {
+		float32_t ex_err = multVecByMatExError(&input1, &input2, w2, &lut0, &lut1);
+		float32_t ex_tail_err = (w2 % 4 == 0 && w2 > 1) ? multVecByMatExError(&input1, &input2, w2-1, &lut0, &lut1) : 0;
+		printf("Epilogues (bias, aliased bias, activations): Max. Error %3.6f, %3.6f (tail)\n\n", ex_err, ex_tail_err);
+		if(ex_err < 0 || ex_tail_err < 0 || ex_err > 1e-3 || ex_tail_err > 1e-3) {
+			printf("Fail: multVecByMatEx doesn't match multVecByMat, matrixSum and the activation!\n\n");
+			ret = 11; goto exit;
+		}
+	}
+	// Scales and shifts per bin and broadcast, in place and out of place; Also without the last column like above
+	if(selected_function == affineTransformEnum || selected_function == affineTransform_cEnum) {
+		float32_t af_err, af_tail_err = 0;
+		if(selected_function == affineTransformEnum) {
+			af_err = affineTransformError(&input1, w1);
+			if(w1 % 4 == 0 && w1 > 1) { af_tail_err = affineTransformError(&input1, w1-1); }
+		}
+		else {
+			af_err = affineTransformError_c(&cinput1, w1);
+			if(w1 % 4 == 0 && w1 > 1) { af_tail_err = affineTransformError_c(&cinput1, w1-1); }
+		}
+		printf("Scale/shift modes (per bin, broadcast, NULL shift, in place): Max. Error %3.6f, %3.6f (tail)\n\n", af_err, af_tail_err);
+		if(af_err < 0 || af_tail_err < 0 || af_err > 1e-5 || af_tail_err > 1e-5) {
+			printf("Fail: %s doesn't match hadamardProduct and matrixSum!\n\n", valid_functions_str[selected_function]);
+			ret = 12; goto exit;
+		}
+	}
+	// The same look-ups from LUT_LINEAR tables
+	if(selected_function == angleLutEnum || selected_function == expiLutEnum) {
+		float32_t lin_err = (selected_function == angleLutEnum) ? angleLinearError(&cinput1, &lut0) : expiLinearError(&input1, &lut0, &lut1);
+		printf("Linear LUTs: Max. Error %3.6f\n\n", lin_err);
+		if(lin_err < 0 || lin_err > 1e-4) {
+			printf("Fail: %s doesn't interpolate LUT_LINEAR tables!\n\n", valid_functions_str[selected_function]);
+			ret = 13; goto exit;
+		}
+	}
 exit:
+	deleteMatrix8q(&qinput2);
+	deleteMatrix16q(&q16input1);
+	deleteMatrix16q(&q16input2);
+	deleteMatrix16q(&q16output1);
+	deleteMatrix16f(&hinput2);
 	deleteMatrix(&input1);
 	deleteMatrix(&input2);
 	deleteMatrix(&output1);
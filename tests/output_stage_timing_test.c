@@ -1,7 +1,6 @@
 #include <stdio.h>
 #include <string.h>
 #include <complex.h>
-#include <fftw3.h>
 
 #include "clock.h"
 #include "csv.h"
@@ -44,9 +43,11 @@ int main(int argc, char **argv) {
 	matrix32f_t angles;			// Results of angle(fft_matrix)
 	matrix32c_t fft_in;			// Modified STFT frame that will create audio_output
 	matrix32f_t audio_output;	// Final audio output
+	matrix32c_t fused_fft_in;	// `fft_in` from the fused kernel
+	matrix32c_t fft_work;		// Work buffer of the built-in FFT
 
 	fft_matrix.d = NULL; mask_estimate.d = NULL; audio_output.d = NULL;
-	angles.d = NULL; fft_in.d = NULL;
+	angles.d = NULL; fft_in.d = NULL; fused_fft_in.d = NULL; fft_work.d = NULL;
 
 
 
@@ -82,7 +83,7 @@ int main(int argc, char **argv) {
 		ret = 40; goto exit;
 	}
 
-	if(newMatrix32c(1, bin_count, &fft_in)) {
+	if(newMatrix32c(1, bin_count, &fft_in) || newMatrix32c(1, bin_count, &fused_fft_in)) {
 		printf("Error: failed to create buffer of final FFT.\n");
 		ret = 40; goto exit;
 	}
@@ -106,16 +107,20 @@ int main(int argc, char **argv) {
 	printf("OK\n");
 
 
-	// Initialize FFTW
-	printf("Generating FFTW plan...");
+	// Initialize FFT
+	printf("Generating FFT plan...");
 	startClock();
-#ifdef USE_THREADS
+#if defined(USE_THREADS) && !defined(BUILTIN_FFT)
 	int threads = 1;
 	printf("(using %d threads) ", threads);
 	fftwf_init_threads();
 	fftwf_plan_with_nthreads(threads);
 #endif
-	fftwf_plan const plan = fftwf_plan_dft_c2r_1d(4096, fft_in.d, audio_output.d, FFTW_ESTIMATE);
+	fft_plan_t const plan = stftPlan(4096, STFT_INVERSE, 1, 4096, 4096/2+1, audio_output.d, fft_in.d);
+	if(plan == NULL || newMatrix32c(1, 4096/2, &fft_work)) {
+		printf("Error: failed to create the FFT plan.\n");
+		ret = 40; goto exit;
+	}
 	printf("OK!\t(%.2f ms)\n", clockToMS(readClock()));
 
 	// Perform tests and time them
@@ -134,7 +139,7 @@ int main(int argc, char **argv) {
 
 		// iFFT
 		clock_t fftstart = clock();
-		fftwf_execute(plan);
+		fftInverse(plan, fft_in.d, audio_output.d, fft_work.d);
 		fft_time += clock() - fftstart;
 
 		// Check timer
@@ -147,6 +152,21 @@ int main(int argc, char **argv) {
 	clock_t end_time = clock();
 	float mean_iter_time_us = clockToMS(end_time - start_time) * 1000.0 / (float)iterations;
 
+	// The filter without LUTs; Compared to the LUT version of the last iteration
+	clock_t fused_start = clock();
+	for(size_t iter = 0; iter < iterations; iter++) {
+		applyMagnitudeMask_c(&fft_matrix, &mask_estimate, &fused_fft_in);
+	}
+	clock_t fused_time = clock() - fused_start;
+	angleLUT_c(&fft_matrix, &atan_lut, &angles);
+	expiLUT(&angles, &sin_lut, &cos_lut, &fft_in);
+	hadamardProduct_cbr(&fft_in, &mask_estimate, NULL);
+	float32_t max_fused_diff = 0;
+	for(size_t i = 0; i < bin_count; i++) {
+		float32_t diff = cabsf(fused_fft_in.d[i] - fft_in.d[i]);
+		max_fused_diff = (diff > max_fused_diff) ? diff : max_fused_diff;
+	}
+
 	printf("\n\tResults\n");
 	printf("\t=====================================\n");
 	printf("\t Time for %4d iterations: %4.3f ms\n", iterations, clockToMS(end_time - start_time));
@@ -154,11 +174,13 @@ int main(int argc, char **argv) {
 	printf("\t Best Time:  %4.1f us (%+4.1f us, iter. #%d)\n", clockToMS(best_time)*1000.0,  clockToMS(best_time)*1000.0-mean_iter_time_us, best_time_idx);
 	printf("\t Worst Time: %4.1f us (%+4.1f us, iter. #%d)\n", clockToMS(worst_time)*1000.0, clockToMS(worst_time)*1000.0-mean_iter_time_us, worst_time_idx);
 	printf("\t iFFT Mean Time: %4.1f us\n", clockToMS(fft_time/(float)iterations)*1000.0);
+	printf("\t Fused Filter Mean Time: %4.1f us\n", clockToMS(fused_time/(float)iterations)*1000.0);
+	printf("\t Max Fused/LUT Difference: %2.6f\n", max_fused_diff);
 	printf("\t=====================================\n\n");
 
 exit:
-	if(ret < 10)
-		fftwf_destroy_plan(plan);
+	cleanupFFT();
+	deleteMatrix((matrix32f_t*)&fft_work);
 
 	deleteLUT32f(&atan_lut);
 	deleteLUT32f(&sin_lut);
@@ -168,6 +190,7 @@ exit:
 	deleteMatrix(&mask_estimate);
 	deleteMatrix(&angles);
 	deleteMatrix((matrix32f_t*)&fft_in);
+	deleteMatrix((matrix32f_t*)&fused_fft_in);
 	deleteMatrix(&audio_output);
 
 	return ret;
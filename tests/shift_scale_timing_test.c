@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <string.h>
+#include <math.h> // fabsf
 
 #include "csv.h"
 #include "clock.h"
@@ -14,6 +15,22 @@ static const char* const	matrix_path[] = {
 static const size_t 		matrix_dims[] = {/*input*/ 1, 1487, /*output*/ 1, 2049};
 static const char* const 	input_path[] = { "csv/test1x1487.csv", "csv/test1x2049.csv" };
 
+// Largest difference allowed between `affineTransform` and `hadamardProduct` + `matrixSum`; The affine kernel
+// may fuse the multiply-add, which rounds once instead of twice
+#define AFFINE_TOLERANCE	1e-5
+
+// Largest (relative) difference between the rows of `st` and the two single-row matrices `rows`
+static float32_t stereoDifference(matrix32f_t *st, matrix32f_t *rows) {
+	float32_t max_diff = 0, diff;
+	for(uint8_t r = 0; r < 2; r++) {
+		for(size_t i = 0; i < st->w; i++) {
+			diff = fabsf(st->d[r*st->w + i] - rows[r].d[i]) / (1.0 + fabsf(rows[r].d[i]));
+			max_diff = (diff > max_diff) ? diff : max_diff;
+		}
+	}
+	return max_diff;
+}
+
 int main(int argc, char **argv) {
 	uint8_t ret = 0, test = 0;
 	printf("Aias Karioris, 2025\n");
@@ -26,18 +43,24 @@ int main(int argc, char **argv) {
 #endif
 	printf("\n\n");
 
-	if(argc > 2) {
-		printf("Usage: %s [iterations]\n\n", argv[0]);
+	if(argc > 3) {
+		printf("Usage: %s [iterations] [affine transform (0/1)]\n\n", argv[0]);
 		return 1;
 	}
 
 	// Get number of iterations or default to 16
-	uint32_t iterations = (argc==2) ? atoi(argv[1]) : 16;
+	uint32_t iterations = (argc>=2) ? atoi(argv[1]) : 16;
+	// Optionally scale and shift both channels in one pass (`affineTransform`)
+	uint8_t affine = (argc==3) ? atoi(argv[2]) : 0;
+	if(affine) { printf("Using affineTransform on stereo (2-row) matrices\n"); }
 
 	// Load input and output; Both operations will be stored in place
 	matrix32f_t input1[2], output1[2];
 	input1[0].d = NULL; output1[0].d = NULL;
-	input1[1].d = NULL; output1[2].d = NULL;
+	input1[1].d = NULL; output1[1].d = NULL;
+	// Both channels as the rows of one matrix, for `affineTransform`
+	matrix32f_t input_st, output_st;
+	input_st.d = NULL; output_st.d = NULL;
 
 	// Create weight matrices
 	matrix32f_t w_matrix[8];
@@ -66,6 +89,13 @@ int main(int argc, char **argv) {
 	newMatrix32f(matrix_dims[2], matrix_dims[3], &output1[1]);
 	for(size_t i = 0; i < output1[0].h*output1[0].w; i++) { output1[1].d[i] = output1[0].d[i]; }
 
+	if(newMatrix32f(2, matrix_dims[1], &input_st) || newMatrix32f(2, matrix_dims[3], &output_st)) {
+		printf("Error: failed to create the stereo matrices.\n\n");
+		ret = 4; goto exit;
+	}
+	for(size_t i = 0; i < matrix_dims[1]; i++) { input_st.d[i] = input1[0].d[i]; input_st.d[matrix_dims[1] + i] = input1[1].d[i]; }
+	for(size_t i = 0; i < matrix_dims[3]; i++) { output_st.d[i] = output1[0].d[i]; output_st.d[matrix_dims[3] + i] = output1[1].d[i]; }
+
 	// Load all input weights
 	for(int channel = 0; channel < 4; channel++) {
 		// Load input scale
@@ -100,17 +130,32 @@ int main(int argc, char **argv) {
 
 		// Start
 		startClock();
-		hadamardProduct(&input1[0], scale_w, NULL);
-		hadamardProduct(&input1[1], scale_w, NULL);
-		matrixSum(&input1[0], mean_w, NULL);
-		matrixSum(&input1[1], mean_w, NULL);
+		if(affine) { affineTransform(&input_st, scale_w, mean_w, NULL); }
+		else {
+			hadamardProduct(&input1[0], scale_w, NULL);
+			hadamardProduct(&input1[1], scale_w, NULL);
+			matrixSum(&input1[0], mean_w, NULL);
+			matrixSum(&input1[1], mean_w, NULL);
+		}
 
 		// Check timer
 		float last_time = readClock();
 		best_time  = (last_time < best_time)  ? last_time : best_time;
 		worst_time = (last_time > worst_time) ? last_time : worst_time;
 
-		// Check values?
+		// Check values; The mono copies still hold the original rows, so the separate passes give the reference
+		if(affine && iter == 0) {
+			hadamardProduct(&input1[0], scale_w, NULL);
+			hadamardProduct(&input1[1], scale_w, NULL);
+			matrixSum(&input1[0], mean_w, NULL);
+			matrixSum(&input1[1], mean_w, NULL);
+			float32_t diff = stereoDifference(&input_st, input1);
+			printf("Input affineTransform vs. hadamardProduct + matrixSum: Max. Difference %.3e\n", diff);
+			if(diff > AFFINE_TOLERANCE) {
+				printf("Error: affineTransform doesn't match hadamardProduct + matrixSum (tolerance %.1e).\n\n", AFFINE_TOLERANCE);
+				ret = 5; goto exit;
+			}
+		}
 	}
 	clock_t end_time = clock();
 	float mean_iter_time_us = clockToMS(end_time - start_time) * 1000.0 / (float)iterations;
@@ -159,17 +204,32 @@ int main(int argc, char **argv) {
 
 		// Start
 		startClock();
-		hadamardProduct(&output1[0], scale_w, NULL);
-		hadamardProduct(&output1[1], scale_w, NULL);
-		matrixSum(&output1[0], mean_w, NULL);
-		matrixSum(&output1[1], mean_w, NULL);
+		if(affine) { affineTransform(&output_st, scale_w, mean_w, NULL); }
+		else {
+			hadamardProduct(&output1[0], scale_w, NULL);
+			hadamardProduct(&output1[1], scale_w, NULL);
+			matrixSum(&output1[0], mean_w, NULL);
+			matrixSum(&output1[1], mean_w, NULL);
+		}
 
 		// Check timer
 		float last_time = readClock();
 		best_time  = (last_time < best_time)  ? last_time : best_time;
 		worst_time = (last_time > worst_time) ? last_time : worst_time;
 
-		// Check values?
+		// Check values; The mono copies still hold the original rows, so the separate passes give the reference
+		if(affine && iter == 0) {
+			hadamardProduct(&output1[0], scale_w, NULL);
+			hadamardProduct(&output1[1], scale_w, NULL);
+			matrixSum(&output1[0], mean_w, NULL);
+			matrixSum(&output1[1], mean_w, NULL);
+			float32_t diff = stereoDifference(&output_st, output1);
+			printf("Output affineTransform vs. hadamardProduct + matrixSum: Max. Difference %.3e\n", diff);
+			if(diff > AFFINE_TOLERANCE) {
+				printf("Error: affineTransform doesn't match hadamardProduct + matrixSum (tolerance %.1e).\n\n", AFFINE_TOLERANCE);
+				ret = 5; goto exit;
+			}
+		}
 	}
 	end_time = clock();
 	mean_iter_time_us = clockToMS(end_time - start_time) * 1000.0 / (float)iterations;
@@ -189,5 +249,7 @@ exit:
 		deleteMatrix(&input1[m]);
 		deleteMatrix(&output1[m]);
 	}
+	deleteMatrix(&input_st);
+	deleteMatrix(&output_st);
 	return ret;
 }
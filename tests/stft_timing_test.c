@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "clock.h"
+#include "stft.h"
+
+#define FFT_SIZE	4096
+#define HOP_SIZE	1024
+// Audio is pushed in blocks of varying length, like the periods of an audio driver
+#define MAX_BLOCK	1500
+
+int main(int argc, char **argv) {
+	uint8_t ret = 0;
+	printf("Aias Karioris, 2025\n");
+	printf("Streaming STFT/iSTFT Test");
+#ifndef SERIAL
+	printf(" (NEON)");
+#endif
+#ifdef DEBUG
+	printf(" [Debug Build]");
+#endif
+	printf("\n\n");
+
+	if(argc > 4) {
+		printf("Usage: %s [hops] [batch size] [wisdom file]\n\n", argv[0]);
+		return 1;
+	}
+
+	// Get number of hops or default to 64, and the number of frames per batch for offline processing
+	uint32_t hops  = (argc>=2) ? atoi(argv[1]) : 64;
+	uint32_t batch = (argc>=3) ? atoi(argv[2]) : 16;
+	// With a wisdom file, plans are measured on the first run and loaded from the file on the next ones
+	const char *wisdom_path = (argc==4) ? argv[3] : NULL;
+	size_t len = (size_t)hops * HOP_SIZE;
+
+	stft_t stft;
+	float32_t *audio_input  = (float32_t*)malloc(len * sizeof(float32_t));
+	float32_t *audio_output = (float32_t*)malloc(len * sizeof(float32_t));
+	if(audio_input == NULL || audio_output == NULL) {
+		printf("Error: failed to allocate the audio buffers.\n");
+		free(audio_input); free(audio_output);
+		return 40;
+	}
+
+	// Test signal; Two tones and a pseudo-random component
+	srand(1);
+	for(size_t i = 0; i < len; i++) {
+		audio_input[i] = 0.5*sinf(i*0.031f) + 0.25*sinf(i*0.2f) + 0.1*((float32_t)rand()/RAND_MAX - 0.5);
+	}
+
+	if(wisdom_path != NULL) {
+		printf("Wisdom (%s): %s\n", wisdom_path, initFFT(wisdom_path, FFTW_MEASURE) ? "none, measuring plans" : "imported");
+	}
+	printf("Creating STFT engine (%d/%d)...", FFT_SIZE, HOP_SIZE);
+	startClock();
+	if(stftCreate(FFT_SIZE, HOP_SIZE, &stft) || stftEnableBatch(&stft, batch)) {
+		printf("\nError: failed to create the STFT engine.\n");
+		ret = 41; goto exit;
+	}
+	printf("OK!\t(%.2f ms)\n", clockToMS(readClock()));
+
+	// Analysis and synthesis of every hop
+	clock_t fft_time = 0, ifft_time = 0, temp_time;
+	size_t frames = 0;
+	uint8_t frame_ready;
+	clock_t start_time = clock();
+	for(size_t i = 0; i < len; ) {
+		size_t block_end = i + 1 + rand() % MAX_BLOCK;
+		if(block_end > len) { block_end = len; }
+
+		while(i < block_end) {
+			temp_time = clock();
+			i += stftPush(&stft, &audio_input[i], block_end - i, &frame_ready);
+			fft_time += clock() - temp_time;
+
+			if(frame_ready) {
+				temp_time = clock();
+				stftInverse(&stft, &stft.spectrum, &audio_output[frames*HOP_SIZE]);
+				ifft_time += clock() - temp_time;
+				frames++;
+			}
+		}
+	}
+	clock_t end_time = clock();
+
+	// The output is the input, delayed by FFT_SIZE - HOP_SIZE samples
+	size_t delay = FFT_SIZE - HOP_SIZE;
+	float32_t max_error = 0;
+	for(size_t i = delay; i < frames*HOP_SIZE; i++) {
+		float32_t error = fabsf(audio_output[i] - audio_input[i - delay]);
+		max_error = (error > max_error) ? error : max_error;
+	}
+
+	// Offline; The same hops in batches, starting from a clean state. The frames of the streaming engine
+	// start fft_size - hop_size samples before the input, so the input is read from an offset of
+	// fft_size - hop_size zeros.
+	float32_t *padded_input  = (float32_t*)calloc(len + FFT_SIZE, sizeof(float32_t));
+	float32_t *batch_output  = (float32_t*)malloc(len * sizeof(float32_t));
+	if(padded_input == NULL || batch_output == NULL) {
+		printf("Error: failed to allocate the audio buffers.\n");
+		free(padded_input); free(batch_output);
+		ret = 40; goto exit;
+	}
+	memcpy(&padded_input[delay], audio_input, len*sizeof(float32_t));
+	stftReset(&stft);
+
+	clock_t batch_fft_time = 0, batch_ifft_time = 0;
+	for(size_t t = 0; t < frames; t += batch) {
+		size_t n = (frames - t < batch) ? frames - t : batch;
+		temp_time = clock();
+		stftForwardBatch(&stft, &padded_input[t*HOP_SIZE], n);
+		batch_fft_time += clock() - temp_time;
+
+		temp_time = clock();
+		stftInverseBatch(&stft, &stft.batch_spectra, n, &batch_output[t*HOP_SIZE]);
+		batch_ifft_time += clock() - temp_time;
+	}
+	float32_t max_batch_diff = 0;
+	for(size_t i = 0; i < frames*HOP_SIZE; i++) {
+		float32_t diff = fabsf(batch_output[i] - audio_output[i]);
+		max_batch_diff = (diff > max_batch_diff) ? diff : max_batch_diff;
+	}
+	free(padded_input);
+	free(batch_output);
+
+	printf("\n\tResults\n");
+	printf("\t=====================================\n");
+	printf("\t Time for %4lu frames: %4.3f ms\n", (unsigned long)frames, clockToMS(end_time - start_time));
+	printf("\t STFT Mean Time/frame:  %4.1f us\n", clockToMS(fft_time/(float)frames)*1000.0);
+	printf("\t iSTFT Mean Time/frame: %4.1f us\n", clockToMS(ifft_time/(float)frames)*1000.0);
+	printf("\t Max Reconstruction Error: %2.8f\n", max_error);
+	printf("\t Batch STFT Mean Time/frame:  %4.1f us (%d frames/batch)\n", clockToMS(batch_fft_time/(float)frames)*1000.0, batch);
+	printf("\t Batch iSTFT Mean Time/frame: %4.1f us\n", clockToMS(batch_ifft_time/(float)frames)*1000.0);
+	printf("\t Max Batch/Streaming Difference: %2.8f\n", max_batch_diff);
+	printf("\t=====================================\n\n");
+
+	if(wisdom_path != NULL && saveFFTWisdom(wisdom_path)) {
+		printf("Error: Could not save the wisdom to %s.\n", wisdom_path);
+	}
+
+exit:
+	stftDelete(&stft);
+	cleanupFFT();
+	free(audio_input);
+	free(audio_output);
+	return ret;
+}
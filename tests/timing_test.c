@@ -38,7 +38,16 @@ int main(int argc, char **argv) {
 	matrix32f_t input1, input2, output1;
 	matrix32c_t cinput1, cinput2, coutput1;
 	input1.d = NULL; input2.d = NULL; output1.d = NULL;
+	matrix8q_t qinput2;
+	qinput2.d = NULL; qinput2.scale = NULL;
+	matrix16q_t q16input1, q16input2, q16output1;
+	q16input1.d = NULL; q16input2.d = NULL; q16output1.d = NULL;
+	matrix16f_t hinput2;
+	hinput2.d = NULL;
 	cinput1.d = NULL; cinput2.d = NULL; coutput1.d = NULL;
+	matrix32f_t shift;
+	matrix32c_t cshift;
+	shift.d = NULL; cshift.d = NULL;
 
 	// LUTs
 	lut32f_t lut0, lut1;
@@ -61,7 +70,7 @@ int main(int argc, char **argv) {
 	// Get dimensions from file names
 	size_t w1, h1, w2=0, h2=0, wo, ho;
 	h1 = atoi(argv[2]);	w1 = atoi(argv[3]);
-	if(selected_function <= hadamardProductEnum || selected_function == hadamardProduct_complexEnum || selected_function == hadamardProduct_cbrEnum) { // Some functions require 2 inputs
+	if(selected_function <= hadamardProductEnum || selected_function == hadamardProduct_complexEnum || selected_function == hadamardProduct_cbrEnum || selected_function == affineTransform_cEnum) { // Some functions require 2 inputs
 		h2 = atoi(argv[5]); w2 = atoi(argv[6]);
 	}
 
@@ -75,6 +84,16 @@ int main(int argc, char **argv) {
 			ho = 1; wo = w2; break;
 		case multMatByVecEnum:
 			ho = h1; wo = 1; break;
+		case matrixMultiplyEnum:
+			ho = h1; wo = w2; break;
+		case multVecByMat_q8Enum:
+		case multVecByMat_q16Enum:
+		case multVecByMat_f16wEnum:
+		case multVecByMatExEnum:
+			ho = 1; wo = w2; break;
+		case affineTransformEnum:
+			// input2 is the scale (per bin or a single value); The shift gets the same shape
+			wo = w1; ho = h1; break;
 		case hadamardProductEnum:
 			wo = w1; ho = h1; break;
 		case elementwisePow2Enum:
@@ -99,6 +118,15 @@ int main(int argc, char **argv) {
 				ret = 10; goto exit;
 			}
 			wo = w1; ho = h1; break;
+		case tanhLutLinearEnum:
+		case sigmoidLutLinearEnum:
+			// Same functions from a compact linear table, converted from the nearest-entry one
+			if(load32fLUT(&lut1, (selected_function == tanhLutLinearEnum) ? "lut/tanh65537.lut" : "lut/sigmoid65537.lut") || lutToLinear(&lut1, 1e-5, &lut0)) {
+				printf("Error: Could not load/convert Tanh/Sigmoid LUT.\n\n");
+				ret = 10; goto exit;
+			}
+			printf("Linear LUT: %u entries (from %u)\n", lut0.length, lut1.length);
+			wo = w1; ho = h1; break;
 		case flipEnum:
 			wo = w1; ho = h1; break;
 		case extend2Enum:
@@ -107,6 +135,8 @@ int main(int argc, char **argv) {
 			wo = w1*4; ho = h1; break;
 		case extend8Enum:
 			wo = w1*8; ho = h1; break;
+		case transposeEnum:
+			wo = h1; ho = w1; break;
 		case squaredMagnitudeEnum:
 			wo = w1; ho = h1; break;
 		case hadamardProduct_complexEnum:
@@ -129,6 +159,9 @@ int main(int argc, char **argv) {
 			wo = w1; ho = h1; break;
 		case hadamardProduct_cbrEnum:
 			wo = w1; ho = h1; break;
+		case affineTransform_cEnum:
+			// The real input is the scale (per bin or a single value); The complex shift gets the same shape
+			wo = w1; ho = h1; break;
 		default:
 			ret = -2; goto exit;
 	}
@@ -161,7 +194,7 @@ int main(int argc, char **argv) {
 		}
 	}
 	// Expect 1 (real) input
-	else if(selected_function <= extend8Enum){
+	else if(selected_function <= transposeEnum){
 		printf("Loading %s...", argv[4]);
 		if(test = matrixFromCSV(argv[4], h1, w1, &input1)) {
 			printf("\nError (%d): failed to import %s!\n\n", test, argv[4]);
@@ -233,7 +266,7 @@ int main(int argc, char **argv) {
 		coutput1.w /= 2;
 	}
 	// Expect one real and one complex input, config. complex output
-	else if(selected_function == hadamardProduct_cbrEnum) {
+	else if(selected_function == hadamardProduct_cbrEnum || selected_function == affineTransform_cEnum) {
 		// Complex input (first)
 		printf("Loading %s...", argv[4]);
 		if(test = matrixFromCSV(argv[4], h1, w1*2, (matrix32f_t*)&cinput1)) {
@@ -245,7 +278,7 @@ int main(int argc, char **argv) {
 
 		// Real input (second)
 		printf("Loading %s...", argv[7]);
-		if(test = matrixFromCSV(argv[7], h1, w1, &input1)) {
+		if(test = matrixFromCSV(argv[7], h2, w2, &input1)) {
 			printf("\nError (%d): failed to import %s!\n\n", test, argv[4]);
 			ret = 3; goto exit;
 		}
@@ -260,6 +293,46 @@ int main(int argc, char **argv) {
 		coutput1.w /= 2;
 	}
 
+	// The quantized multiplication takes a quantized second input
+	if(selected_function == multVecByMat_q8Enum && quantizeMatrix8q(&input2, &qinput2)) {
+		printf("Error: failed to quantize %s.\n\n", argv[7]);
+		ret = 3; goto exit;
+	}
+	// The fixed point multiplication takes both inputs in fixed point; The output gets the accumulator's format
+	if(selected_function == multVecByMat_q16Enum) {
+		uint8_t int_bits1 = matrixIntBits16q(&input1), int_bits2 = matrixIntBits16q(&input2);
+		if(newMatrix16q(input1.h, input1.w, int_bits1, &q16input1) || newMatrix16q(input2.h, input2.w, int_bits2, &q16input2) ||
+		   newMatrix16q(ho, wo, (int_bits1 + int_bits2 > 15) ? 15 : int_bits1 + int_bits2, &q16output1)) {
+			printf("Error: failed to create the fixed point matrices.\n\n");
+			ret = 3; goto exit;
+		}
+		matrixTo16q(&input1, &q16input1);
+		matrixTo16q(&input2, &q16input2);
+	}
+	// The affine transforms take a shift of the scale's shape; Its values don't affect the timing
+	if(selected_function == affineTransformEnum) {
+		if(newMatrix32f(input2.h, input2.w, &shift)) {
+			printf("Error: failed to create the shift.\n\n");
+			ret = 3; goto exit;
+		}
+		memcpy(shift.d, input2.d, input2.h*input2.w*sizeof(float32_t));
+	}
+	if(selected_function == affineTransform_cEnum) {
+		if(newMatrix32c(input1.h, input1.w, &cshift)) {
+			printf("Error: failed to create the shift.\n\n");
+			ret = 3; goto exit;
+		}
+		for(size_t i = 0; i < input1.h*input1.w; i++) { cshift.d[i] = input1.d[i]; }
+	}
+	// The half precision multiplication takes half precision weights
+	if(selected_function == multVecByMat_f16wEnum) {
+		if(newMatrix16f(input2.h, input2.w, &hinput2)) {
+			printf("Error: failed to create the half precision matrix.\n\n");
+			ret = 3; goto exit;
+		}
+		matrixTo16f(&input2, &hinput2);
+	}
+
 	clock_t best_time  = (clock_t)9e18;
 	clock_t worst_time = 0;
 	uint32_t best_time_idx = -1, worst_time_idx = -1;
@@ -277,6 +350,18 @@ int main(int argc, char **argv) {
 				startClock(); multVecByMat(&input1, &input2, &output1);	break;
 			case multMatByVecEnum:
 				startClock(); multMatByVec(&input1, &input2, &output1); break;
+			case matrixMultiplyEnum:
+				startClock(); matrixMultiply(&input1, &input2, &output1); break;
+			case multVecByMat_q8Enum:
+				startClock(); multVecByMat_q8(&input1, &qinput2, &output1); break;
+			case multVecByMat_q16Enum:
+				startClock(); multVecByMat_q16(&q16input1, &q16input2, &q16output1); break;
+			case multVecByMat_f16wEnum:
+				startClock(); multVecByMat_f16w(&input1, &hinput2, &output1); break;
+			case multVecByMatExEnum:
+				startClock(); multVecByMatEx(&input1, &input2, NULL, ACTIVATION_NONE, NULL, &output1); break;
+			case affineTransformEnum:
+				startClock(); affineTransform(&input1, &input2, &shift, &output1); break;
 			case hadamardProductEnum:
 				startClock(); hadamardProduct(&input1, &input2, &output1); break;
 			case elementwisePow2Enum:
@@ -289,6 +374,9 @@ int main(int argc, char **argv) {
 				startClock(); clampingLUT(&input1, &lut0, &output1); break;
 			case sigmoidLutEnum:
 				startClock(); clampingLUT(&input1, &lut0, &output1); break;
+			case tanhLutLinearEnum:
+			case sigmoidLutLinearEnum:
+				startClock(); clampingLUT(&input1, &lut0, &output1); break;
 			case flipEnum:
 				startClock(); flipVector(&input1, &output1); break;
 			case extend2Enum:
@@ -297,6 +385,8 @@ int main(int argc, char **argv) {
 				startClock(); extendInput(&input1, &output1, 4); break;
 			case extend8Enum:
 				startClock(); extendInput(&input1, &output1, 8); break;
+			case transposeEnum:
+				startClock(); matrixTranspose(&input1, &output1); break;
 			// note: Complex matrix math functions are hard-coded to have no output arg.
 			case squaredMagnitudeEnum:
 				startClock(); squaredMagnitude(&cinput1, &output1); break;
@@ -308,6 +398,8 @@ int main(int argc, char **argv) {
 				startClock(); expiLUT(&input1, &lut0, &lut1, &coutput1); break;
 			case hadamardProduct_cbrEnum:
 				startClock(); hadamardProduct_cbr(&cinput1, &input1, &coutput1); break;
+			case affineTransform_cEnum:
+				startClock(); affineTransform_c(&cinput1, &input1, &cshift, &coutput1); break;
 			default:
 				ret = -2; goto exit;
 		}
@@ -332,6 +424,11 @@ int main(int argc, char **argv) {
 	printf("\t===================================================\n\n");
 
 exit:
+	deleteMatrix8q(&qinput2);
+	deleteMatrix16q(&q16input1);
+	deleteMatrix16q(&q16input2);
+	deleteMatrix16q(&q16output1);
+	deleteMatrix16f(&hinput2);
 	deleteLUT32f(&lut0);
 	deleteLUT32f(&lut1);
 	deleteMatrix(&input1);
@@ -340,5 +437,7 @@ exit:
 	deleteMatrix((matrix32f_t*)&cinput1);
 	deleteMatrix((matrix32f_t*)&cinput2);
 	deleteMatrix((matrix32f_t*)&coutput1);
+	deleteMatrix(&shift);
+	deleteMatrix((matrix32f_t*)&cshift);
 	return ret;
 }
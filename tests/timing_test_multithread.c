@@ -28,6 +28,9 @@ size_t w1, h1, w2=0, h2=0, wo, ho;
 // Matrices to store input and output data; Threads will copy the values found here
 matrix32f_t input1, input2;
 matrix32c_t cinput1, cinput2;
+// Shift of the affine transforms; Same shape as the scale
+matrix32f_t shift;
+matrix32c_t cshift;
 function_t selected_function = 0;
 
 // LUT Pointers
@@ -54,6 +57,7 @@ int main(int argc, char **argv) {
 
 	input1.d = NULL; input2.d = NULL;
 	cinput1.d = NULL; cinput2.d = NULL;
+	shift.d = NULL; cshift.d = NULL;
 
 	// Set up test iterations count; This might be reduced depending on the tested function
 	test_iterations = TEST_ITERATIONS_DEF;
@@ -80,7 +84,7 @@ int main(int argc, char **argv) {
 
 	// Get dimensions for file names
 	h1 = atoi(argv[2]);	w1 = atoi(argv[3]);
-	if(selected_function <= hadamardProductEnum || selected_function == hadamardProduct_complexEnum || selected_function == hadamardProduct_cbrEnum) { // Some functions require 2 inputs
+	if(selected_function <= hadamardProductEnum || selected_function == hadamardProduct_complexEnum || selected_function == hadamardProduct_cbrEnum || selected_function == affineTransform_cEnum) { // Some functions require 2 inputs
 		h2 = atoi(argv[5]); w2 = atoi(argv[6]);
 	}
 
@@ -98,6 +102,19 @@ int main(int argc, char **argv) {
 		case multMatByVecEnum:
 			test_iterations /= 128;
 			ho = h1; wo = 1; break;
+		case multVecByMat_q8Enum:
+		case multVecByMat_q16Enum:
+		case multVecByMat_f16wEnum:
+		case multVecByMatExEnum:
+			test_iterations /= 128;
+			ho = 1; wo = w2; break;
+		case matrixMultiplyEnum:
+			test_iterations /= 1024;
+			ho = h1; wo = w2; break;
+		case affineTransformEnum:
+			// input2 is the scale (per bin or a single value)
+			test_iterations *= 4;
+			wo = w1; ho = h1; break;
 		case hadamardProductEnum:
 			test_iterations *= 4;
 			wo = w1; ho = h1; break;
@@ -125,6 +142,15 @@ int main(int argc, char **argv) {
 				ret = 10; goto exit;
 			}
 			wo = w1; ho = h1; break;
+		case tanhLutLinearEnum:
+		case sigmoidLutLinearEnum:
+			// Same functions from a compact linear table, converted from the nearest-entry one
+			if(load32fLUT(&lut1, (selected_function == tanhLutLinearEnum) ? "lut/tanh.lut" : "lut/sigmoid.lut") || lutToLinear(&lut1, 1e-5, &lut0)) {
+				printf("Error: Could not load/convert Tanh/Sigmoid LUT.\n\n");
+				ret = 10; goto exit;
+			}
+			printf("Linear LUT: %u entries (from %u)\n", lut0.length, lut1.length);
+			wo = w1; ho = h1; break;
 		case flipEnum:
 			test_iterations *= 4;
 			wo = w1; ho = h1; break;
@@ -134,6 +160,8 @@ int main(int argc, char **argv) {
 			wo = w1*4; ho = h1; break;
 		case extend8Enum:
 			wo = w1*8; ho = h1; break;
+		case transposeEnum:
+			wo = h1; ho = w1; break;
 		case squaredMagnitudeEnum:
 			wo = w1; ho = h1; break;
 		case hadamardProduct_complexEnum:
@@ -157,6 +185,9 @@ int main(int argc, char **argv) {
 		case hadamardProduct_cbrEnum:
 			test_iterations /= 2048;
 			wo = w1; ho = h1; break;
+		case affineTransform_cEnum:
+			// The real input is the scale (per bin or a single value)
+			wo = w1; ho = h1; break;
 		default:
 			ret = -2; goto exit;
 	}
@@ -181,7 +212,7 @@ int main(int argc, char **argv) {
 		printf("OK!\n");
 	}
 	// Expect 1 (real) input
-	else if(selected_function <= extend8Enum){
+	else if(selected_function <= transposeEnum){
 		printf("Loading %s...", argv[4]);
 		if(test = matrixFromCSV(argv[4], h1, w1, &input1)) {
 			printf("\nError (%d): failed to import %s!\n\n", test, argv[4]);
@@ -236,7 +267,7 @@ int main(int argc, char **argv) {
 		printf("OK!\n");
 	}
 	// Expect one real and one complex input, config. complex output
-	else if(selected_function == hadamardProduct_cbrEnum) {
+	else if(selected_function == hadamardProduct_cbrEnum || selected_function == affineTransform_cEnum) {
 		// Complex input (first)
 		printf("Loading %s...", argv[4]);
 		if(test = matrixFromCSV(argv[4], h1, w1*2, (matrix32f_t*)&cinput1)) {
@@ -248,13 +279,23 @@ int main(int argc, char **argv) {
 
 		// Real input (second)
 		printf("Loading %s...", argv[7]);
-		if(test = matrixFromCSV(argv[7], h1, w1, &input1)) {
+		if(test = matrixFromCSV(argv[7], h2, w2, &input1)) {
 			printf("\nError (%d): failed to import %s!\n\n", test, argv[4]);
 			ret = 3; goto exit;
 		}
 		printf("OK!\n");
 	}
 
+	// The affine transforms take a shift of the scale's shape; Threads clone it like the inputs
+	if(selected_function == affineTransformEnum && newMatrix32f(input2.h, input2.w, &shift)) {
+		printf("Error: failed to create the shift.\n\n");
+		ret = 3; goto exit;
+	}
+	if(selected_function == affineTransform_cEnum && newMatrix32c(input1.h, input1.w, &cshift)) {
+		printf("Error: failed to create the shift.\n\n");
+		ret = 3; goto exit;
+	}
+
 	// Barrier passed when all threads are done initializing
 	pthread_barrier_init(&init_barrier, NULL, THREADS+1);
 
@@ -304,6 +345,8 @@ exit:
 	deleteMatrix(&input2);
 	deleteMatrix((matrix32f_t*)&cinput1);
 	deleteMatrix((matrix32f_t*)&cinput2);
+	deleteMatrix(&shift);
+	deleteMatrix((matrix32f_t*)&cshift);
 	return ret;
 }
 
@@ -312,8 +355,18 @@ void* threadFunction(void* times_arg) {
 	// Thread-level matrices
 	matrix32f_t th_input1, th_input2, th_output1;
 	matrix32c_t th_cinput1, th_cinput2, th_coutput1;
+	matrix32f_t th_shift;
+	matrix32c_t th_cshift;
 	th_input1.d = NULL; th_input2.d = NULL; th_output1.d = NULL;
 	th_cinput1.d = NULL; th_cinput2.d = NULL; th_coutput1.d = NULL;
+	th_shift.d = NULL; th_cshift.d = NULL;
+	// Operands of the quantized, fixed point and half precision multiplications
+	matrix8q_t th_qinput2;
+	matrix16q_t th_q16input1, th_q16input2, th_q16output1;
+	matrix16f_t th_hinput2;
+	th_qinput2.d = NULL; th_qinput2.scale = NULL;
+	th_q16input1.d = NULL; th_q16input2.d = NULL; th_q16output1.d = NULL;
+	th_hinput2.d = NULL;
 
 	// Clone inputs; Only inputs that have non-NULL data are cloned
 	int test = 0;
@@ -321,6 +374,8 @@ void* threadFunction(void* times_arg) {
 	if(input2.d)	{ test |= cloneMatrix(&input2, &th_input2); }
 	if(cinput1.d)	{ test |= cloneMatrix_c(&cinput1, &th_cinput1); }
 	if(cinput2.d)	{ test |= cloneMatrix_c(&cinput2, &th_cinput2); }
+	if(shift.d)		{ test |= cloneMatrix(&shift, &th_shift); }
+	if(cshift.d)	{ test |= cloneMatrix_c(&cshift, &th_cshift); }
 	if(test) {
 		// go to barrier now:(
 		pthread_barrier_wait(&init_barrier);
@@ -336,7 +391,7 @@ void* threadFunction(void* times_arg) {
 		}
 	}
 	// Expect 1 (real) input
-	else if(selected_function <= extend8Enum){
+	else if(selected_function <= transposeEnum){
 		// Create matrix for our output
 		if(newMatrix32f(ho, wo, &th_output1)) {
 			goto exit;
@@ -369,7 +424,7 @@ void* threadFunction(void* times_arg) {
 		th_coutput1.w /= 2;
 	}
 	// Expect one real and one complex input, config. complex output
-	else if(selected_function == hadamardProduct_cbrEnum) {
+	else if(selected_function == hadamardProduct_cbrEnum || selected_function == affineTransform_cEnum) {
 		// Create complex matrix for our output
 		if(newMatrix32f(ho, wo*2, (matrix32f_t*)&th_coutput1)) {
 			goto exit;
@@ -377,6 +432,27 @@ void* threadFunction(void* times_arg) {
 		th_coutput1.w /= 2;
 	}
 
+	// Converted from the shared inputs, since the clones aren't filled
+	if(selected_function == multVecByMat_q8Enum && quantizeMatrix8q(&input2, &th_qinput2)) {
+		goto exit;
+	}
+	// The output gets the accumulator's format
+	if(selected_function == multVecByMat_q16Enum) {
+		uint8_t int_bits1 = matrixIntBits16q(&input1), int_bits2 = matrixIntBits16q(&input2);
+		if(newMatrix16q(input1.h, input1.w, int_bits1, &th_q16input1) || newMatrix16q(input2.h, input2.w, int_bits2, &th_q16input2) ||
+		   newMatrix16q(ho, wo, (int_bits1 + int_bits2 > 15) ? 15 : int_bits1 + int_bits2, &th_q16output1)) {
+			goto exit;
+		}
+		matrixTo16q(&input1, &th_q16input1);
+		matrixTo16q(&input2, &th_q16input2);
+	}
+	if(selected_function == multVecByMat_f16wEnum) {
+		if(newMatrix16f(input2.h, input2.w, &th_hinput2)) {
+			goto exit;
+		}
+		matrixTo16f(&input2, &th_hinput2);
+	}
+
 	// Ready to start
 	struct timespec loop_start, loop_end;
 	pthread_barrier_wait(&init_barrier);
@@ -393,6 +469,18 @@ void* threadFunction(void* times_arg) {
 				multVecByMat(&th_input1, &th_input2, &th_output1);	break;
 			case multMatByVecEnum:
 				multMatByVec(&th_input1, &th_input2, &th_output1); break;
+			case matrixMultiplyEnum:
+				matrixMultiply(&th_input1, &th_input2, &th_output1); break;
+			case multVecByMat_q8Enum:
+				multVecByMat_q8(&th_input1, &th_qinput2, &th_output1); break;
+			case multVecByMat_q16Enum:
+				multVecByMat_q16(&th_q16input1, &th_q16input2, &th_q16output1); break;
+			case multVecByMat_f16wEnum:
+				multVecByMat_f16w(&th_input1, &th_hinput2, &th_output1); break;
+			case multVecByMatExEnum:
+				multVecByMatEx(&th_input1, &th_input2, NULL, ACTIVATION_NONE, NULL, &th_output1); break;
+			case affineTransformEnum:
+				affineTransform(&th_input1, &th_input2, &th_shift, &th_output1); break;
 			case hadamardProductEnum:
 				hadamardProduct(&th_input1, &th_input2, &th_output1); break;
 			case elementwisePow2Enum:
@@ -405,6 +493,9 @@ void* threadFunction(void* times_arg) {
 				clampingLUT(&th_input1, lut0_ptr, &th_output1); break;
 			case sigmoidLutEnum:
 				clampingLUT(&th_input1, lut0_ptr, &th_output1); break;
+			case tanhLutLinearEnum:
+			case sigmoidLutLinearEnum:
+				clampingLUT(&th_input1, lut0_ptr, &th_output1); break;
 			case flipEnum:
 				flipVector(&th_input1, &th_output1); break;
 			case extend2Enum:
@@ -413,6 +504,8 @@ void* threadFunction(void* times_arg) {
 				extendInput(&th_input1, &th_output1, 4); break;
 			case extend8Enum:
 				extendInput(&th_input1, &th_output1, 8); break;
+			case transposeEnum:
+				matrixTranspose(&th_input1, &th_output1); break;
 			case squaredMagnitudeEnum:
 				squaredMagnitude(&th_cinput1, &th_output1); break;
 			// note: The following complex matrix math functions are hard-coded to have no output arg.
@@ -424,6 +517,8 @@ void* threadFunction(void* times_arg) {
 				expiLUT(&th_input1, lut0_ptr, lut1_ptr, &th_coutput1); break;
 			case hadamardProduct_cbrEnum:
 				hadamardProduct_cbr(&th_cinput1, &th_input1, &th_coutput1); break;
+			case affineTransform_cEnum:
+				affineTransform_c(&th_cinput1, &th_input1, &th_cshift, &th_coutput1); break;
 			default:
 				goto exit;
 		}
@@ -440,6 +535,10 @@ exit:
 	deleteMatrix(&th_output1);
 	deleteMatrix((matrix32f_t*)&th_cinput1); deleteMatrix((matrix32f_t*)&th_cinput2);
 	deleteMatrix((matrix32f_t*)&th_coutput1);
+	deleteMatrix(&th_shift); deleteMatrix((matrix32f_t*)&th_cshift);
+	deleteMatrix8q(&th_qinput2);
+	deleteMatrix16q(&th_q16input1); deleteMatrix16q(&th_q16input2); deleteMatrix16q(&th_q16output1);
+	deleteMatrix16f(&th_hinput2);
 }
 
 int cloneMatrix(matrix32f_t *src, matrix32f_t *dst) {
@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "bundle.h"
+#include "csv.h"
+#include "lut.h"
+
+// Converts CSV matrices and LUT files to a bundle, or lists the contents of a bundle.
+//   bundle_tool [output] [name=matrix.csv:HxW | name=table.lut]...
+//   bundle_tool -l [bundle]
+// e.g. `bundle_tool model.bundle lstm_drums_wf=parameters/csv/lstm_drums_wl0/lstm_drums_wf.csv:512x256 tanh=lut/tanh.lut`
+
+static int listBundle(const char *path) {
+	bundle_t bundle;
+	int test;
+	if(test = bundleOpen(path, 1, &bundle)) {
+		printf("Error (%d): could not open %s.\n", test, path);
+		return 2;
+	}
+
+	printf("%s: version %u, %u entries, %lu bytes\n", path, bundle.header->version, bundle.header->entry_count, (unsigned long)bundle.size);
+	for(uint32_t i = 0; i < bundle.header->entry_count; i++) {
+		bundle_entry_t *entry = &bundle.entries[i];
+		if(entry->type == BUNDLE_MATRIX) { printf("\t%-32.32s matrix %ux%u\n", entry->name, entry->h, entry->w); }
+		else { printf("\t%-32.32s LUT    %u entries (x%f%+f)%s\n", entry->name, entry->w, entry->mult_factor, entry->bias, (entry->lut_mode == LUT_LINEAR) ? " linear" : ""); }
+	}
+	bundleClose(&bundle);
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	printf("Aias Karioris, 2025\n");
+	printf("Bundle Tool\n\n");
+
+	if(argc == 3 && strcmp(argv[1], "-l") == 0) { return listBundle(argv[2]); }
+	if(argc < 3) {
+		printf("Usage: %s [output] [name=matrix.csv:HxW | name=table.lut]...\n", argv[0]);
+		printf("       %s -l [bundle]\n\n", argv[0]);
+		return 1;
+	}
+
+	size_t count = argc - 2;
+	bundle_item_t *items = (bundle_item_t*)calloc(count, sizeof(bundle_item_t));
+	matrix32f_t *mats = (matrix32f_t*)calloc(count, sizeof(matrix32f_t));
+	lut32f_t *luts = (lut32f_t*)calloc(count, sizeof(lut32f_t));
+	if(items == NULL || mats == NULL || luts == NULL) {
+		printf("Error: could not allocate memory.\n");
+		return 3;
+	}
+
+	int ret = 0;
+	int test;
+	for(size_t i = 0; i < count; i++) {
+		// name=path[:HxW]; the argument is split in place
+		char *arg = argv[i+2];
+		char *path = strchr(arg, '=');
+		if(path == NULL) {
+			printf("Error: invalid entry %s (expected name=path).\n", arg);
+			ret = 1; goto exit;
+		}
+		*path++ = '\0';
+		items[i].name = arg;
+
+		char *dims = strrchr(path, ':');
+		unsigned long h, w;
+		if(dims != NULL) {
+			*dims++ = '\0';
+			if(sscanf(dims, "%lux%lu", &h, &w) != 2) {
+				printf("Error: invalid dimensions for %s (expected HxW).\n", arg);
+				ret = 1; goto exit;
+			}
+			printf("Loading %s (%s, %lux%lu)...", arg, path, h, w);
+			if(test = matrixFromCSV(path, h, w, &mats[i])) {
+				printf("\nError (%d): failed to import %s!\n", test, path);
+				ret = 4; goto exit;
+			}
+			items[i].mat = &mats[i];
+		}
+		else {
+			printf("Loading %s (%s)...", arg, path);
+			if(test = load32fLUT(&luts[i], path)) {
+				printf("\nError (%d): failed to load %s!\n", test, path);
+				ret = 4; goto exit;
+			}
+			items[i].lut = &luts[i];
+		}
+		printf("OK\n");
+	}
+
+	printf("Writing %s...", argv[1]);
+	if(test = bundleWrite(argv[1], items, count)) {
+		printf("\nError (%d): failed to write %s!\n", test, argv[1]);
+		ret = 5; goto exit;
+	}
+	printf("OK\n\n");
+	ret = listBundle(argv[1]);
+
+exit:
+	for(size_t i = 0; i < count; i++) {
+		deleteMatrix(&mats[i]);
+		deleteLUT32f(&luts[i]);
+	}
+	free(items);
+	free(mats);
+	free(luts);
+	return ret;
+}
@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "lut.h"
+
+// Generates LUT files with `lutGenerate`.
+//   lut_tool [function] [min] [max] [length] [nearest|linear] [output]
+//   lut_tool -d [directory]
+// e.g. `lut_tool tanh -8 8 2049 linear lut/tanh2049l.lut`. With -d, the tables the tests load are written to
+// `directory` (usually lut/), so the repository needs no prebuilt binaries.
+
+typedef struct LUT_FUNCTION_ST {
+	const char *name;
+	float32_t (*fn)(float32_t);
+} lut_function_t;
+
+static const lut_function_t functions[] = {
+	{ "sigmoid", lutSigmoid }, { "tanh", tanhf }, { "sqrt", sqrtf }, { "atan", atanf }, { "sin", sinf }, { "cos", cosf }
+};
+#define FUNCTIONS	6
+
+// Tables used by the tests; tanh/sigmoid cover the range where they aren't saturated, atan the ratios `angleLUT_c`
+// sees, sin/cos the output range of atan (`expiLUT`) and sqrt the magnitudes of the spectrograms
+typedef struct LUT_FILE_ST {
+	const char *file;
+	const char *function;
+	float32_t min, max;
+	uint32_t length;
+} lut_file_t;
+
+static const lut_file_t test_files[] = {
+	{ "sigmoid.lut",      "sigmoid", -8, 8, 4097 },		{ "sigmoid65537.lut", "sigmoid", -8, 8, 65537 },
+	{ "tanh.lut",         "tanh",    -8, 8, 4097 },		{ "tanh65537.lut",    "tanh",    -8, 8, 65537 },
+	{ "tanh257.lut",      "tanh",    -8, 8, 257 },
+	{ "atan.lut",         "atan",    -64, 64, 4097 },	{ "atan65537.lut",    "atan",    -64, 64, 65537 },
+	{ "sin.lut",          "sin",     -1.57079633f, 1.57079633f, 4097 },
+	{ "sin256.lut",       "sin",     -1.57079633f, 1.57079633f, 256 },
+	{ "cos.lut",          "cos",     -1.57079633f, 1.57079633f, 4097 },
+	{ "cos256.lut",       "cos",     -1.57079633f, 1.57079633f, 256 },
+	{ "sqrt.lut",         "sqrt",    0, 200e3, 4097 },	{ "sqrt256.lut",      "sqrt",    0, 200e3, 256 },
+	{ "sqrt65536.lut",    "sqrt",    0, 200e3, 65536 },	{ "sqrt24bits.lut",   "sqrt",    0, 16777215, 16777216 }
+};
+#define TEST_FILES	15
+
+static const lut_function_t* findFunction(const char *name) {
+	for(uint8_t f = 0; f < FUNCTIONS; f++) {
+		if(strcmp(functions[f].name, name) == 0) { return &functions[f]; }
+	}
+	return NULL;
+}
+
+static int writeLUT(const char *function, float32_t min, float32_t max, uint32_t length, uint8_t mode, const char *path) {
+	const lut_function_t *fn = findFunction(function);
+	if(fn == NULL) {
+		printf("Error: unknown function %s.\n", function);
+		return 1;
+	}
+
+	lut32f_t lut;
+	int test;
+	printf("Writing %s (%s, [%g, %g], %u entries%s)...", path, function, min, max, length, (mode == LUT_LINEAR) ? ", linear" : "");
+	if(test = lutGenerate(&lut, fn->fn, min, max, length, mode)) {
+		printf("\nError (%d): could not generate the LUT.\n", test);
+		return 2;
+	}
+	if(test = save32fLUT(&lut, path)) {
+		printf("\nError (%d): could not write %s.\n", test, path);
+		deleteLUT32f(&lut);
+		return 3;
+	}
+	printf("OK!\n");
+	deleteLUT32f(&lut);
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	printf("Aias Karioris, 2025\n");
+	printf("LUT Tool\n\n");
+
+	if(argc == 3 && strcmp(argv[1], "-d") == 0) {
+		char path[512];
+		for(uint8_t i = 0; i < TEST_FILES; i++) {
+			snprintf(path, sizeof(path), "%s/%s", argv[2], test_files[i].file);
+			if(writeLUT(test_files[i].function, test_files[i].min, test_files[i].max, test_files[i].length, LUT_NEAREST, path)) { return 2; }
+		}
+		return 0;
+	}
+	if(argc != 7 || (strcmp(argv[5], "nearest") && strcmp(argv[5], "linear"))) {
+		printf("Usage: %s [function] [min] [max] [length] [nearest|linear] [output]\n", argv[0]);
+		printf("       %s -d [directory]\n", argv[0]);
+		printf("Functions can be: ");
+		for(uint8_t f = 0; f < FUNCTIONS; f++) { printf("%s ", functions[f].name); }
+		printf("\n\n");
+		return 1;
+	}
+
+	uint8_t mode = (strcmp(argv[5], "linear") == 0) ? LUT_LINEAR : LUT_NEAREST;
+	return writeLUT(argv[1], atof(argv[2]), atof(argv[3]), atoi(argv[4]), mode, argv[6]) ? 2 : 0;
+}